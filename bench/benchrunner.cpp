@@ -0,0 +1,76 @@
+#include "benchrunner.h"
+#include "histogram.h"
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QIODevice>
+#include <QJsonDocument>
+
+BenchRunner::BenchRunner(const BenchOptions &options, QIODevice *output)
+    : m_options(options), m_output(output)
+{
+}
+
+void BenchRunner::add(const QString &name, BenchFn fn)
+{
+    m_cases.append({name, std::move(fn)});
+}
+
+void BenchRunner::writeRecord(const QJsonObject &record)
+{
+    m_output->write(QJsonDocument(record).toJson(QJsonDocument::Compact));
+    m_output->write("\n");
+}
+
+int BenchRunner::runAll()
+{
+    int executed = 0;
+    for (const Case &benchCase : m_cases) {
+        if (!m_options.filter.pattern().isEmpty() && !m_options.filter.match(benchCase.name).hasMatch()) {
+            continue;
+        }
+        runCase(benchCase);
+        ++executed;
+    }
+    return executed;
+}
+
+void BenchRunner::runCase(const Case &benchCase)
+{
+    qInfo().noquote() << "bench:" << benchCase.name;
+
+    for (int i = 0; i < m_options.warmupIterations; ++i) {
+        benchCase.fn(-1 - i);
+    }
+
+    HdrHistogram latencyUs;
+    QElapsedTimer total;
+    QElapsedTimer single;
+    total.start();
+    int iteration = 0;
+    while (iteration < m_options.iterations || total.elapsed() < m_options.minTimeMs) {
+        single.start();
+        benchCase.fn(iteration);
+        latencyUs.record(single.nsecsElapsed() / 1000);
+        ++iteration;
+    }
+    const qint64 totalNs = total.nsecsElapsed();
+
+    const HistogramSummary summary = latencyUs.summary();
+    QJsonObject latency;
+    latency["min"] = summary.min;
+    latency["mean"] = summary.mean;
+    latency["p50"] = summary.p50;
+    latency["p95"] = summary.p95;
+    latency["p99"] = summary.p99;
+    latency["max"] = summary.max;
+
+    QJsonObject record = m_options.runInfo;
+    record["type"] = "benchmark";
+    record["name"] = benchCase.name;
+    record["warmup"] = m_options.warmupIterations;
+    record["iterations"] = iteration;
+    record["totalMs"] = totalNs / 1e6;
+    record["opsPerSec"] = totalNs > 0 ? iteration * 1e9 / totalNs : 0.0;
+    record["latencyUs"] = latency;
+    writeRecord(record);
+}
@@ -0,0 +1,50 @@
+#ifndef BENCHRUNNER_H
+#define BENCHRUNNER_H
+
+#include <QJsonObject>
+#include <QList>
+#include <QRegularExpression>
+#include <QString>
+#include <functional>
+
+class QIODevice;
+
+struct BenchOptions {
+    int warmupIterations = 20;
+    int iterations = 200;
+    int minTimeMs = 0;              // Повторювати, доки не мине щонайменше стільки часу
+    QRegularExpression filter;      // Порожній - усі сценарії
+    QJsonObject runInfo;            // Додається до кожного запису (масштаб, seed, ...)
+};
+
+// Виконує зареєстровані сценарії з прогрівом і повтореннями та пише по одному
+// JSON-рядку на сценарій: пропускна здатність і перцентилі затримки в мікросекундах.
+class BenchRunner
+{
+public:
+    // iteration - номер виклику від 0 (прогрів має власну нумерацію),
+    // за ним сценарій вибирає параметри детерміновано
+    using BenchFn = std::function<void(int iteration)>;
+
+    BenchRunner(const BenchOptions &options, QIODevice *output);
+
+    void add(const QString &name, BenchFn fn);
+    void writeRecord(const QJsonObject &record);
+
+    // Повертає кількість виконаних сценаріїв
+    int runAll();
+
+private:
+    struct Case {
+        QString name;
+        BenchFn fn;
+    };
+
+    void runCase(const Case &benchCase);
+
+    BenchOptions m_options;
+    QIODevice *m_output = nullptr;
+    QList<Case> m_cases;
+};
+
+#endif // BENCHRUNNER_H
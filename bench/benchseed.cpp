@@ -0,0 +1,81 @@
+#include "benchseed.h"
+#include "database.h"
+#include <QDebug>
+
+BenchScale BenchScale::fromLabel(const QString &label, bool *ok)
+{
+    const QString normalized = label.trimmed().toLower();
+    bool parsed = true;
+    int books = 0;
+    if (normalized.endsWith('k')) {
+        books = normalized.chopped(1).toInt(&parsed) * 1000;
+    } else if (normalized.endsWith('m')) {
+        books = normalized.chopped(1).toInt(&parsed) * 1000000;
+    } else {
+        books = normalized.toInt(&parsed);
+    }
+    parsed = parsed && books > 0;
+    if (ok) *ok = parsed;
+
+    const DataGeneratorConfig config = DataGeneratorConfig::forBooks(parsed ? books : 1000);
+    BenchScale scale;
+    scale.label = normalized;
+    scale.books = config.books;
+    scale.publishers = config.publishers;
+    scale.authors = config.authors;
+    scale.customers = config.customers;
+    scale.orders = config.orders;
+    scale.comments = config.comments;
+    return scale;
+}
+
+DataGeneratorConfig BenchScale::generatorConfig(quint64 seed, int connections) const
+{
+    DataGeneratorConfig config = DataGeneratorConfig::forBooks(books);
+    config.publishers = publishers;
+    config.authors = authors;
+    config.customers = customers;
+    config.orders = orders;
+    config.comments = comments;
+    config.seed = seed;
+    config.connections = connections;
+    config.customerPassword = BenchData::customerPassword();
+    return config;
+}
+
+namespace BenchData {
+
+QStringList genres()
+{
+    return syntheticGenres();
+}
+
+QStringList languages()
+{
+    return syntheticLanguages();
+}
+
+QString customerEmail(int customerId)
+{
+    return syntheticCustomerEmail(customerId);
+}
+
+QString customerPassword()
+{
+    return "bench";
+}
+
+} // namespace BenchData
+
+bool seedBenchDatabase(DatabaseManager &dbManager, const BenchScale &scale, quint64 seed, int connections)
+{
+    DataGeneratorReport report;
+    if (!generateSyntheticData(&dbManager, scale.generatorConfig(seed, connections), &report)) {
+        qCritical() << "seed: не вдалося заповнити базу для масштабу" << scale.label;
+        return false;
+    }
+    qInfo().noquote() << QString("seed: масштаб %1 (%2 книг): %3 рядків за %4 мс (%5)")
+                         .arg(scale.label).arg(scale.books).arg(report.rows).arg(report.elapsedMs)
+                         .arg(report.usedCopy ? "COPY" : "INSERT");
+    return true;
+}
@@ -0,0 +1,36 @@
+#ifndef BENCHSEED_H
+#define BENCHSEED_H
+
+#include <QString>
+#include <QStringList>
+#include "datagenerator.h"
+
+class DatabaseManager;
+
+// Обсяги даних для одного масштабу; решта таблиць виводиться з кількості книг
+struct BenchScale {
+    QString label;          // "1k", "100k", "1m" або число
+    int books = 1000;
+    int publishers = 0;
+    int authors = 0;
+    int customers = 0;
+    int orders = 0;
+    int comments = 0;
+
+    static BenchScale fromLabel(const QString &label, bool *ok = nullptr);
+    DataGeneratorConfig generatorConfig(quint64 seed, int connections) const;
+};
+
+// Значення, з яких генеруються дані (сценарії беруть параметри звідси ж)
+namespace BenchData {
+QStringList genres();
+QStringList languages();
+QString customerEmail(int customerId);
+QString customerPassword();
+}
+
+// Перестворює схему і заповнює її генератором (utils/datagenerator: COPY, кілька з'єднань).
+// Дані детерміновані для однакових scale і seed.
+bool seedBenchDatabase(DatabaseManager &dbManager, const BenchScale &scale, quint64 seed, int connections);
+
+#endif // BENCHSEED_H
@@ -0,0 +1,75 @@
+#include "localpostgres.h"
+#include <QDebug>
+#include <QDir>
+#include <QProcess>
+
+LocalPostgres::LocalPostgres(const QString &binDir)
+    : m_binDir(binDir)
+{
+}
+
+LocalPostgres::~LocalPostgres()
+{
+    stop();
+}
+
+QString LocalPostgres::tool(const QString &name) const
+{
+    return m_binDir.isEmpty() ? name : QDir(m_binDir).filePath(name);
+}
+
+QString LocalPostgres::host() const
+{
+    return m_dir.path();
+}
+
+bool LocalPostgres::run(const QString &program, const QStringList &arguments, int timeoutMs)
+{
+    QProcess process;
+    process.setProcessChannelMode(QProcess::MergedChannels);
+    process.start(program, arguments);
+    if (!process.waitForStarted()) {
+        qCritical() << "LocalPostgres: не вдалося запустити" << program << ":" << process.errorString();
+        return false;
+    }
+    if (!process.waitForFinished(timeoutMs) || process.exitStatus() != QProcess::NormalExit || process.exitCode() != 0) {
+        qCritical().noquote() << "LocalPostgres:" << program << "завершився з помилкою:\n" << process.readAll();
+        return false;
+    }
+    return true;
+}
+
+bool LocalPostgres::start(int port)
+{
+    if (m_running) {
+        return true;
+    }
+    if (!m_dir.isValid()) {
+        qCritical() << "LocalPostgres: не вдалося створити тимчасовий каталог.";
+        return false;
+    }
+    m_port = port;
+
+    const QString dataDir = QDir(m_dir.path()).filePath("data");
+    if (!run(tool("initdb"), {"-D", dataDir, "-U", user(), "-A", "trust", "-E", "UTF8", "--no-sync"}, 120000)) {
+        return false;
+    }
+
+    // Лише Unix-сокет у тимчасовому каталозі: не конфліктує з локальним сервером на тому ж порту
+    const QString serverOptions = QString("-p %1 -k %2 -c listen_addresses='' -c fsync=off").arg(port).arg(m_dir.path());
+    if (!run(tool("pg_ctl"), {"-D", dataDir, "-o", serverOptions, "-l", QDir(m_dir.path()).filePath("server.log"), "-w", "start"}, 60000)) {
+        return false;
+    }
+    m_running = true;
+    qInfo() << "LocalPostgres: сервер запущено, сокет у" << m_dir.path() << "порт" << port;
+    return true;
+}
+
+void LocalPostgres::stop()
+{
+    if (!m_running) {
+        return;
+    }
+    run(tool("pg_ctl"), {"-D", QDir(m_dir.path()).filePath("data"), "-m", "fast", "-w", "stop"}, 60000);
+    m_running = false;
+}
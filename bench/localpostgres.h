@@ -0,0 +1,34 @@
+#ifndef LOCALPOSTGRES_H
+#define LOCALPOSTGRES_H
+
+#include <QString>
+#include <QTemporaryDir>
+
+// Тимчасовий кластер PostgreSQL для бенчмарків: initdb у тимчасовий каталог, запуск через
+// pg_ctl на Unix-сокеті без TCP. Кластер зупиняється і видаляється в деструкторі.
+class LocalPostgres
+{
+public:
+    explicit LocalPostgres(const QString &binDir = QString());
+    ~LocalPostgres();
+
+    bool start(int port);
+    void stop();
+
+    // Параметри для DatabaseManager::connectToDatabase (host - каталог сокета)
+    QString host() const;
+    int port() const { return m_port; }
+    QString user() const { return "bench"; }
+    QString databaseName() const { return "postgres"; }
+
+private:
+    QString tool(const QString &name) const;
+    bool run(const QString &program, const QStringList &arguments, int timeoutMs);
+
+    QString m_binDir;
+    QTemporaryDir m_dir;
+    int m_port = 0;
+    bool m_running = false;
+};
+
+#endif // LOCALPOSTGRES_H
@@ -0,0 +1,507 @@
+// bookstore_bench: мікробенчмарки публічних методів DatabaseManager на синтетичних даних.
+// Кожен сценарій виводиться одним JSON-рядком (stdout або --output), наприкінці - статистика
+// іменованих запитів (QueryStatsRegistry). Методи, що перестворюють схему або лише друкують
+// дані (createSchemaTables, printAllData), не вимірюються.
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QDebug>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QSqlQuery>
+#include <QThread>
+#include <functional>
+#include <memory>
+#include "benchrunner.h"
+#include "benchseed.h"
+#include "localpostgres.h"
+#include "database.h"
+#include "logging.h"
+#include "suggestionindex.h"
+#include "bookfiltermanager.h"
+#include "pgarray.h"
+
+namespace {
+
+// Детермінований вибір параметра для ітерації, незалежний від порядку і фільтра сценаріїв
+quint64 mix(quint64 value)
+{
+    value += 0x9E3779B97F4A7C15ULL;
+    value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    value = (value ^ (value >> 27)) * 0x94D049BB133111EBULL;
+    return value ^ (value >> 31);
+}
+
+class ParamPicker
+{
+public:
+    explicit ParamPicker(quint64 seed) : m_seed(seed) {}
+
+    // Значення з [1, range]
+    int id(int iteration, quint64 salt, int range) const
+    {
+        const quint64 bits = mix(m_seed ^ mix(salt) ^ static_cast<quint64>(static_cast<qint64>(iteration)));
+        return 1 + static_cast<int>(bits % static_cast<quint64>(qMax(1, range)));
+    }
+
+    QString item(int iteration, quint64 salt, const QStringList &values) const
+    {
+        return values.at(id(iteration, salt, values.size()) - 1);
+    }
+
+private:
+    quint64 m_seed;
+};
+
+QString serverVersion(QSqlDatabase &db)
+{
+    QSqlQuery query(db);
+    if (query.exec("SHOW server_version") && query.next()) {
+        return query.value(0).toString();
+    }
+    return QString();
+}
+
+void registerCases(BenchRunner &runner, DatabaseManager &db, const BenchScale &scale, const ParamPicker &pick)
+{
+    // Сценарії виконуються після повернення з цієї функції, тож спільні дані - статичні
+    static const QStringList genres = BenchData::genres();
+    static const QStringList languages = BenchData::languages();
+    const int pageSize = 50;
+
+    // --- Читання ---
+    runner.add("getAllBooksForDisplay/offset", [&, pageSize](int i) {
+        db.getAllBooksForDisplay(pageSize, pick.id(i, 1, qMax(1, scale.books - pageSize)) - 1);
+    });
+    runner.add("getTotalBookCount", [&](int) { db.getTotalBookCount(); });
+    runner.add("getBooksByGenre", [&](int i) { db.getBooksByGenre(pick.item(i, 2, genres), 10); });
+    runner.add("getAllAuthorsForDisplay", [&](int) { db.getAllAuthorsForDisplay(); });
+    runner.add("getCustomerLoginInfo", [&](int i) {
+        db.getCustomerLoginInfo(BenchData::customerEmail(pick.id(i, 3, scale.customers)));
+    });
+    runner.add("getCustomerProfileInfo", [&](int i) { db.getCustomerProfileInfo(pick.id(i, 4, scale.customers)); });
+    runner.add("getCustomerOrdersForDisplay", [&](int i) { db.getCustomerOrdersForDisplay(pick.id(i, 5, scale.customers)); });
+    runner.add("getSearchSuggestions", [&](int i) {
+        db.getSearchSuggestions(QString("Книга %1").arg(pick.id(i, 6, 99)), 10);
+    });
+    runner.add("getSearchSuggestions/fuzzy", [&](int i) {
+        // Пропущена літера: префікс нічого не знаходить, спрацьовує запасний запит pg_trgm
+        QString typo = pick.item(i, 38, genres);
+        typo.remove(typo.size() / 2, 1);
+        db.getSearchSuggestions(typo, 10);
+    });
+    // Індекс - свій для кожного масштабу, будується під час прогріву;
+    // однолітерний префікс - найширший діапазон ключів
+    auto suggestionIndex = std::make_shared<std::unique_ptr<SuggestionIndex>>();
+    runner.add("SuggestionIndex/lookup", [&, suggestionIndex](int i) {
+        if (!*suggestionIndex) {
+            *suggestionIndex = std::make_unique<SuggestionIndex>();
+            (*suggestionIndex)->build(db.getSuggestionSource());
+        }
+        (*suggestionIndex)->lookup(QString(QChar(0x0430 + pick.id(i, 39, 32) - 1)), 10);
+    });
+    runner.add("searchBooks", [&](int i) { db.searchBooks(pick.item(i, 37, genres), 20); });
+    runner.add("getBookDetails", [&](int i) { db.getBookDetails(pick.id(i, 7, scale.books)); });
+    runner.add("getBookComments", [&](int i) { db.getBookComments(pick.id(i, 8, scale.books)); });
+    runner.add("getBookDisplayInfoById", [&](int i) { db.getBookDisplayInfoById(pick.id(i, 9, scale.books)); });
+    runner.add("getBookDisplayInfoByIds/20", [&](int i) {
+        QList<int> ids;
+        for (int k = 0; k < 20; ++k) ids.append(pick.id(i * 20 + k, 10, scale.books));
+        db.getBookDisplayInfoByIds(ids);
+    });
+    runner.add("hasUserCommentedOnBook", [&](int i) {
+        db.hasUserCommentedOnBook(pick.id(i, 11, scale.books), pick.id(i, 12, scale.customers));
+    });
+    runner.add("getOrderDetailsById", [&](int i) { db.getOrderDetailsById(pick.id(i, 13, scale.orders)); });
+    runner.add("getAuthorDetails", [&](int i) { db.getAuthorDetails(pick.id(i, 14, scale.authors)); });
+    runner.add("getSimilarBooks", [&](int i) {
+        db.getSimilarBooks(pick.id(i, 15, scale.books), pick.item(i, 16, genres), 5);
+    });
+    runner.add("getFilteredBooksForDisplay/genre+price", [&](int i) {
+        BookFilterCriteria criteria;
+        criteria.genres = QStringList{pick.item(i, 17, genres)};
+        criteria.minPrice = 100.0;
+        criteria.maxPrice = 300.0;
+        criteria.inStockOnly = true;
+        db.getFilteredBooksForDisplay(criteria);
+    });
+    // Знімок для сценаріїв BookFilterManager - свій для кожного масштабу, будується під час
+    // прогріву першого з них
+    auto filterManagerSlot = std::make_shared<std::unique_ptr<BookFilterManager>>();
+    auto filterManager = [&db, filterManagerSlot]() -> BookFilterManager & {
+        if (!*filterManagerSlot) {
+            *filterManagerSlot = std::make_unique<BookFilterManager>(&db);
+            (*filterManagerSlot)->setSource(db.getBookFilterSource());
+        }
+        return **filterManagerSlot;
+    };
+    runner.add("BookFilterManager/filter/genre+price", [&, filterManager](int i) {
+        // Той самий фільтр, що й getFilteredBooksForDisplay/genre+price, але над знімком у пам'яті
+        BookFilterCriteria criteria;
+        criteria.genres = QStringList{pick.item(i, 40, genres)};
+        criteria.minPrice = 100.0;
+        criteria.maxPrice = 300.0;
+        criteria.inStockOnly = true;
+        filterManager().filter(criteria);
+    });
+    runner.add("getBookFacetCounts/genre+price", [&](int i) {
+        BookFilterCriteria criteria;
+        criteria.genres = QStringList{pick.item(i, 41, genres)};
+        criteria.minPrice = 100.0;
+        criteria.maxPrice = 300.0;
+        db.getBookFacetCounts(criteria);
+    });
+    runner.add("BookFilterManager/facets/genre+price", [&, filterManager](int i) {
+        BookFilterCriteria criteria;
+        criteria.genres = QStringList{pick.item(i, 42, genres)};
+        criteria.minPrice = 100.0;
+        criteria.maxPrice = 300.0;
+        filterManager().facets(criteria);
+    });
+    runner.add("getFilteredBooksForDisplay/language", [&](int i) {
+        BookFilterCriteria criteria;
+        criteria.languages = QStringList{pick.item(i, 18, languages)};
+        db.getFilteredBooksForDisplay(criteria);
+    });
+    runner.add("getFilteredBooksPage/first", [&, pageSize](int i) {
+        BookFilterCriteria criteria;
+        criteria.genres = QStringList{pick.item(i, 19, genres)};
+        db.getFilteredBooksPage(criteria, BookSortOrder::Price, pageSize);
+    });
+    runner.add("getAllBooksPage/title/5pages", [&, pageSize](int) {
+        QString token;
+        for (int page = 0; page < 5; ++page) {
+            const BookPage result = db.getAllBooksPage(BookSortOrder::Title, pageSize, token);
+            if (!result.hasMore) break;
+            token = result.nextPageToken;
+        }
+    });
+    runner.add("getAllGenres", [&](int) { db.getAllGenres(); });
+    runner.add("getAllLanguages", [&](int) { db.getAllLanguages(); });
+    runner.add("getCartItems", [&](int i) { db.getCartItems(pick.id(i, 20, scale.customers)); });
+
+    // --- Асинхронні варіанти та пакетний завантажувач ---
+    runner.add("getFilteredBooksPageAsync/first", [&, pageSize](int i) {
+        BookFilterCriteria criteria;
+        criteria.genres = QStringList{pick.item(i, 21, genres)};
+        db.getFilteredBooksPageAsync(criteria, BookSortOrder::Newest, pageSize).waitForFinished();
+    });
+    runner.add("getBookDisplayInfoByIdsAsync/20", [&](int i) {
+        QList<int> ids;
+        for (int k = 0; k < 20; ++k) ids.append(pick.id(i * 20 + k, 22, scale.books));
+        db.getBookDisplayInfoByIdsAsync(ids).waitForFinished();
+    });
+    runner.add("loadBookDisplayInfos/20", [&](int i) {
+        QList<int> ids;
+        for (int k = 0; k < 20; ++k) ids.append(pick.id(i * 20 + k, 23, scale.books));
+        QFuture<QMap<int, BookDisplayInfo>> future = db.loadBookDisplayInfos(ids);
+        // Завантажувач відправляє пакет із циклу подій цього потоку
+        while (!future.isFinished()) {
+            QCoreApplication::processEvents(QEventLoop::AllEvents, 1);
+        }
+    });
+    // Заповнений пул: завдань удвічі більше, ніж з'єднань, і всі робочі потоки вже тримають
+    // своє з'єднання (зокрема після заповнення даних). Кожне завдання має отримати з'єднання
+    // одразу, а не чекати acquireTimeoutMs
+    runner.add("runAsync/poolSaturated", [&](int i) {
+        const int poolSize = db.connectionPool() ? db.connectionPool()->config().maxSize : 1;
+        QList<QFuture<bool>> futures;
+        for (int k = 0; k < poolSize * 2; ++k) {
+            const int bookId = pick.id(i * 64 + k, 49, scale.books);
+            futures.append(db.runAsync([&db, bookId]() {
+                if (!db.workerConnection().isOpen()) {
+                    return false;
+                }
+                db.getBookDisplayInfoById(bookId);
+                return true;
+            }));
+        }
+        for (QFuture<bool> &future : futures) {
+            if (!future.result()) {
+                qCritical() << "runAsync/poolSaturated: завдання не отримало з'єднання пулу.";
+            }
+        }
+    });
+
+    // --- Запис ---
+    runner.add("addOrUpdateCartItem", [&](int i) {
+        db.addOrUpdateCartItem(pick.id(i, 24, scale.customers), pick.id(i, 25, scale.books), 1 + (i & 3));
+    });
+    // Ті самі параметри, що й у addOrUpdateCartItem: видаляються щойно додані позиції
+    runner.add("removeCartItem", [&](int i) {
+        db.removeCartItem(pick.id(i, 24, scale.customers), pick.id(i, 25, scale.books));
+    });
+    runner.add("clearCart", [&](int i) { db.clearCart(pick.id(i, 26, scale.customers)); });
+    runner.add("createOrder", [&](int i) {
+        QMap<int, int> items;
+        const int itemCount = 1 + pick.id(i, 27, 3);
+        for (int k = 0; k < itemCount; ++k) {
+            items.insert(pick.id(i * 4 + k, 28, scale.books), 1);
+        }
+        int newOrderId = -1;
+        db.createOrder(pick.id(i, 29, scale.customers), items, "м. Київ, вул. Бенчмаркова, 1", "Карткою онлайн", newOrderId);
+    });
+    runner.add("addComment", [&](int i) {
+        db.addComment(pick.id(i, 30, scale.books), pick.id(i, 31, scale.customers), "Відгук з бенчмарку", 1 + (i % 5));
+    });
+    const QString runTag = QString::number(QDateTime::currentMSecsSinceEpoch(), 36);
+    runner.add("registerCustomer", [&, runTag](int i) {
+        CustomerRegistrationInfo info;
+        info.firstName = "Бенч";
+        info.lastName = "Клієнт";
+        info.email = QString("bench.%1.%2@bench.local").arg(runTag).arg(i);
+        info.password = BenchData::customerPassword();
+        int newCustomerId = -1;
+        db.registerCustomer(info, newCustomerId);
+    });
+    runner.add("updateCustomerPhone", [&](int i) {
+        db.updateCustomerPhone(pick.id(i, 32, scale.customers), QString("+380%1").arg(pick.id(i, 33, 999999999), 9, 10, QChar('0')));
+    });
+    runner.add("updateCustomerName", [&](int i) { db.updateCustomerName(pick.id(i, 34, scale.customers), "Клієнт", "Оновлений"); });
+    runner.add("updateCustomerAddress", [&](int i) {
+        db.updateCustomerAddress(pick.id(i, 35, scale.customers), QString("м. Львів, вул. Нова, %1").arg(i));
+    });
+    runner.add("addLoyaltyPoints", [&](int i) { db.addLoyaltyPoints(pick.id(i, 36, scale.customers), 1); });
+}
+
+// Сканує дерево плану EXPLAIN (FORMAT JSON) і збирає таблиці, прочитані послідовно
+void collectSeqScans(const QJsonObject &plan, QStringList &relations)
+{
+    if (plan.value("Node Type").toString() == "Seq Scan") {
+        relations.append(plan.value("Relation Name").toString());
+    }
+    for (const QJsonValue &child : plan.value("Plans").toArray()) {
+        collectSeqScans(child.toObject(), relations);
+    }
+}
+
+// Запити, що виконуються на кожну дію користувача (зокрема на кожне натискання клавіші в
+// пошуку і кожну сторінку прокрутки): на масштабі 1m жоден не має читати таблицю послідовно.
+// Повні вибірки каталогу (джерела фільтрів, підказок, фасети) і випадкова вибірка схожих
+// книг (GetSimilarBooksByGenre) сюди свідомо не входять.
+bool runExplainCheck(DatabaseManager &db, const BenchScale &scale, const ParamPicker &pick, BenchRunner &runner)
+{
+    const QStringList genres = BenchData::genres();
+    const int bookId = pick.id(0, 43, scale.books);
+    const int authorId = pick.id(0, 44, scale.authors);
+    const int customerId = pick.id(0, 45, scale.customers);
+    const int orderId = pick.id(0, 46, scale.orders);
+    QList<int> bookIds;
+    for (int k = 0; k < 20; ++k) {
+        bookIds.append(pick.id(k, 47, scale.books));
+    }
+    const QString genre = pick.item(0, 48, genres);
+    QString typo = genre;
+    typo.remove(typo.size() / 2, 1);
+
+    struct ExplainCase
+    {
+        QString name;
+        std::function<QJsonArray()> explain;
+    };
+    auto named = [&db](SqlQueryId id, const QVariantList &params) {
+        return [&db, id, params]() { return db.explainQuery(id, params); };
+    };
+    QList<ExplainCase> cases = {
+        {"GetAllBooksForDisplay", named(SqlQueryId::GetAllBooksForDisplay, {50, 0})},
+        {"GetBooksByGenre", named(SqlQueryId::GetBooksByGenre, {genre, 10})},
+        {"GetBookDetailsById", named(SqlQueryId::GetBookDetailsById, {bookId})},
+        {"GetBookDisplayInfoById", named(SqlQueryId::GetBookDisplayInfoById, {bookId})},
+        {"GetBookDisplayInfoByIds", named(SqlQueryId::GetBookDisplayInfoByIds, {toPgIntArray(bookIds)})},
+        {"GetBookCommentsByBookId", named(SqlQueryId::GetBookCommentsByBookId, {bookId})},
+        {"CheckUserCommentExists", named(SqlQueryId::CheckUserCommentExists, {bookId, customerId})},
+        {"GetAuthorDetailsById", named(SqlQueryId::GetAuthorDetailsById, {authorId})},
+        {"GetAuthorBooksForDisplay", named(SqlQueryId::GetAuthorBooksForDisplay, {authorId})},
+        {"GetCustomerLoginInfoByEmail", named(SqlQueryId::GetCustomerLoginInfoByEmail, {BenchData::customerEmail(customerId)})},
+        {"GetCustomerProfileInfoById", named(SqlQueryId::GetCustomerProfileInfoById, {customerId})},
+        {"GetCartItemsByCustomerId", named(SqlQueryId::GetCartItemsByCustomerId, {customerId})},
+        {"GetCustomerOrderHeadersByCustomerId", named(SqlQueryId::GetCustomerOrderHeadersByCustomerId, {customerId})},
+        {"GetOrderHeaderById", named(SqlQueryId::GetOrderHeaderById, {orderId})},
+        {"GetOrderItemsByOrderId", named(SqlQueryId::GetOrderItemsByOrderId, {orderId})},
+        {"GetOrderStatusesByOrderId", named(SqlQueryId::GetOrderStatusesByOrderId, {orderId})},
+        // Пошук: префікс (кожне натискання), запасний нечіткий пошук і повнотекстовий
+        {"GetSearchSuggestions", named(SqlQueryId::GetSearchSuggestions, {QString("Книга %1").arg(pick.id(0, 6, 99)), 10})},
+        {"GetFuzzySearchSuggestions", [&db, typo]() { return db.explainSqlFunction("search_suggestions_fuzzy", {typo, 10}); }},
+        {"SearchBooks", named(SqlQueryId::SearchBooks, {genre, 20, 0})},
+    };
+
+    // GetBooksPage: перша сторінка і keyset-продовження для кожного порядку сортування
+    // (вирази ключів - ті самі, що в idx_book_title_id, idx_book_price_key_id, idx_book_newest_id)
+    const QList<QPair<QString, BookSortOrder>> sortOrders = {
+        {"title", BookSortOrder::Title}, {"price", BookSortOrder::Price}, {"newest", BookSortOrder::Newest}};
+    for (const auto &sortOrder : sortOrders) {
+        const BookSortOrder order = sortOrder.second;
+        const QString nextPageToken = db.getAllBooksPage(order, 50).nextPageToken;
+        cases.append({"GetBooksPage/" + sortOrder.first + "/first",
+                      [&db, order]() { return db.explainBooksPage(BookFilterCriteria(), order, 50); }});
+        cases.append({"GetBooksPage/" + sortOrder.first + "/seek",
+                      [&db, order, nextPageToken]() { return db.explainBooksPage(BookFilterCriteria(), order, 50, nextPageToken); }});
+    }
+    BookFilterCriteria genreCriteria;
+    genreCriteria.genres = QStringList{genre};
+    cases.append({"GetBooksPage/newest/genre",
+                  [&db, genreCriteria]() { return db.explainBooksPage(genreCriteria, BookSortOrder::Newest, 50); }});
+
+    bool allOk = true;
+    for (const ExplainCase &explainCase : cases) {
+        const QJsonArray plan = explainCase.explain();
+        QStringList seqScans;
+        if (!plan.isEmpty()) {
+            collectSeqScans(plan.at(0).toObject().value("Plan").toObject(), seqScans);
+        }
+        const bool ok = !plan.isEmpty() && seqScans.isEmpty();
+        if (!ok) {
+            qCritical() << "EXPLAIN" << explainCase.name << (plan.isEmpty() ? "не виконано" : "- послідовне читання:") << seqScans;
+            allOk = false;
+        }
+        QJsonObject record;
+        record["type"] = "explain";
+        record["scale"] = scale.label;
+        record["query"] = explainCase.name;
+        record["ok"] = ok;
+        record["seqScans"] = QJsonArray::fromStringList(seqScans);
+        runner.writeRecord(record);
+    }
+    return allOk;
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("bookstore_bench");
+    Logging::installAsyncHandler();
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Мікробенчмарки DatabaseManager на синтетичних даних PostgreSQL.");
+    parser.addHelpOption();
+    QCommandLineOption hostOption("host", "Хост PostgreSQL.", "host", qEnvironmentVariable("PGHOST", "127.0.0.1"));
+    QCommandLineOption portOption("port", "Порт PostgreSQL.", "port", qEnvironmentVariable("PGPORT", "5432"));
+    QCommandLineOption dbOption("db", "База даних (її схему буде перестворено!).", "name", qEnvironmentVariable("PGDATABASE", "bookstore_bench"));
+    QCommandLineOption userOption("user", "Користувач.", "user", qEnvironmentVariable("PGUSER", "postgres"));
+    QCommandLineOption passwordOption("password", "Пароль.", "password", qEnvironmentVariable("PGPASSWORD"));
+    QCommandLineOption spawnOption("spawn-postgres", "Запустити тимчасовий кластер (initdb + pg_ctl) замість підключення.");
+    QCommandLineOption pgBinOption("pg-bin", "Каталог з initdb і pg_ctl.", "dir");
+    QCommandLineOption scaleOption("scale", "Масштаби через кому: 1k, 100k, 1m або кількість книг.", "list", "1k");
+    QCommandLineOption seedOption("seed", "Seed генератора даних і параметрів.", "n", "42");
+    QCommandLineOption connectionsOption("connections", "Паралельних з'єднань для заповнення даних.", "n", "4");
+    QCommandLineOption noSeedOption("no-seed", "Не перестворювати дані (лише для однієї шкали, вже заповненої).");
+    QCommandLineOption warmupOption("warmup", "Ітерацій прогріву.", "n", "20");
+    QCommandLineOption iterationsOption("iterations", "Вимірюваних ітерацій.", "n", "200");
+    QCommandLineOption minTimeOption("min-time-ms", "Мінімальний час вимірювання сценарію.", "ms", "0");
+    QCommandLineOption filterOption("filter", "Регулярний вираз для імен сценаріїв.", "regex");
+    QCommandLineOption resultCacheOption("result-cache", "Не вимикати кеш результатів (за замовчуванням вимкнено).");
+    QCommandLineOption outputOption("output", "Файл для JSON-рядків (за замовчуванням stdout).", "file");
+    QCommandLineOption explainCheckOption("explain-check",
+                                          "Замість замірів перевірити EXPLAIN гарячих запитів: жодного Seq Scan (для --scale 1m).");
+    parser.addOptions({hostOption, portOption, dbOption, userOption, passwordOption, spawnOption, pgBinOption,
+                       scaleOption, seedOption, connectionsOption, noSeedOption, warmupOption, iterationsOption, minTimeOption,
+                       filterOption, resultCacheOption, outputOption, explainCheckOption});
+    parser.process(app);
+
+    QList<BenchScale> scales;
+    for (const QString &label : parser.value(scaleOption).split(',', Qt::SkipEmptyParts)) {
+        bool ok = false;
+        const BenchScale scale = BenchScale::fromLabel(label, &ok);
+        if (!ok) {
+            qCritical() << "Невідомий масштаб:" << label;
+            return 2;
+        }
+        scales.append(scale);
+    }
+    if (scales.isEmpty() || (parser.isSet(noSeedOption) && scales.size() != 1)) {
+        qCritical() << "--no-seed можна використовувати лише з одним масштабом.";
+        return 2;
+    }
+
+    QFile output;
+    const bool toFile = parser.isSet(outputOption);
+    if (toFile) {
+        output.setFileName(parser.value(outputOption));
+        if (!output.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text)) {
+            qCritical() << "Не вдалося відкрити" << output.fileName() << ":" << output.errorString();
+            return 2;
+        }
+    } else if (!output.open(stdout, QIODevice::WriteOnly | QIODevice::Unbuffered)) {
+        return 2;
+    }
+
+    std::unique_ptr<LocalPostgres> localServer;
+    QString host = parser.value(hostOption);
+    int port = parser.value(portOption).toInt();
+    QString dbName = parser.value(dbOption);
+    QString user = parser.value(userOption);
+    if (parser.isSet(spawnOption)) {
+        localServer = std::make_unique<LocalPostgres>(parser.value(pgBinOption));
+        if (!localServer->start(port)) {
+            return 1;
+        }
+        host = localServer->host();
+        dbName = localServer->databaseName();
+        user = localServer->user();
+    }
+
+    DatabaseManager dbManager;
+    if (!dbManager.connectToDatabase(host, port, dbName, user, parser.value(passwordOption))) {
+        qCritical() << "Не вдалося підключитися до" << host << port << dbName;
+        return 1;
+    }
+    dbManager.queryResultCache().setEnabled(parser.isSet(resultCacheOption));
+
+    const quint64 seed = parser.value(seedOption).toULongLong();
+    const int connections = qMax(1, parser.value(connectionsOption).toInt());
+    // Пул має вмістити всі з'єднання генератора
+    dbManager.setConnectionPoolLimits(1, qMax(8, connections));
+    const ParamPicker pick(seed);
+
+    BenchOptions options;
+    options.warmupIterations = qMax(0, parser.value(warmupOption).toInt());
+    options.iterations = qMax(1, parser.value(iterationsOption).toInt());
+    options.minTimeMs = qMax(0, parser.value(minTimeOption).toInt());
+    if (parser.isSet(filterOption)) {
+        options.filter = QRegularExpression(parser.value(filterOption));
+    }
+
+    int exitCode = 0;
+    for (const BenchScale &scale : scales) {
+        if (!parser.isSet(noSeedOption) && !seedBenchDatabase(dbManager, scale, seed, connections)) {
+            return 1;
+        }
+
+        options.runInfo = QJsonObject{
+            {"scale", scale.label},
+            {"books", scale.books},
+            {"seed", QString::number(seed)},
+            {"resultCache", parser.isSet(resultCacheOption)},
+        };
+        BenchRunner runner(options, &output);
+
+        QJsonObject runRecord = options.runInfo;
+        runRecord["type"] = "run";
+        runRecord["startedAt"] = QDateTime::currentDateTimeUtc().toString(Qt::ISODate);
+        runRecord["serverVersion"] = serverVersion(dbManager.database());
+        runRecord["idealThreadCount"] = QThread::idealThreadCount();
+        runner.writeRecord(runRecord);
+
+        if (parser.isSet(explainCheckOption)) {
+            if (!runExplainCheck(dbManager, scale, pick, runner)) {
+                exitCode = 1;
+            }
+            continue;
+        }
+
+        dbManager.queryStatsRegistry().reset();
+        registerCases(runner, dbManager, scale, pick);
+        runner.runAll();
+
+        QJsonObject statsRecord = options.runInfo;
+        statsRecord["type"] = "queryStats";
+        statsRecord["queryStats"] = dbManager.queryStatsRegistry().toJson();
+        runner.writeRecord(statsRecord);
+    }
+
+    dbManager.closeConnection();
+    return exitCode;
+}
@@ -0,0 +1,98 @@
+#include "bookdisplayinfoloader.h"
+#include "logging.h"
+#include "database.h"
+#include <QDebug>
+#include <QMetaObject>
+#include <utility>
+
+BookDisplayInfoLoader::BookDisplayInfoLoader(const DatabaseManager *dbManager, QObject *parent)
+    : QObject(parent), m_dbManager(dbManager)
+{
+}
+
+QFuture<BookDisplayInfo> BookDisplayInfoLoader::load(int bookId)
+{
+    auto it = m_inFlight.constFind(bookId);
+    // Завершений, але не прибраний запис лишається, лише якщо відповідь так і не прийшла (пул зупинено)
+    if (it != m_inFlight.constEnd() && !it->isFinished()) {
+        return *it;
+    }
+
+    Promise promise = Promise::create();
+    promise->start();
+    QFuture<BookDisplayInfo> future = promise->future();
+    m_queued.insert(bookId, promise);
+    m_inFlight.insert(bookId, future);
+    scheduleDispatch();
+    return future;
+}
+
+QFuture<QMap<int, BookDisplayInfo>> BookDisplayInfoLoader::loadMany(const QList<int> &bookIds)
+{
+    QList<QFuture<BookDisplayInfo>> futures;
+    futures.reserve(bookIds.size());
+    for (int bookId : bookIds) {
+        futures.append(load(bookId));
+    }
+
+    if (futures.isEmpty()) {
+        QPromise<QMap<int, BookDisplayInfo>> empty;
+        empty.start();
+        empty.addResult(QMap<int, BookDisplayInfo>());
+        empty.finish();
+        return empty.future();
+    }
+
+    return QtFuture::whenAll(futures.begin(), futures.end())
+        .then([](const QList<QFuture<BookDisplayInfo>> &done) {
+            QMap<int, BookDisplayInfo> books;
+            for (const QFuture<BookDisplayInfo> &future : done) {
+                if (future.isCanceled() || future.resultCount() == 0) continue;
+                const BookDisplayInfo info = future.result();
+                if (info.found) {
+                    books.insert(info.bookId, info);
+                }
+            }
+            return books;
+        });
+}
+
+void BookDisplayInfoLoader::scheduleDispatch()
+{
+    if (m_dispatchScheduled) {
+        return;
+    }
+    m_dispatchScheduled = true;
+    // Відправка після повернення в цикл подій: усі запити поточної ітерації потраплять в один пакет
+    QMetaObject::invokeMethod(this, &BookDisplayInfoLoader::dispatch, Qt::QueuedConnection);
+}
+
+void BookDisplayInfoLoader::dispatch()
+{
+    m_dispatchScheduled = false;
+    if (m_queued.isEmpty()) {
+        return;
+    }
+
+    const QHash<int, Promise> batch = std::exchange(m_queued, {});
+    qCDebug(lcDbBook) << "BookDisplayInfoLoader: пакет із" << batch.size() << "ID книг.";
+
+    m_dbManager->getBookDisplayInfoByIdsAsync(batch.keys())
+        .then(this, [this, batch](const QMap<int, BookDisplayInfo> &books) {
+            resolve(batch, books);
+        });
+}
+
+void BookDisplayInfoLoader::resolve(const QHash<int, Promise> &batch, const QMap<int, BookDisplayInfo> &books)
+{
+    for (auto it = batch.constBegin(); it != batch.constEnd(); ++it) {
+        BookDisplayInfo info = books.value(it.key());
+        if (!info.found) {
+            info = BookDisplayInfo{};
+            info.bookId = it.key();
+        }
+        it.value()->addResult(info);
+        it.value()->finish();
+        m_inFlight.remove(it.key());
+    }
+}
@@ -0,0 +1,44 @@
+#ifndef BOOKDISPLAYINFOLOADER_H
+#define BOOKDISPLAYINFOLOADER_H
+
+#include <QObject>
+#include <QFuture>
+#include <QPromise>
+#include <QHash>
+#include <QMap>
+#include <QList>
+#include <QSharedPointer>
+#include "datatypes.h"
+
+class DatabaseManager;
+
+// Пакетне завантаження BookDisplayInfo за ID (DataLoader).
+// Усі load()/loadMany(), викликані протягом однієї ітерації циклу подій, збираються
+// в один запит GetBookDisplayInfoByIds. Повторні запити ID, що вже завантажується,
+// отримують той самий QFuture. Використовувати лише в потоці об'єкта (GUI).
+class BookDisplayInfoLoader : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit BookDisplayInfoLoader(const DatabaseManager *dbManager, QObject *parent = nullptr);
+
+    // Результат із found == false, якщо книгу не знайдено або запит не вдався
+    QFuture<BookDisplayInfo> load(int bookId);
+    // Мапа містить лише знайдені книги
+    QFuture<QMap<int, BookDisplayInfo>> loadMany(const QList<int> &bookIds);
+
+private:
+    using Promise = QSharedPointer<QPromise<BookDisplayInfo>>;
+
+    void scheduleDispatch();
+    void dispatch();
+    void resolve(const QHash<int, Promise> &batch, const QMap<int, BookDisplayInfo> &books);
+
+    const DatabaseManager *m_dbManager;
+    QHash<int, Promise> m_queued;                   // Чекають на наступну відправку
+    QHash<int, QFuture<BookDisplayInfo>> m_inFlight; // Поставлені в чергу або вже відправлені
+    bool m_dispatchScheduled = false;
+};
+
+#endif // BOOKDISPLAYINFOLOADER_H
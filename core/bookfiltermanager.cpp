@@ -0,0 +1,483 @@
+#include "bookfiltermanager.h"
+#include "database.h"
+#include <QHash>
+#include <QStringList>
+#include <QThread>
+#include <QtAlgorithms>
+#include <QtConcurrent/QtConcurrent>
+#include <QDebug>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+#include <emmintrin.h>
+#define BOOKFILTER_SSE2
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+#include <arm_neon.h>
+#define BOOKFILTER_NEON
+#endif
+
+using Bitset = std::vector<quint64>;
+
+namespace {
+
+// Стовпці знімка, які сканує фільтр
+struct ColumnData {
+    int rowCount = 0;
+    int wordCount = 0;                      // Слів по 64 рядки в кожному бітовому наборі
+
+    std::vector<qint32> priceCents;         // NULL - 0 (такі рядки відсікає pricedBits)
+    std::vector<qint32> stock;
+    std::vector<quint8> priceBuckets;       // Інтервал BookFacetCounts (лише для рядків з ціною)
+    std::vector<quint16> genreIds;          // Індекс у genreNames
+    std::vector<quint16> languageIds;       // Індекс у languageNames
+
+    QStringList genreNames;
+    QStringList languageNames;
+    QHash<QString, int> genreIndex;
+    QHash<QString, int> languageIndex;
+    std::vector<Bitset> genreBits;          // Рядки кожного жанру
+    std::vector<Bitset> languageBits;       // Рядки кожної мови
+    Bitset inStockBits;                     // stock_quantity > 0
+    Bitset pricedBits;                      // price IS NOT NULL
+};
+
+} // namespace
+
+struct BookFilterManager::Columns {
+    ColumnData data;
+    QList<BookDisplayInfo> books;           // Лише для видачі результатів, не скануються
+};
+
+namespace {
+
+// Умова фільтра, зведена до бітових наборів і цілих меж
+struct CompiledFilter {
+    std::vector<const Bitset *> genres;     // Об'єднання; порожньо - без умови
+    std::vector<const Bitset *> languages;
+    bool genreFilter = false;
+    bool languageFilter = false;
+    bool inStockOnly = false;
+    bool priceFilter = false;
+    qint32 minCents = std::numeric_limits<qint32>::min();
+    qint32 maxCents = std::numeric_limits<qint32>::max();
+};
+
+// Маски рядків одного слова (64 рядки) за кожною вимірністю фільтра; без умови - усі рядки
+struct WordMasks {
+    quint64 rows = 0;
+    quint64 genre = 0;
+    quint64 language = 0;
+    quint64 price = 0;
+    quint64 stock = 0;
+};
+
+// Лічильники фасетів для частини рядків; частини потім додаються
+struct FacetTally {
+    std::vector<int> genres;
+    std::vector<int> languages;
+    std::vector<int> priceBuckets;
+    int inStock = 0;
+    int total = 0;
+};
+
+// Суцільний діапазон слів [firstWord, lastWord) для паралельної обробки
+struct WordChunk {
+    int firstWord = 0;
+    int lastWord = 0;
+    QList<int> rows;
+    FacetTally tally;
+};
+
+qint32 clampCents(double cents)
+{
+    return qint32(qBound(double(std::numeric_limits<qint32>::min()), cents,
+                         double(std::numeric_limits<qint32>::max())));
+}
+
+CompiledFilter compileFilter(const ColumnData &columns, const BookFilterCriteria &criteria)
+{
+    CompiledFilter compiled;
+    compiled.genreFilter = !criteria.genres.isEmpty();
+    for (const QString &genre : criteria.genres) {
+        const auto it = columns.genreIndex.constFind(genre);
+        if (it != columns.genreIndex.constEnd()) compiled.genres.push_back(&columns.genreBits[it.value()]);
+    }
+    compiled.languageFilter = !criteria.languages.isEmpty();
+    for (const QString &language : criteria.languages) {
+        const auto it = columns.languageIndex.constFind(language);
+        if (it != columns.languageIndex.constEnd()) compiled.languages.push_back(&columns.languageBits[it.value()]);
+    }
+    compiled.inStockOnly = criteria.inStockOnly;
+    compiled.priceFilter = criteria.minPrice >= 0.0 || criteria.maxPrice >= 0.0;
+    if (criteria.minPrice >= 0.0) {
+        compiled.minCents = clampCents(std::ceil(criteria.minPrice * 100.0 - 1e-6));
+    }
+    if (criteria.maxPrice >= 0.0) {
+        compiled.maxCents = clampCents(std::floor(criteria.maxPrice * 100.0 + 1e-6));
+    }
+    return compiled;
+}
+
+// Ділить слова на частини за кількістю потоків; малий знімок - одна частина
+std::vector<WordChunk> wordChunks(const ColumnData &columns)
+{
+    const int chunkCount = columns.rowCount < BookFilterManager::ParallelThreshold
+                               ? 1 : qMax(1, QThread::idealThreadCount());
+    const int wordsPerChunk = qMax(1, (columns.wordCount + chunkCount - 1) / chunkCount);
+    std::vector<WordChunk> chunks;
+    for (int first = 0; first < columns.wordCount; first += wordsPerChunk) {
+        WordChunk chunk;
+        chunk.firstWord = first;
+        chunk.lastWord = qMin(columns.wordCount, first + wordsPerChunk);
+        chunks.push_back(std::move(chunk));
+    }
+    return chunks;
+}
+
+template <typename Fn>
+void processChunks(std::vector<WordChunk> &chunks, Fn fn)
+{
+    if (chunks.size() == 1) {
+        fn(chunks.front());
+    } else {
+        QtConcurrent::blockingMap(chunks, fn);
+    }
+}
+
+// Біти рядків [0, count) блоку, ціна яких у [lo, hi]; count <= 64
+quint64 priceRangeMask(const qint32 *prices, int count, qint32 lo, qint32 hi)
+{
+    quint64 mask = 0;
+    int i = 0;
+#if defined(BOOKFILTER_SSE2)
+    const __m128i low = _mm_set1_epi32(lo);
+    const __m128i high = _mm_set1_epi32(hi);
+    for (; i + 4 <= count; i += 4) {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(prices + i));
+        // Поза діапазоном: lo > v або v > hi
+        const __m128i outside = _mm_or_si128(_mm_cmpgt_epi32(low, v), _mm_cmpgt_epi32(v, high));
+        const int bits = ~_mm_movemask_ps(_mm_castsi128_ps(outside)) & 0xF;
+        mask |= quint64(bits) << i;
+    }
+#elif defined(BOOKFILTER_NEON)
+    const int32x4_t low = vdupq_n_s32(lo);
+    const int32x4_t high = vdupq_n_s32(hi);
+    static const uint32_t laneBits[4] = {1, 2, 4, 8};
+    const uint32x4_t weights = vld1q_u32(laneBits);
+    for (; i + 4 <= count; i += 4) {
+        const int32x4_t v = vld1q_s32(prices + i);
+        const uint32x4_t inside = vandq_u32(vcgeq_s32(v, low), vcleq_s32(v, high));
+        mask |= quint64(vaddvq_u32(vandq_u32(inside, weights))) << i;
+    }
+#endif
+    for (; i < count; ++i) {
+        if (prices[i] >= lo && prices[i] <= hi) {
+            mask |= quint64(1) << i;
+        }
+    }
+    return mask;
+}
+
+quint64 unionMask(const std::vector<const Bitset *> &bitsets, int word)
+{
+    quint64 any = 0;
+    for (const Bitset *bits : bitsets) any |= (*bits)[word];
+    return any;
+}
+
+// Маски вимірностей для слова w. skipPriceIfEmpty - ціни не скануються, якщо інші
+// умови вже нічого не лишили (для фільтра; фасетам ціни потрібні й тоді).
+WordMasks wordMasks(const ColumnData &columns, const CompiledFilter &filter, int w, bool skipPriceIfEmpty)
+{
+    WordMasks masks;
+    const int rowsInWord = qMin(64, columns.rowCount - w * 64);
+    masks.rows = rowsInWord == 64 ? ~quint64(0) : (quint64(1) << rowsInWord) - 1;
+    masks.genre = filter.genreFilter ? unionMask(filter.genres, w) : masks.rows;
+    masks.language = filter.languageFilter ? unionMask(filter.languages, w) : masks.rows;
+    masks.stock = filter.inStockOnly ? columns.inStockBits[w] : masks.rows;
+    masks.price = masks.rows;
+    if (filter.priceFilter) {
+        masks.price = columns.pricedBits[w];
+        const quint64 candidates = masks.rows & masks.genre & masks.language & masks.stock;
+        if (skipPriceIfEmpty && !(candidates & masks.price)) {
+            masks.price = 0;
+        } else if (masks.price) {
+            masks.price &= priceRangeMask(columns.priceCents.data() + w * 64, rowsInWord, filter.minCents, filter.maxCents);
+        }
+    }
+    return masks;
+}
+
+// Рядки, що проходять фільтр, для слів частини - у порядку знімка
+void filterChunk(const ColumnData &columns, const CompiledFilter &filter, WordChunk &chunk)
+{
+    for (int w = chunk.firstWord; w < chunk.lastWord; ++w) {
+        const WordMasks masks = wordMasks(columns, filter, w, true);
+        quint64 word = masks.rows & masks.genre & masks.language & masks.stock & masks.price;
+        while (word) {
+            chunk.rows.append(w * 64 + int(qCountTrailingZeroBits(word)));
+            word &= word - 1;
+        }
+    }
+}
+
+template <typename T>
+void countRows(quint64 word, int wordIndex, const std::vector<T> &valueIds, std::vector<int> &counts)
+{
+    while (word) {
+        ++counts[valueIds[wordIndex * 64 + int(qCountTrailingZeroBits(word))]];
+        word &= word - 1;
+    }
+}
+
+// Фасети частини: кожна вимірність - за умовами всіх інших
+void countChunkFacets(const ColumnData &columns, const CompiledFilter &filter, WordChunk &chunk)
+{
+    FacetTally &tally = chunk.tally;
+    tally.genres.assign(columns.genreNames.size(), 0);
+    tally.languages.assign(columns.languageNames.size(), 0);
+    tally.priceBuckets.assign(BookFacetCounts::PriceBuckets, 0);
+    for (int w = chunk.firstWord; w < chunk.lastWord; ++w) {
+        const WordMasks m = wordMasks(columns, filter, w, false);
+        const quint64 all = m.rows & m.genre & m.language & m.price;
+        tally.total += int(qPopulationCount(all & m.stock));
+        tally.inStock += int(qPopulationCount(all & columns.inStockBits[w]));
+        countRows(m.rows & m.language & m.price & m.stock, w, columns.genreIds, tally.genres);
+        countRows(m.rows & m.genre & m.price & m.stock, w, columns.languageIds, tally.languages);
+        countRows(m.rows & m.genre & m.language & m.stock & columns.pricedBits[w], w, columns.priceBuckets, tally.priceBuckets);
+    }
+}
+
+QList<FacetValueCount> namedCounts(const QStringList &names, const std::vector<int> &counts)
+{
+    QList<FacetValueCount> result;
+    for (int id = 0; id < names.size(); ++id) {
+        // Порожні значення панель не показує (як і GetBookFacetCountsBase)
+        if (!names.at(id).isEmpty()) {
+            result.append({names.at(id), counts[id]});
+        }
+    }
+    std::sort(result.begin(), result.end(), [](const FacetValueCount &a, const FacetValueCount &b) {
+        return QString::localeAwareCompare(a.value, b.value) < 0;
+    });
+    return result;
+}
+
+} // namespace
+
+BookDisplayInfo BookFilterManager::Result::bookAt(int index) const
+{
+    if (!m_columns || index < 0 || index >= m_rows.size()) {
+        return BookDisplayInfo();
+    }
+    return m_columns->books.at(m_rows.at(index));
+}
+
+QList<BookDisplayInfo> BookFilterManager::Result::books(int offset, int count) const
+{
+    QList<BookDisplayInfo> result;
+    if (!m_columns) {
+        return result;
+    }
+    const int end = qMin(m_rows.size(), offset + qMax(0, count));
+    result.reserve(qMax(0, end - offset));
+    for (int i = qMax(0, offset); i < end; ++i) {
+        result.append(m_columns->books.at(m_rows.at(i)));
+    }
+    return result;
+}
+
+BookFilterManager::BookFilterManager(DatabaseManager *dbManager, QObject *parent)
+    : QObject(parent)
+    , m_dbManager(dbManager)
+{
+}
+
+BookFilterManager::~BookFilterManager() = default;
+
+void BookFilterManager::reload()
+{
+    if (!m_dbManager) {
+        qWarning() << "BookFilterManager: DatabaseManager is null, snapshot not loaded.";
+        return;
+    }
+    const int generation = ++m_reloadGeneration;
+    DatabaseManager *dbManager = m_dbManager;
+    // Запит і побудова стовпців - на робочому потоці; у GUI лише підміна вказівника
+    m_dbManager->runAsync([dbManager]() { return build(dbManager->getBookFilterSource()); })
+        .then(this, [this, generation](const std::shared_ptr<const Columns> &columns) {
+            if (generation != m_reloadGeneration) {
+                return;
+            }
+            if (!columns || columns->data.rowCount == 0) {
+                qWarning() << "BookFilterManager: catalog snapshot is empty, filters stay on the database.";
+                return;
+            }
+            m_columns = columns;
+            qInfo() << "BookFilterManager: catalog snapshot loaded," << columns->data.rowCount << "books.";
+            emit snapshotReady();
+        });
+}
+
+void BookFilterManager::setSource(const QList<BookFilterSourceItem> &items)
+{
+    ++m_reloadGeneration;
+    m_columns = build(items);
+}
+
+int BookFilterManager::bookCount() const
+{
+    return m_columns ? m_columns->data.rowCount : 0;
+}
+
+std::shared_ptr<const BookFilterManager::Columns> BookFilterManager::build(const QList<BookFilterSourceItem> &items)
+{
+    auto columns = std::make_shared<Columns>();
+    ColumnData &data = columns->data;
+    const int rowCount = items.size();
+    data.rowCount = rowCount;
+    data.wordCount = (rowCount + 63) / 64;
+    columns->books.reserve(rowCount);
+    data.priceCents.resize(rowCount);
+    data.stock.resize(rowCount);
+    data.priceBuckets.resize(rowCount);
+    data.genreIds.resize(rowCount);
+    data.languageIds.resize(rowCount);
+    data.inStockBits.assign(data.wordCount, 0);
+    data.pricedBits.assign(data.wordCount, 0);
+
+    auto dictionaryId = [&data](const QString &value, QStringList &names, QHash<QString, int> &index,
+                                std::vector<Bitset> &bits) {
+        auto it = index.constFind(value);
+        if (it != index.constEnd()) {
+            return it.value();
+        }
+        const int id = names.size();
+        names.append(value);
+        index.insert(value, id);
+        bits.emplace_back(data.wordCount, 0);
+        return id;
+    };
+
+    const qint32 bucketWidthCents = BookFacetCounts::PriceBucketWidth * 100;
+    for (int row = 0; row < rowCount; ++row) {
+        const BookFilterSourceItem &item = items.at(row);
+        const quint64 bit = quint64(1) << (row % 64);
+        const int word = row / 64;
+
+        columns->books.append(item.book);
+        // NUMERIC(10, 2): копійки точні, тож межі в копійках дають ті самі рядки, що й SQL
+        data.priceCents[row] = item.hasPrice ? clampCents(std::round(item.book.price * 100.0)) : 0;
+        data.priceBuckets[row] = quint8(qBound(0, data.priceCents[row] / bucketWidthCents, BookFacetCounts::PriceBuckets - 1));
+        data.stock[row] = item.book.stockQuantity;
+        if (item.hasPrice) data.pricedBits[word] |= bit;
+        if (item.book.stockQuantity > 0) data.inStockBits[word] |= bit;
+
+        const int genreId = dictionaryId(item.book.genre, data.genreNames, data.genreIndex, data.genreBits);
+        const int languageId = dictionaryId(item.language, data.languageNames, data.languageIndex, data.languageBits);
+        data.genreIds[row] = quint16(genreId);
+        data.languageIds[row] = quint16(languageId);
+        data.genreBits[genreId][word] |= bit;
+        data.languageBits[languageId][word] |= bit;
+    }
+    return columns;
+}
+
+BookFilterManager::Result BookFilterManager::filter(const BookFilterCriteria &criteria) const
+{
+    Result result;
+    result.m_columns = m_columns;
+    if (!m_columns) {
+        return result;
+    }
+    const ColumnData &columns = m_columns->data;
+    const CompiledFilter compiled = compileFilter(columns, criteria);
+
+    // Частини по суцільних діапазонах слів, результати зшиваються по порядку
+    std::vector<WordChunk> chunks = wordChunks(columns);
+    processChunks(chunks, [&compiled, &columns](WordChunk &chunk) { filterChunk(columns, compiled, chunk); });
+    if (chunks.size() == 1) {
+        result.m_rows = std::move(chunks.front().rows);
+        return result;
+    }
+    int total = 0;
+    for (const WordChunk &chunk : chunks) total += chunk.rows.size();
+    result.m_rows.reserve(total);
+    for (const WordChunk &chunk : chunks) result.m_rows.append(chunk.rows);
+    return result;
+}
+
+BookFacetCounts BookFilterManager::facets(const BookFilterCriteria &criteria) const
+{
+    BookFacetCounts facets;
+    if (!m_columns) {
+        return facets;
+    }
+    const ColumnData &columns = m_columns->data;
+    const CompiledFilter compiled = compileFilter(columns, criteria);
+
+    std::vector<WordChunk> chunks = wordChunks(columns);
+    processChunks(chunks, [&compiled, &columns](WordChunk &chunk) { countChunkFacets(columns, compiled, chunk); });
+
+    FacetTally tally;
+    tally.genres.assign(columns.genreNames.size(), 0);
+    tally.languages.assign(columns.languageNames.size(), 0);
+    tally.priceBuckets.assign(BookFacetCounts::PriceBuckets, 0);
+    for (const WordChunk &chunk : chunks) {
+        for (size_t i = 0; i < tally.genres.size(); ++i) tally.genres[i] += chunk.tally.genres[i];
+        for (size_t i = 0; i < tally.languages.size(); ++i) tally.languages[i] += chunk.tally.languages[i];
+        for (size_t i = 0; i < tally.priceBuckets.size(); ++i) tally.priceBuckets[i] += chunk.tally.priceBuckets[i];
+        tally.inStock += chunk.tally.inStock;
+        tally.total += chunk.tally.total;
+    }
+
+    facets.genres = namedCounts(columns.genreNames, tally.genres);
+    facets.languages = namedCounts(columns.languageNames, tally.languages);
+    for (int bucket = 0; bucket < BookFacetCounts::PriceBuckets; ++bucket) {
+        PriceBucketCount priceBucket;
+        priceBucket.minPrice = bucket * BookFacetCounts::PriceBucketWidth;
+        priceBucket.maxPrice = bucket + 1 < BookFacetCounts::PriceBuckets ? priceBucket.minPrice + BookFacetCounts::PriceBucketWidth : -1.0;
+        priceBucket.count = tally.priceBuckets[bucket];
+        facets.priceBuckets.append(priceBucket);
+    }
+    facets.inStock = tally.inStock;
+    facets.total = tally.total;
+    facets.found = true;
+    return facets;
+}
+
+void BookFilterManager::setGenreFilter(const QString &genre)
+{
+    m_currentCriteria.genres = genre.isEmpty() ? QStringList() : QStringList{genre};
+}
+
+void BookFilterManager::setPriceRangeFilter(double minPrice, double maxPrice)
+{
+    m_currentCriteria.minPrice = minPrice;
+    m_currentCriteria.maxPrice = maxPrice;
+}
+
+void BookFilterManager::resetFilters()
+{
+    m_currentCriteria = BookFilterCriteria();
+}
+
+BookFilterCriteria BookFilterManager::getCurrentCriteria() const
+{
+    return m_currentCriteria;
+}
+
+QList<BookDisplayInfo> BookFilterManager::getFilteredBooks() const
+{
+    if (isReady()) {
+        const Result result = filter(m_currentCriteria);
+        return result.books(0, result.size());
+    }
+    if (!m_dbManager) {
+        return QList<BookDisplayInfo>();
+    }
+    return m_dbManager->getFilteredBooksForDisplay(m_currentCriteria);
+}
@@ -4,15 +4,63 @@
 #include <QObject>
 #include <QString>
 #include <QList>
+#include <memory>
 #include "datatypes.h" // Для BookDisplayInfo та BookFilterCriteria
 
 class DatabaseManager; // Forward declaration
 
+// Фільтрація каталогу в пам'яті для бічної панелі сторінки "Книги".
+//
+// Тримає стовпцевий знімок каталогу (getBookFilterSource): ціни в копійках і залишки як
+// масиви, жанри й мови - ідентифікатори словника, а для кожного значення - бітовий набір
+// рядків. BookFilterCriteria обчислюється без БД: перетин/об'єднання бітових наборів
+// жанрів, мов і наявності, потім SIMD-сканування цін лише там, де ще лишилися рядки.
+// Великий каталог ділиться на частини, що обробляються паралельно.
+//
+// Знімок незмінний і спільний (shared_ptr): reload() будує новий на робочому потоці БД і
+// підміняє його в потоці GUI, а вже отримані Result лишаються дійсними.
+// Поки знімка немає, getFilteredBooks() звертається до БД (getFilteredBooksForDisplay).
 class BookFilterManager : public QObject
 {
     Q_OBJECT
+
+    struct Columns;
+
 public:
+    // Результат фільтрації: рядки знімка в порядку каталогу (title, book_id)
+    class Result
+    {
+    public:
+        bool isValid() const { return m_columns != nullptr; }
+        int size() const { return m_rows.size(); }
+        bool isEmpty() const { return m_rows.isEmpty(); }
+        BookDisplayInfo bookAt(int index) const;
+        QList<BookDisplayInfo> books(int offset, int count) const;
+
+    private:
+        friend class BookFilterManager;
+        std::shared_ptr<const Columns> m_columns;
+        QList<int> m_rows;
+    };
+
+    // Менше рядків фільтруються в одному потоці: розподіл коштував би більше за роботу
+    static constexpr int ParallelThreshold = 1 << 18;
+
     explicit BookFilterManager(DatabaseManager *dbManager, QObject *parent = nullptr);
+    ~BookFilterManager();
+
+    // Знімок каталогу: reload() - асинхронно з БД (сигнал snapshotReady),
+    // setSource() - синхронно з уже завантажених рядків
+    void reload();
+    void setSource(const QList<BookFilterSourceItem> &items);
+    bool isReady() const { return m_columns != nullptr; }
+    int bookCount() const;
+
+    // Без звернення до БД; недійсний Result, якщо знімок ще не завантажено
+    Result filter(const BookFilterCriteria &criteria) const;
+    // Фасети панелі фільтрів за один прохід по знімку (як GetBookFacetCountsBase);
+    // found = false, якщо знімок ще не завантажено
+    BookFacetCounts facets(const BookFilterCriteria &criteria) const;
 
     // Методи для встановлення критеріїв
     void setGenreFilter(const QString &genre);
@@ -26,15 +74,15 @@ public:
     QList<BookDisplayInfo> getFilteredBooks() const;
 
 signals:
-    // Сигнал, що випромінюється при зміні фільтрів (після застосування)
-    // Цей сигнал може бути корисним, якщо інші частини програми
-    // захочуть реагувати на зміну фільтрів. Наразі він не використовується
-    // безпосередньо в MainWindow, оскільки оновлення відбувається явно.
-    // void filtersApplied(); // Закоментовано, оскільки не використовується
+    void snapshotReady();
 
 private:
+    static std::shared_ptr<const Columns> build(const QList<BookFilterSourceItem> &items);
+
     DatabaseManager *m_dbManager; // Вказівник на менеджер БД (не володіє ним)
     BookFilterCriteria m_currentCriteria;
+    std::shared_ptr<const Columns> m_columns;
+    int m_reloadGeneration = 0;   // Відповідь старішого reload() відкидається
 };
 
 #endif // BOOKFILTERMANAGER_H
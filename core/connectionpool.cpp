@@ -0,0 +1,352 @@
+#include "connectionpool.h"
+#include "logging.h"
+#include <QDebug>
+#include <QSqlError>
+#include <QSqlQuery>
+#include <QThread>
+#include <QDateTime>
+#include <QDeadlineTimer>
+#include <QMutexLocker>
+
+// --- PooledConnection ---
+
+PooledConnection::PooledConnection(ConnectionPool *pool, const QString &connectionName)
+    : m_pool(pool), m_connectionName(connectionName)
+{
+}
+
+PooledConnection::~PooledConnection()
+{
+    release();
+}
+
+PooledConnection::PooledConnection(PooledConnection &&other) noexcept
+    : m_pool(other.m_pool), m_connectionName(std::move(other.m_connectionName))
+{
+    other.m_pool = nullptr;
+    other.m_connectionName.clear();
+}
+
+PooledConnection &PooledConnection::operator=(PooledConnection &&other) noexcept
+{
+    if (this != &other) {
+        release();
+        m_pool = other.m_pool;
+        m_connectionName = std::move(other.m_connectionName);
+        other.m_pool = nullptr;
+        other.m_connectionName.clear();
+    }
+    return *this;
+}
+
+QSqlDatabase PooledConnection::database() const
+{
+    if (!m_pool) {
+        return QSqlDatabase();
+    }
+    return QSqlDatabase::database(m_connectionName, false);
+}
+
+void PooledConnection::release()
+{
+    if (m_pool) {
+        m_pool->release(m_connectionName);
+        m_pool = nullptr;
+        m_connectionName.clear();
+    }
+}
+
+// --- ConnectionPool ---
+
+ConnectionPool::ConnectionPool(const ConnectionPoolConfig &config, QObject *parent)
+    : QObject(parent),
+      m_config(config),
+      m_namePrefix(QString("db_pool_%1_").arg(QDateTime::currentMSecsSinceEpoch()))
+{
+    setLimits(config.minSize, config.maxSize);
+}
+
+ConnectionPool::~ConnectionPool()
+{
+    QStringList toClose;
+    {
+        QMutexLocker locker(&m_mutex);
+        // QSqlDatabase іншого потоку звідси не закрити: такі з'єднання мали бути закриті
+        // власниками під час завершення їхніх потоків (DatabaseManager::closeConnection)
+        for (const Entry &entry : std::as_const(m_entries)) {
+            if (entry.owner != QThread::currentThread()) {
+                qCWarning(lcDbPool) << "ConnectionPool: з'єднання" << entry.name << "належить іншому потоку, що ще працює; його не закрито.";
+                continue;
+            }
+            if (entry.inUse) {
+                qCWarning(lcDbPool) << "ConnectionPool: з'єднання" << entry.name << "ще орендоване при знищенні пулу.";
+            }
+            toClose.append(entry.name);
+        }
+        m_entries.clear();
+        m_watchedThreads.clear();
+    }
+    for (const QString &name : std::as_const(toClose)) {
+        closeConnection(name);
+    }
+    qCInfo(lcDbPool) << "ConnectionPool: закрито" << toClose.size() << "з'єднань пулу.";
+}
+
+PooledConnection ConnectionPool::acquire()
+{
+    QThread *self = QThread::currentThread();
+    QStringList toClose;
+    QString chosen;
+    bool needOpen = false;
+    bool needCheck = false;
+
+    {
+        QMutexLocker locker(&m_mutex);
+        watchThread(self);
+        QDeadlineTimer deadline(m_config.acquireTimeoutMs);
+
+        while (true) {
+            reapLocked(self, toClose);
+
+            // 1. Вільне з'єднання, що вже належить цьому потоку
+            for (Entry &entry : m_entries) {
+                if (entry.owner == self && !entry.inUse) {
+                    entry.inUse = true;
+                    needCheck = entry.idleTimer.isValid()
+                                && entry.idleTimer.elapsed() >= m_config.healthCheckIntervalMs;
+                    chosen = entry.name;
+                    break;
+                }
+            }
+            if (!chosen.isEmpty()) break;
+
+            // 2. Є місце - створюємо нове з'єднання для цього потоку
+            if (m_entries.size() < m_config.maxSize) {
+                Entry entry;
+                entry.name = m_namePrefix + QString::number(++m_nextId);
+                entry.owner = self;
+                entry.inUse = true;
+                m_entries.append(entry);
+                chosen = entry.name;
+                needOpen = true;
+                break;
+            }
+
+            // 3. Пул заповнений. Чуже з'єднання закрити звідси не можна (QSqlDatabase прив'язане
+            // до потоку-власника), тож місце звільниться лише тоді, коли власник закриє своє
+            // з'єднання: після простою, зменшення ліміту або із завершенням потоку.
+            if (!m_released.wait(&m_mutex, deadline)) {
+                int idleElsewhere = 0;
+                for (const Entry &entry : std::as_const(m_entries)) {
+                    if (entry.owner != self && !entry.inUse) ++idleElsewhere;
+                }
+                qCWarning(lcDbPool) << "ConnectionPool: тайм-аут очікування вільного з'єднання (" << m_config.acquireTimeoutMs
+                           << "мс, максимум" << m_config.maxSize << ", вільних в інших потоках:" << idleElsewhere << ").";
+                break;
+            }
+        }
+    }
+
+    for (const QString &name : std::as_const(toClose)) {
+        closeConnection(name);
+    }
+
+    if (chosen.isEmpty()) {
+        return PooledConnection();
+    }
+
+    bool ready = true;
+    if (needOpen) {
+        ready = openConnection(chosen);
+    } else if (needCheck && !isHealthy(chosen)) {
+        qCWarning(lcDbPool) << "ConnectionPool: з'єднання" << chosen << "не пройшло перевірку, перевідкриваємо.";
+        closeConnection(chosen);
+        ready = openConnection(chosen);
+    }
+
+    if (!ready) {
+        QMutexLocker locker(&m_mutex);
+        int idx = indexOf(chosen);
+        if (idx >= 0) m_entries.removeAt(idx);
+        m_released.wakeAll();
+        return PooledConnection();
+    }
+
+    return PooledConnection(this, chosen);
+}
+
+void ConnectionPool::release(const QString &connectionName)
+{
+    QStringList toClose;
+    {
+        QMutexLocker locker(&m_mutex);
+        int idx = indexOf(connectionName);
+        if (idx < 0) {
+            // Пул уже закрив з'єднання (наприклад, при знищенні)
+            return;
+        }
+        Entry &entry = m_entries[idx];
+        if (entry.owner != QThread::currentThread()) {
+            qCWarning(lcDbPool) << "ConnectionPool: з'єднання" << connectionName << "повертається з чужого потоку.";
+        }
+        entry.inUse = false;
+        entry.idleTimer.start();
+        reapLocked(QThread::currentThread(), toClose);
+        m_released.wakeAll();
+    }
+    for (const QString &name : std::as_const(toClose)) {
+        closeConnection(name);
+    }
+}
+
+void ConnectionPool::reapIdle()
+{
+    QStringList toClose;
+    {
+        QMutexLocker locker(&m_mutex);
+        reapLocked(QThread::currentThread(), toClose);
+        if (!toClose.isEmpty()) m_released.wakeAll();
+    }
+    for (const QString &name : std::as_const(toClose)) {
+        closeConnection(name);
+    }
+}
+
+void ConnectionPool::reapLocked(QThread *thread, QStringList &toClose)
+{
+    for (int i = m_entries.size() - 1; i >= 0; --i) {
+        const Entry &entry = m_entries.at(i);
+        if (entry.owner != thread || entry.inUse) continue;
+
+        const bool expired = entry.idleTimer.isValid()
+                             && entry.idleTimer.elapsed() >= m_config.idleTimeoutMs
+                             && m_entries.size() > m_config.minSize;
+        // Після зменшення ліміту зайві вільні з'єднання закриваються при наступному зверненні власника
+        if (expired || m_entries.size() > m_config.maxSize) {
+            toClose.append(entry.name);
+            m_entries.removeAt(i);
+        }
+    }
+}
+
+void ConnectionPool::setLimits(int minSize, int maxSize)
+{
+    QMutexLocker locker(&m_mutex);
+    m_config.maxSize = qMax(1, maxSize);
+    m_config.minSize = qBound(0, minSize, m_config.maxSize);
+    m_released.wakeAll();
+}
+
+void ConnectionPool::setConnectionClosingHandler(std::function<void(const QString &)> handler)
+{
+    m_closingHandler = std::move(handler);
+}
+
+ConnectionPoolConfig ConnectionPool::config() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_config;
+}
+
+int ConnectionPool::totalCount() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_entries.size();
+}
+
+int ConnectionPool::inUseCount() const
+{
+    QMutexLocker locker(&m_mutex);
+    int count = 0;
+    for (const Entry &entry : m_entries) {
+        if (entry.inUse) ++count;
+    }
+    return count;
+}
+
+bool ConnectionPool::openConnection(const QString &connectionName)
+{
+    bool opened = false;
+    {
+        QSqlDatabase db = QSqlDatabase::addDatabase("QPSQL", connectionName);
+        db.setHostName(m_config.host);
+        db.setPort(m_config.port);
+        db.setDatabaseName(m_config.dbName);
+        db.setUserName(m_config.user);
+        db.setPassword(m_config.password);
+        opened = db.open();
+        if (!opened) {
+            qCCritical(lcDbPool) << "ConnectionPool: не вдалося відкрити з'єднання" << connectionName << ":" << db.lastError().text();
+        }
+    }
+    if (!opened) {
+        QSqlDatabase::removeDatabase(connectionName);
+        return false;
+    }
+    qCDebug(lcDbPool) << "ConnectionPool: відкрито з'єднання" << connectionName << "для потоку" << QThread::currentThread();
+    return true;
+}
+
+bool ConnectionPool::isHealthy(const QString &connectionName) const
+{
+    QSqlDatabase db = QSqlDatabase::database(connectionName, false);
+    if (!db.isOpen()) {
+        return false;
+    }
+    QSqlQuery query(db);
+    return query.exec("SELECT 1") && query.next();
+}
+
+void ConnectionPool::closeConnection(const QString &connectionName)
+{
+    if (m_closingHandler) {
+        m_closingHandler(connectionName);
+    }
+    {
+        QSqlDatabase db = QSqlDatabase::database(connectionName, false);
+        if (db.isOpen()) {
+            db.close();
+        }
+    }
+    QSqlDatabase::removeDatabase(connectionName);
+    qCDebug(lcDbPool) << "ConnectionPool: з'єднання" << connectionName << "закрито.";
+}
+
+void ConnectionPool::watchThread(QThread *thread)
+{
+    if (!thread || m_watchedThreads.contains(thread)) {
+        return;
+    }
+    m_watchedThreads.insert(thread);
+    // finished випромінюється в самому потоці, тож DirectConnection закриває з'єднання в потоці-власнику
+    connect(thread, &QThread::finished, this, [this, thread]() {
+        closeThreadConnections(thread);
+    }, Qt::DirectConnection);
+}
+
+void ConnectionPool::closeThreadConnections(QThread *thread)
+{
+    QStringList toClose;
+    {
+        QMutexLocker locker(&m_mutex);
+        for (int i = m_entries.size() - 1; i >= 0; --i) {
+            if (m_entries.at(i).owner == thread) {
+                toClose.append(m_entries.at(i).name);
+                m_entries.removeAt(i);
+            }
+        }
+        m_watchedThreads.remove(thread);
+        m_released.wakeAll();
+    }
+    for (const QString &name : std::as_const(toClose)) {
+        closeConnection(name);
+    }
+}
+
+int ConnectionPool::indexOf(const QString &connectionName) const
+{
+    for (int i = 0; i < m_entries.size(); ++i) {
+        if (m_entries.at(i).name == connectionName) return i;
+    }
+    return -1;
+}
@@ -0,0 +1,116 @@
+#ifndef CONNECTIONPOOL_H
+#define CONNECTIONPOOL_H
+
+#include <QObject>
+#include <QSqlDatabase>
+#include <QString>
+#include <QList>
+#include <QSet>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QElapsedTimer>
+#include <functional>
+
+class QThread;
+class ConnectionPool;
+
+// Параметри пулу з'єднань
+struct ConnectionPoolConfig {
+    QString host;
+    int port = 5432;
+    QString dbName;
+    QString user;
+    QString password;
+    int minSize = 1;                  // Скільки з'єднань не закривати при прибиранні простою
+    int maxSize = 8;                  // Максимальна кількість відкритих з'єднань (усі потоки разом)
+    int idleTimeoutMs = 60000;        // Через скільки простою з'єднання закривається
+    int healthCheckIntervalMs = 30000;// Після якого простою з'єднання перевіряється "SELECT 1"
+    int acquireTimeoutMs = 10000;     // Скільки чекати вільного місця в пулі
+};
+
+// RAII-оренда з'єднання. Повертає з'єднання в пул при знищенні.
+// Використовувати лише в тому потоці, де з'єднання було отримано.
+class PooledConnection
+{
+public:
+    PooledConnection() = default;
+    ~PooledConnection();
+
+    PooledConnection(PooledConnection &&other) noexcept;
+    PooledConnection &operator=(PooledConnection &&other) noexcept;
+    PooledConnection(const PooledConnection &) = delete;
+    PooledConnection &operator=(const PooledConnection &) = delete;
+
+    bool isValid() const { return m_pool != nullptr; }
+    QString connectionName() const { return m_connectionName; }
+    QSqlDatabase database() const;
+    void release();
+
+private:
+    friend class ConnectionPool;
+    PooledConnection(ConnectionPool *pool, const QString &connectionName);
+
+    ConnectionPool *m_pool = nullptr;
+    QString m_connectionName;
+};
+
+// Пул з'єднань QPSQL з прив'язкою до потоків.
+// QSqlDatabase можна використовувати лише в потоці, що його створив, тому кожне
+// з'єднання пулу "належить" одному потоку і видається тільки йому. Вільне з'єднання
+// іншого потоку не передається: тому потоків, що користуються пулом, не має бути більше
+// за maxSize (DatabaseManager обмежує ними m_workerPool).
+class ConnectionPool : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit ConnectionPool(const ConnectionPoolConfig &config, QObject *parent = nullptr);
+    ~ConnectionPool();
+
+    // Орендує з'єднання для поточного потоку. Повертає недійсну оренду при помилці чи тайм-ауті.
+    PooledConnection acquire();
+
+    // Закриває з'єднання поточного потоку, що простоюють довше idleTimeoutMs (не нижче minSize).
+    void reapIdle();
+
+    void setLimits(int minSize, int maxSize);
+
+    // Викликається в потоці-власнику безпосередньо перед закриттям з'єднання
+    // (наприклад, щоб звільнити кешовані підготовлені запити). Встановлювати до першого acquire().
+    void setConnectionClosingHandler(std::function<void(const QString &connectionName)> handler);
+    ConnectionPoolConfig config() const;
+
+    int totalCount() const;
+    int inUseCount() const;
+
+private:
+    friend class PooledConnection;
+
+    struct Entry {
+        QString name;
+        QThread *owner = nullptr;
+        bool inUse = false;
+        QElapsedTimer idleTimer;      // Час від останнього повернення в пул
+    };
+
+    void release(const QString &connectionName);
+    bool openConnection(const QString &connectionName);
+    bool isHealthy(const QString &connectionName) const;
+    void closeConnection(const QString &connectionName);
+    void watchThread(QThread *thread);
+    void closeThreadConnections(QThread *thread);
+    void reapLocked(QThread *thread, QStringList &toClose);
+    int indexOf(const QString &connectionName) const;
+
+    ConnectionPoolConfig m_config;
+    const QString m_namePrefix;
+    quint64 m_nextId = 0;
+
+    mutable QMutex m_mutex;
+    QWaitCondition m_released;
+    QList<Entry> m_entries;
+    QSet<QThread*> m_watchedThreads;
+    std::function<void(const QString &)> m_closingHandler;
+};
+
+#endif // CONNECTIONPOOL_H
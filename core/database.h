@@ -16,10 +16,59 @@
 #include <QTextStream> // Для читання файлів
 #include <QDir>     // Для роботи з директоріями
 #include <QCryptographicHash> // Додано для хешування паролів
+#include <QFuture>
+#include <QThreadPool>
+#include <QTimer>
+#include <QHash>
+#include <QJsonArray>
+#include <QMutex>
+#include <QtConcurrent/QtConcurrent>
+#include <memory>
+#include <type_traits>
+#include <utility>
 #include "datatypes.h"
+#include "connectionpool.h"
+#include "bookdisplayinfoloader.h"
+#include "querycache.h"
+#include "querystats.h"
+#include "querycancel.h"
+#include "sqlregistry.h"   // Генерується з sql/*.sql (tools/sqlregistrygen)
 
 class QSqlQuery;
 
+// Статистика кешу підготовлених запитів
+struct StatementCacheStats {
+    quint64 hits = 0;
+    quint64 misses = 0;
+    int connections = 0;        // З'єднань, що мають кешовані запити
+    int cachedStatements = 0;   // Усього підготовлених запитів у кеші
+};
+
+// Оцінка пам'яті для кешу результатів (QueryResultCache)
+inline qint64 queryCacheCost(const BookDisplayInfo &book)
+{
+    return sizeof(BookDisplayInfo) + (book.title.size() + book.authors.size() + book.coverImagePath.size() + book.genre.size()) * qint64(sizeof(QChar));
+}
+inline qint64 queryCacheCost(const AuthorDisplayInfo &author)
+{
+    return sizeof(AuthorDisplayInfo) + (author.firstName.size() + author.lastName.size() + author.nationality.size() + author.imagePath.size()) * qint64(sizeof(QChar));
+}
+inline qint64 queryCacheCost(const AuthorDetailsInfo &details)
+{
+    return sizeof(AuthorDetailsInfo) + queryCacheCost(details.books)
+           + (details.firstName.size() + details.lastName.size() + details.nationality.size()
+              + details.imagePath.size() + details.biography.size()) * qint64(sizeof(QChar));
+}
+
+inline qint64 queryCacheCost(const BookFacetCounts &facets)
+{
+    qint64 cost = sizeof(BookFacetCounts) + (facets.genres.size() + facets.languages.size()) * qint64(sizeof(FacetValueCount))
+                  + facets.priceBuckets.size() * qint64(sizeof(PriceBucketCount));
+    for (const FacetValueCount &genre : facets.genres) cost += genre.value.size() * qint64(sizeof(QChar));
+    for (const FacetValueCount &language : facets.languages) cost += language.value.size() * qint64(sizeof(QChar));
+    return cost;
+}
+
 class DatabaseManager : public QObject
 {
     Q_OBJECT
@@ -35,6 +84,10 @@ public:
                            const QString &password);
 
     bool createSchemaTables();
+    // Вторинні індекси (schema.sql). createSchemaTables() створює їх з таблицями; для масового
+    // завантаження швидше видалити їх перед COPY і побудувати один раз після.
+    bool createSecondaryIndexes();
+    bool dropSecondaryIndexes();
 
     QSqlError lastError() const;
     void closeConnection();
@@ -68,11 +121,22 @@ public:
 
     QList<SearchSuggestionInfo> getSearchSuggestions(const QString &prefix, int limit = 10) const;
 
+    // Книги й автори з популярністю для SuggestionIndex; id > afterBookId/afterAuthorId - для дозавантаження
+    QList<SuggestionSourceItem> getSuggestionSource(int afterBookId = 0, int afterAuthorId = 0) const;
+    // Увесь каталог для BookFilterManager, у порядку (title, book_id)
+    QList<BookFilterSourceItem> getBookFilterSource() const;
+
+    // Повнотекстовий пошук за назвою, авторами, жанром і описом (search.sql) за спаданням релевантності.
+    // queryText у форматі websearch_to_tsquery: слова, "фраза", -виключення, or.
+    BookSearchPage searchBooks(const QString &queryText, int limit = 20, int offset = 0) const;
+
     BookDetailsInfo getBookDetails(int bookId) const;
 
     QList<CommentDisplayInfo> getBookComments(int bookId) const;
 
     BookDisplayInfo getBookDisplayInfoById(int bookId) const;
+    // Один запит для кількох книг; у мапі лише знайдені книги
+    QMap<int, BookDisplayInfo> getBookDisplayInfoByIds(const QList<int> &bookIds) const;
 
     double createOrder(int customerId, const QMap<int, int> &items, const QString &shippingAddress, const QString &paymentMethod, int &newOrderId);
 
@@ -88,16 +152,105 @@ public:
 
     QList<BookDisplayInfo> getFilteredBooksForDisplay(const BookFilterCriteria &criteria) const;
 
+    // Посторінкове завантаження за ключем (keyset): вартість сторінки не залежить від її номера.
+    // pageToken - значення BookPage::nextPageToken попередньої сторінки (порожній для першої).
+    BookPage getFilteredBooksPage(const BookFilterCriteria &criteria, BookSortOrder sortOrder,
+                                  int pageSize, const QString &pageToken = QString()) const;
+    BookPage getAllBooksPage(BookSortOrder sortOrder, int pageSize, const QString &pageToken = QString()) const;
+
     QStringList getAllGenres() const;
     QStringList getAllLanguages() const;
+    // Кількість книг для кожного значення фільтрів панелі - один запит замість DISTINCT-сканів
+    BookFacetCounts getBookFacetCounts(const BookFilterCriteria &criteria) const;
 
     QMap<int, int> getCartItems(int customerId) const;
     bool addOrUpdateCartItem(int customerId, int bookId, int quantity);
     bool removeCartItem(int customerId, int bookId);
     bool clearCart(int customerId);
 
+    // --- Асинхронні варіанти (виконуються на робочих потоках з власними з'єднаннями пулу) ---
+    // Продовження, додані через QFuture::then(context, ...), виконуються в потоці context (напр. GUI).
+    QFuture<QList<BookDisplayInfo>> getAllBooksForDisplayAsync(int limit = -1, int offset = 0) const;
+    QFuture<int> getTotalBookCountAsync() const;
+    QFuture<QList<BookDisplayInfo>> getBooksByGenreAsync(const QString &genre, int limit = 10) const;
+    QFuture<QList<AuthorDisplayInfo>> getAllAuthorsForDisplayAsync() const;
+    QFuture<CustomerLoginInfo> getCustomerLoginInfoAsync(const QString &email) const;
+    QFuture<CustomerProfileInfo> getCustomerProfileInfoAsync(int customerId) const;
+    QFuture<QList<OrderDisplayInfo>> getCustomerOrdersForDisplayAsync(int customerId) const;
+    // cancelToken->cancel() перериває запит на сервері, якщо той ще виконується
+    QFuture<QList<SearchSuggestionInfo>> getSearchSuggestionsAsync(const QString &prefix, int limit = 10,
+                                                                   std::shared_ptr<QueryCancelToken> cancelToken = nullptr) const;
+    QFuture<QList<SuggestionSourceItem>> getSuggestionSourceAsync(int afterBookId = 0, int afterAuthorId = 0) const;
+    QFuture<QList<BookFilterSourceItem>> getBookFilterSourceAsync() const;
+    QFuture<BookSearchPage> searchBooksAsync(const QString &queryText, int limit = 20, int offset = 0) const;
+    QFuture<BookDetailsInfo> getBookDetailsAsync(int bookId) const;
+    QFuture<QList<CommentDisplayInfo>> getBookCommentsAsync(int bookId) const;
+    QFuture<BookDisplayInfo> getBookDisplayInfoByIdAsync(int bookId) const;
+    QFuture<QMap<int, BookDisplayInfo>> getBookDisplayInfoByIdsAsync(const QList<int> &bookIds) const;
+    QFuture<bool> hasUserCommentedOnBookAsync(int bookId, int customerId) const;
+    QFuture<OrderDisplayInfo> getOrderDetailsByIdAsync(int orderId) const;
+    QFuture<AuthorDetailsInfo> getAuthorDetailsAsync(int authorId) const;
+    QFuture<QList<BookDisplayInfo>> getSimilarBooksAsync(int currentBookId, const QString &genre, int limit = 5) const;
+    QFuture<QList<BookDisplayInfo>> getFilteredBooksForDisplayAsync(const BookFilterCriteria &criteria) const;
+    QFuture<BookPage> getFilteredBooksPageAsync(const BookFilterCriteria &criteria, BookSortOrder sortOrder,
+                                                int pageSize, const QString &pageToken = QString()) const;
+    QFuture<BookPage> getAllBooksPageAsync(BookSortOrder sortOrder, int pageSize, const QString &pageToken = QString()) const;
+    QFuture<QStringList> getAllGenresAsync() const;
+    QFuture<QStringList> getAllLanguagesAsync() const;
+    QFuture<BookFacetCounts> getBookFacetCountsAsync(const BookFilterCriteria &criteria) const;
+    QFuture<QMap<int, int>> getCartItemsAsync(int customerId) const;
+
+    // Пакетне завантаження через BookDisplayInfoLoader: запити однієї ітерації циклу подій
+    // об'єднуються в один GetBookDisplayInfoByIds. Викликати лише з потоку DatabaseManager.
+    QFuture<BookDisplayInfo> loadBookDisplayInfo(int bookId);
+    QFuture<QMap<int, BookDisplayInfo>> loadBookDisplayInfos(const QList<int> &bookIds);
+
+    // Виконує довільну функцію на робочому потоці. Усередині fn методи DatabaseManager
+    // використовують з'єднання, орендоване з пулу для цього потоку.
+    template <typename Fn>
+    QFuture<std::invoke_result_t<Fn>> runAsync(Fn fn) const
+    {
+        return QtConcurrent::run(m_workerPool.get(), [this, fn = std::move(fn)]() {
+            ThreadConnectionScope scope(this);
+            return fn();
+        });
+    }
+
     bool isConnected() const;
     QSqlDatabase& database();
+
+    // Пул з'єднань для робочих потоків (створюється в connectToDatabase).
+    // З'єднання пулу орендують лише потоки m_workerPool (runAsync): потоків не більше, ніж
+    // з'єднань, тож кожен має своє. Інший пул потоків займав би з'єднання, які звільняються
+    // лише із завершенням його потоків.
+    ConnectionPool *connectionPool() const;
+    void setConnectionPoolLimits(int minSize, int maxSize);
+    // З'єднання, орендоване для поточного потоку всередині runAsync; недійсне поза ним
+    QSqlDatabase workerConnection() const;
+
+    StatementCacheStats statementCacheStats() const;
+
+    // Кеш результатів читання (жанри, мови, книги за жанром, автори). TTL і бюджет пам'яті
+    // налаштовуються через queryResultCache(); записи інвалідуються за версіями таблиць.
+    QueryResultCache &queryResultCache() const;
+    QueryCacheStats queryCacheStats() const;
+
+    // Гістограми часу підготовки/виконання/розбору та кількості рядків для кожного іменованого запиту
+    QueryStatsRegistry &queryStatsRegistry() const;
+    QList<NamedQueryStats> queryStats() const;
+    bool dumpQueryStats(const QString &filePath) const;   // JSON
+    // План запиту з sql/*.sql: EXPLAIN (FORMAT JSON) з параметрами в порядку SqlParam::<Запит>.
+    // Порожній масив при помилці. Використовує bookstore_bench --explain-check.
+    // Значення підставляються літералами, тож це custom plan для цих значень; закешований
+    // підготовлений запит після 5 виконань може перейти на generic plan, який тут не видно.
+    QJsonArray explainQuery(SqlQueryId id, const QVariantList &params) const;
+    // Те саме для сторінки getFilteredBooksPage (текст GetBooksPageBase для фільтра, порядку й токена)
+    QJsonArray explainBooksPage(const BookFilterCriteria &criteria, BookSortOrder sortOrder,
+                                int pageSize, const QString &pageToken = QString()) const;
+    // План тіла SQL-функції (LANGUAGE sql) з аргументами args і її SET-налаштуваннями:
+    // функцію з SET планувальник не вбудовує, і EXPLAIN її виклику показує лише Function Scan
+    QJsonArray explainSqlFunction(const QString &functionName, const QVariantList &args) const;
+
     QSqlDatabase m_db;
     bool m_isConnected = false;
 
@@ -107,11 +260,91 @@ public:
     bool executeInsertQuery(QSqlQuery &query, const QString &description, QVariant &insertedId);
 
 private:
-    bool loadSqlQueries(const QString& directory = "sql");
-    bool parseSqlFile(const QString& filePath);
-    QString getSqlQuery(const QString& queryName) const;
-
-    QMap<QString, QString> m_sqlQueries;
+    // Прив'язує орендоване з пулу з'єднання до поточного потоку на час свого життя.
+    // Вкладені області в тому ж потоці використовують уже прив'язане з'єднання.
+    class ThreadConnectionScope
+    {
+    public:
+        explicit ThreadConnectionScope(const DatabaseManager *manager);
+        ~ThreadConnectionScope();
+    private:
+        PooledConnection m_lease;
+        bool m_active = false;
+    };
+
+    // З'єднання для поточного потоку: m_db у потоці GUI або орендоване в робочому потоці
+    QSqlDatabase connection() const;
+
+    // Текст запиту з sql/*.sql, вбудований під час збирання (sqlregistry.h), з іменованими
+    // параметрами :name - для запитів, які доповнюються в коді
+    static const QString &getSqlQuery(SqlQueryId id);
+
+    // Запит із кешу підготовлених на час одного виконання. Сам QSqlQuery належить кешу і живе,
+    // доки з'єднання відкрите; при виході з області finish() звільняє результат (PGresult),
+    // тож повні вибірки на кшталт GetBookFilterSource не лишаються в пам'яті кожного з'єднання.
+    class CachedStatement
+    {
+    public:
+        CachedStatement(QSqlQuery *query = nullptr) : m_query(query) {}
+        ~CachedStatement()
+        {
+            if (m_query) m_query->finish();
+        }
+        CachedStatement(CachedStatement &&other) noexcept : m_query(std::exchange(other.m_query, nullptr)) {}
+        CachedStatement(const CachedStatement &) = delete;
+        CachedStatement &operator=(const CachedStatement &) = delete;
+        CachedStatement &operator=(CachedStatement &&) = delete;
+
+        explicit operator bool() const { return m_query != nullptr; }
+        QSqlQuery *operator->() const { return m_query; }
+        QSqlQuery &operator*() const { return *m_query; }
+
+    private:
+        QSqlQuery *m_query;
+    };
+
+    // Повертає підготовлений на сервері запит із кешу з'єднання db (готує його при першому зверненні).
+    // Параметри переписані на $1..$n: значення прив'язуються через bindValue(SqlParam::<Запит>::<ім'я>, ...).
+    // Порожній CachedStatement при помилці.
+    CachedStatement preparedQuery(SqlQueryId id, const QSqlDatabase &db) const;
+    // Те саме для SQL, зібраного в коді; cacheKey має однозначно визначати текст запиту
+    CachedStatement preparedQuery(const QString &cacheKey, const QString &sql, const QSqlDatabase &db) const;
+    void clearStatementCache(const QString &connectionName) const;
+
+    // Запасний варіант getSearchSuggestions: схожі за триграмами назви та імена (pg_trgm)
+    QList<SearchSuggestionInfo> getFuzzySearchSuggestions(const QString &text, int limit, const QSqlDatabase &db) const;
+
+    // EXPLAIN для SQL, зібраного в коді: іменовані параметри підставляються літералами
+    QJsonArray explainSql(const QString &name, const QString &sql, const QMap<QString, QVariant> &bindValues) const;
+
+    // Версії таблиць з послідовностей table_version_<таблиця> (для QueryResultCache); порожня мапа при помилці
+    QHash<QString, qint64> fetchServerTableVersions() const;
+
+    ConnectionPool *m_pool = nullptr;
+    int m_poolMinSize = 1;
+    int m_poolMaxSize = 8;
+    // Пул потоків перестворюється в closeConnection(): лише знищення QThreadPool завершує його
+    // потоки, а з'єднання пулу закриваються в потоці-власнику, коли той завершується
+    std::unique_ptr<QThreadPool> m_workerPool;
+    void resetWorkerPool();
+    BookDisplayInfoLoader *m_bookLoader = nullptr;
+
+    // Кеш підготовлених запитів: ім'я з'єднання -> (ім'я запиту -> запит).
+    // Кожне з'єднання використовується лише одним потоком, м'ютекс захищає самі мапи.
+    mutable QMutex m_statementCacheMutex;
+    mutable QHash<QString, QHash<QString, QSqlQuery*>> m_statementCache;
+    mutable quint64 m_statementCacheHits = 0;
+    mutable quint64 m_statementCacheMisses = 0;
+
+    mutable QueryResultCache m_resultCache;
+    mutable QueryStatsRegistry m_queryStats;
+
+    // Звірка версій кешу з сервером: таймер у потоці DatabaseManager, сам запит - на
+    // робочому потоці, тож потік GUI не чекає мережі навіть під час промаху кешу
+    static constexpr int ServerVersionCheckIntervalMs = 2000;
+    QTimer *m_versionCheckTimer = nullptr;
+    QFuture<void> m_versionCheck;
+    void scheduleServerVersionCheck();
 };
 
 #endif // DATABASE_H
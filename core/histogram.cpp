@@ -0,0 +1,83 @@
+#include "histogram.h"
+#include <QtAlgorithms>
+#include <QtMath>
+
+int HdrHistogram::indexFor(qint64 value)
+{
+    if (value < SubBucketCount) {
+        return static_cast<int>(qMax<qint64>(0, value));
+    }
+    // Зсуваємо так, щоб лишилося 7 старших бітів (значення 64..127)
+    int msb = 63 - qCountLeadingZeroBits(static_cast<quint64>(value));
+    int shift = msb - (SubBucketBits - 1);
+    if (shift > MaxShift) {
+        return BucketCount - 1;
+    }
+    const int sub = static_cast<int>(value >> shift);
+    return SubBucketCount + (shift - 1) * SubBucketHalf + (sub - SubBucketHalf);
+}
+
+qint64 HdrHistogram::highestValueAt(int index)
+{
+    if (index < SubBucketCount) {
+        return index;
+    }
+    const int k = index - SubBucketCount;
+    const int shift = k / SubBucketHalf + 1;
+    const qint64 sub = k % SubBucketHalf + SubBucketHalf;
+    return ((sub + 1) << shift) - 1;
+}
+
+void HdrHistogram::record(qint64 value)
+{
+    if (m_counts.isEmpty()) {
+        m_counts.fill(0, BucketCount);
+    }
+    value = qMax<qint64>(0, value);
+    ++m_counts[indexFor(value)];
+    if (m_count == 0 || value < m_min) m_min = value;
+    if (m_count == 0 || value > m_max) m_max = value;
+    ++m_count;
+    m_sum += static_cast<double>(value);
+}
+
+void HdrHistogram::reset()
+{
+    m_counts.clear();
+    m_count = 0;
+    m_min = 0;
+    m_max = 0;
+    m_sum = 0.0;
+}
+
+qint64 HdrHistogram::valueAtPercentile(double percentile) const
+{
+    if (m_count == 0) {
+        return 0;
+    }
+    const quint64 target = qMax<quint64>(1, static_cast<quint64>(qCeil(qBound(0.0, percentile, 100.0) / 100.0 * m_count)));
+    quint64 seen = 0;
+    for (int i = 0; i < m_counts.size(); ++i) {
+        seen += m_counts.at(i);
+        if (seen >= target) {
+            return qMin(highestValueAt(i), m_max);
+        }
+    }
+    return m_max;
+}
+
+HistogramSummary HdrHistogram::summary() const
+{
+    HistogramSummary summary;
+    summary.count = m_count;
+    if (m_count == 0) {
+        return summary;
+    }
+    summary.min = m_min;
+    summary.max = m_max;
+    summary.mean = m_sum / static_cast<double>(m_count);
+    summary.p50 = valueAtPercentile(50.0);
+    summary.p95 = valueAtPercentile(95.0);
+    summary.p99 = valueAtPercentile(99.0);
+    return summary;
+}
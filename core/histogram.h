@@ -0,0 +1,48 @@
+#ifndef HISTOGRAM_H
+#define HISTOGRAM_H
+
+#include <QtGlobal>
+#include <QVector>
+
+// Зведення розподілу: перцентилі повертаються як верхня межа свого кошика
+struct HistogramSummary {
+    quint64 count = 0;
+    qint64 min = 0;
+    qint64 max = 0;
+    double mean = 0.0;
+    qint64 p50 = 0;
+    qint64 p95 = 0;
+    qint64 p99 = 0;
+};
+
+// Гістограма в стилі HdrHistogram: лог-лінійні кошики з 7 значущими бітами
+// (відносна похибка < 1.6%) для цілих значень 0..2^37. Запис - O(1) без алокацій
+// (пам'ять виділяється при першому записі). Не потокобезпечна.
+class HdrHistogram
+{
+public:
+    void record(qint64 value);
+    void reset();
+
+    quint64 count() const { return m_count; }
+    qint64 valueAtPercentile(double percentile) const;
+    HistogramSummary summary() const;
+
+private:
+    static constexpr int SubBucketBits = 7;
+    static constexpr int SubBucketCount = 1 << SubBucketBits;        // 128
+    static constexpr int SubBucketHalf = SubBucketCount / 2;         // 64
+    static constexpr int MaxShift = 30;
+    static constexpr int BucketCount = SubBucketCount + MaxShift * SubBucketHalf;
+
+    static int indexFor(qint64 value);
+    static qint64 highestValueAt(int index);
+
+    QVector<quint32> m_counts;
+    quint64 m_count = 0;
+    qint64 m_min = 0;
+    qint64 m_max = 0;
+    double m_sum = 0.0;
+};
+
+#endif // HISTOGRAM_H
@@ -0,0 +1,279 @@
+#include "logging.h"
+#include <QByteArray>
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QMutex>
+#include <QString>
+#include <QThread>
+#include <QWaitCondition>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <utility>
+
+#ifdef QT_NO_DEBUG
+#define BOOKSTORE_LOG_DEFAULT_LEVEL QtWarningMsg
+#else
+#define BOOKSTORE_LOG_DEFAULT_LEVEL QtDebugMsg
+#endif
+
+Q_LOGGING_CATEGORY(lcDbConnection, "bookstore.db.connection", BOOKSTORE_LOG_DEFAULT_LEVEL)
+Q_LOGGING_CATEGORY(lcDbBook, "bookstore.db.book", BOOKSTORE_LOG_DEFAULT_LEVEL)
+Q_LOGGING_CATEGORY(lcDbAuthor, "bookstore.db.author", BOOKSTORE_LOG_DEFAULT_LEVEL)
+Q_LOGGING_CATEGORY(lcDbCustomer, "bookstore.db.customer", BOOKSTORE_LOG_DEFAULT_LEVEL)
+Q_LOGGING_CATEGORY(lcDbOrder, "bookstore.db.order", BOOKSTORE_LOG_DEFAULT_LEVEL)
+Q_LOGGING_CATEGORY(lcDbComment, "bookstore.db.comment", BOOKSTORE_LOG_DEFAULT_LEVEL)
+Q_LOGGING_CATEGORY(lcDbCart, "bookstore.db.cart", BOOKSTORE_LOG_DEFAULT_LEVEL)
+Q_LOGGING_CATEGORY(lcDbPool, "bookstore.db.pool", BOOKSTORE_LOG_DEFAULT_LEVEL)
+Q_LOGGING_CATEGORY(lcDbCache, "bookstore.db.cache", BOOKSTORE_LOG_DEFAULT_LEVEL)
+Q_LOGGING_CATEGORY(lcDbSeed, "bookstore.db.seed", BOOKSTORE_LOG_DEFAULT_LEVEL)
+
+namespace {
+
+struct LogRecord {
+    QtMsgType type = QtDebugMsg;
+    const char *category = nullptr;   // Імена категорій Q_LOGGING_CATEGORY статичні
+    qint64 timestampMs = 0;
+    QString message;
+};
+
+// Обмежена MPMC-черга на послідовностях комірок (схема Д. В'юкова).
+// Виробники (будь-які потоки) не блокуються: якщо буфер повний, запис відкидається.
+class LogRingBuffer
+{
+public:
+    explicit LogRingBuffer(int capacity)
+    {
+        size_t size = 2;
+        while (size < static_cast<size_t>(qMax(2, capacity))) size <<= 1;
+        m_mask = size - 1;
+        m_cells = std::make_unique<Cell[]>(size);
+        for (size_t i = 0; i < size; ++i) {
+            m_cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    bool tryPush(LogRecord &&record)
+    {
+        size_t pos = m_enqueuePos.load(std::memory_order_relaxed);
+        Cell *cell;
+        while (true) {
+            cell = &m_cells[pos & m_mask];
+            const size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            const intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+            if (diff == 0) {
+                if (m_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = m_enqueuePos.load(std::memory_order_relaxed);
+            }
+        }
+        cell->record = std::move(record);
+        cell->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool tryPop(LogRecord &record)
+    {
+        size_t pos = m_dequeuePos.load(std::memory_order_relaxed);
+        Cell *cell;
+        while (true) {
+            cell = &m_cells[pos & m_mask];
+            const size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            const intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos + 1);
+            if (diff == 0) {
+                if (m_dequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = m_dequeuePos.load(std::memory_order_relaxed);
+            }
+        }
+        record = std::move(cell->record);
+        cell->sequence.store(pos + m_mask + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Лише для споживача: чи є запис, який поверне наступний tryPop()
+    bool isEmpty() const
+    {
+        const size_t pos = m_dequeuePos.load(std::memory_order_relaxed);
+        const size_t sequence = m_cells[pos & m_mask].sequence.load(std::memory_order_acquire);
+        return sequence != pos + 1;
+    }
+
+private:
+    struct Cell {
+        std::atomic<size_t> sequence{0};
+        LogRecord record;
+    };
+
+    std::unique_ptr<Cell[]> m_cells;
+    size_t m_mask = 0;
+    alignas(64) std::atomic<size_t> m_enqueuePos{0};
+    alignas(64) std::atomic<size_t> m_dequeuePos{0};
+};
+
+struct AsyncLogState {
+    explicit AsyncLogState(int capacity) : buffer(capacity) {}
+
+    LogRingBuffer buffer;
+    std::atomic<bool> running{true};
+    std::atomic<quint64> dropped{0};
+    // Порожній буфер: потік запису спить на wake, доки виробник не покладе запис
+    QMutex wakeMutex;
+    QWaitCondition wake;
+    std::atomic<bool> writerWaiting{false};
+    QThread *writer = nullptr;
+    QtMessageHandler previousHandler = nullptr;
+};
+
+// Стан не видаляється: обробник може ще виконуватися в іншому потоці під час зупинки
+std::atomic<AsyncLogState *> g_state{nullptr};
+
+char levelLetter(QtMsgType type)
+{
+    switch (type) {
+    case QtDebugMsg: return 'D';
+    case QtInfoMsg: return 'I';
+    case QtWarningMsg: return 'W';
+    case QtCriticalMsg: return 'C';
+    case QtFatalMsg: return 'F';
+    }
+    return '?';
+}
+
+void appendFormatted(QByteArray &out, const LogRecord &record)
+{
+    out += QDateTime::fromMSecsSinceEpoch(record.timestampMs).toString("HH:mm:ss.zzz").toLatin1();
+    out += ' ';
+    out += levelLetter(record.type);
+    out += ' ';
+    out += record.category ? record.category : "default";
+    out += ": ";
+    out += record.message.toLocal8Bit();
+    out += '\n';
+}
+
+void writeSynchronously(const LogRecord &record)
+{
+    QByteArray line;
+    appendFormatted(line, record);
+    std::fwrite(line.constData(), 1, static_cast<size_t>(line.size()), stderr);
+    std::fflush(stderr);
+}
+
+// Будить потік запису, якщо той чекає. Поки він працює, виробник не бере м'ютекс
+void wakeWriter(AsyncLogState *state)
+{
+    // Пара до fence у waitForRecords: або виробник бачить writerWaiting, або потік запису - новий запис
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (state->writerWaiting.load(std::memory_order_relaxed)) {
+        QMutexLocker locker(&state->wakeMutex);
+        state->wake.wakeOne();
+    }
+}
+
+void waitForRecords(AsyncLogState *state)
+{
+    QMutexLocker locker(&state->wakeMutex);
+    state->writerWaiting.store(true, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    // М'ютекс тримається від перевірки до wait(), тож пробудження між ними не загубиться
+    if (state->buffer.isEmpty() && state->running.load(std::memory_order_acquire)) {
+        state->wake.wait(&state->wakeMutex);
+    }
+    state->writerWaiting.store(false, std::memory_order_relaxed);
+}
+
+// Повертає кількість записаних повідомлень
+int drain(AsyncLogState *state)
+{
+    QByteArray batch;
+    LogRecord record;
+    int count = 0;
+    while (state->buffer.tryPop(record)) {
+        appendFormatted(batch, record);
+        ++count;
+    }
+    const quint64 dropped = state->dropped.exchange(0, std::memory_order_relaxed);
+    if (dropped > 0) {
+        batch += "logging: буфер переповнено, відкинуто " + QByteArray::number(dropped) + " повідомлень\n";
+    }
+    if (!batch.isEmpty()) {
+        std::fwrite(batch.constData(), 1, static_cast<size_t>(batch.size()), stderr);
+        std::fflush(stderr);
+    }
+    return count;
+}
+
+void asyncMessageHandler(QtMsgType type, const QMessageLogContext &context, const QString &message)
+{
+    LogRecord record;
+    record.type = type;
+    record.category = context.category;
+    record.timestampMs = QDateTime::currentMSecsSinceEpoch();
+    record.message = message;
+
+    AsyncLogState *state = g_state.load(std::memory_order_acquire);
+    // Після qFatal процес завершується, тож таке повідомлення пишемо одразу
+    if (!state || type == QtFatalMsg || !state->running.load(std::memory_order_relaxed)) {
+        writeSynchronously(record);
+        return;
+    }
+    if (!state->buffer.tryPush(std::move(record))) {
+        state->dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    wakeWriter(state);
+}
+
+} // namespace
+
+namespace Logging {
+
+void installAsyncHandler(int bufferCapacity)
+{
+    if (g_state.load(std::memory_order_acquire)) {
+        return;
+    }
+
+    auto *state = new AsyncLogState(bufferCapacity);
+    state->writer = QThread::create([state]() {
+        // Без опитування: порожній буфер - сон до першого запису або до зупинки
+        while (state->running.load(std::memory_order_acquire)) {
+            if (drain(state) == 0) {
+                waitForRecords(state);
+            }
+        }
+        drain(state);
+    });
+    state->writer->setObjectName("LogWriter");
+    state->writer->start(QThread::LowPriority);
+
+    g_state.store(state, std::memory_order_release);
+    state->previousHandler = qInstallMessageHandler(asyncMessageHandler);
+    qAddPostRoutine(shutdownAsyncHandler);
+}
+
+void shutdownAsyncHandler()
+{
+    AsyncLogState *state = g_state.load(std::memory_order_acquire);
+    if (!state || !state->writer) {
+        return;
+    }
+
+    qInstallMessageHandler(state->previousHandler);
+    {
+        QMutexLocker locker(&state->wakeMutex);
+        state->running.store(false, std::memory_order_release);
+        state->wake.wakeOne();
+    }
+    state->writer->wait();
+    delete state->writer;
+    state->writer = nullptr;
+}
+
+} // namespace Logging
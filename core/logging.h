@@ -0,0 +1,33 @@
+#ifndef LOGGING_H
+#define LOGGING_H
+
+#include <QLoggingCategory>
+
+// Категорії журналу шару доступу до даних. Макроси qCDebug/qCInfo/... перевіряють рівень
+// категорії ДО обчислення аргументів, тож вимкнений рівень не форматує нічого.
+// У релізній збірці (QT_NO_DEBUG) за замовчуванням увімкнено лише warning і вище;
+// увімкнути детальніше можна правилами, напр.: QT_LOGGING_RULES="bookstore.db.book.info=true".
+Q_DECLARE_LOGGING_CATEGORY(lcDbConnection)
+Q_DECLARE_LOGGING_CATEGORY(lcDbBook)
+Q_DECLARE_LOGGING_CATEGORY(lcDbAuthor)
+Q_DECLARE_LOGGING_CATEGORY(lcDbCustomer)
+Q_DECLARE_LOGGING_CATEGORY(lcDbOrder)
+Q_DECLARE_LOGGING_CATEGORY(lcDbComment)
+Q_DECLARE_LOGGING_CATEGORY(lcDbCart)
+Q_DECLARE_LOGGING_CATEGORY(lcDbPool)
+Q_DECLARE_LOGGING_CATEGORY(lcDbCache)
+Q_DECLARE_LOGGING_CATEGORY(lcDbSeed)
+
+namespace Logging {
+
+// Встановлює обробник повідомлень Qt, що кладе рядки в lock-free кільцевий буфер,
+// і запускає фоновий потік, який пише їх у stderr. Викликати один раз на початку main().
+void installAsyncHandler(int bufferCapacity = 4096);
+
+// Дописує все, що лишилося в буфері, зупиняє потік і повертає попередній обробник.
+// Реєструється як post routine QCoreApplication, але може викликатися й вручну.
+void shutdownAsyncHandler();
+
+} // namespace Logging
+
+#endif // LOGGING_H
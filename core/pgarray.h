@@ -0,0 +1,32 @@
+#ifndef PGARRAY_H
+#define PGARRAY_H
+
+#include <QString>
+#include <QStringList>
+#include <QList>
+
+// Літерали масивів PostgreSQL для прив'язки одним параметром: CAST(:param AS INT[]) / CAST(:param AS TEXT[]).
+// Так текст запиту не залежить від кількості елементів і запит можна тримати підготовленим.
+
+inline QString toPgIntArray(const QList<int> &values)
+{
+    QStringList parts;
+    parts.reserve(values.size());
+    for (int value : values) {
+        parts << QString::number(value);
+    }
+    return "{" + parts.join(",") + "}";
+}
+
+inline QString toPgTextArray(const QStringList &values)
+{
+    QStringList quoted;
+    quoted.reserve(values.size());
+    for (QString value : values) {
+        value.replace("\\", "\\\\").replace("\"", "\\\"");
+        quoted << "\"" + value + "\"";
+    }
+    return "{" + quoted.join(",") + "}";
+}
+
+#endif // PGARRAY_H
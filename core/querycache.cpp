@@ -0,0 +1,190 @@
+#include "querycache.h"
+#include "logging.h"
+#include <QDebug>
+#include <QMutexLocker>
+
+QueryResultCache::QueryResultCache()
+{
+    m_entries.setMaxCost(16 * 1024 * 1024);
+}
+
+QString QueryResultCache::makeKey(const QString &queryName, const QVariantList &params)
+{
+    QString key = queryName;
+    for (const QVariant &param : params) {
+        // Тип входить у ключ, щоб 1 і "1" не збігалися
+        key += QLatin1Char('|') + QString::number(param.typeId()) + QLatin1Char(':') + param.toString();
+    }
+    return key;
+}
+
+QueryCacheKey QueryResultCache::prepare(const QString &queryName, const QVariantList &params, const QStringList &tables)
+{
+    // Лише локальні лічильники: версії з сервера оновлює refreshServerVersions() на робочому потоці
+    QueryCacheKey cacheKey;
+    cacheKey.key = makeKey(queryName, params);
+    cacheKey.queryName = queryName;
+    cacheKey.tables = tables;
+
+    QMutexLocker locker(&m_mutex);
+    cacheKey.versionStamp = versionStampLocked(tables);
+    return cacheKey;
+}
+
+const QueryResultCache::Entry *QueryResultCache::findLocked(const QueryCacheKey &cacheKey)
+{
+    if (!m_enabled) {
+        ++m_misses;
+        return nullptr;
+    }
+
+    Entry *entry = m_entries.object(cacheKey.key);
+    if (!entry) {
+        ++m_misses;
+        return nullptr;
+    }
+    if (entry->versionStamp != versionStampLocked(entry->tables)) {
+        m_entries.remove(cacheKey.key);
+        ++m_staleDrops;
+        ++m_misses;
+        return nullptr;
+    }
+    if (entry->expiry.hasExpired()) {
+        m_entries.remove(cacheKey.key);
+        ++m_expiredDrops;
+        ++m_misses;
+        return nullptr;
+    }
+    return entry;
+}
+
+void QueryResultCache::insertAny(const QueryCacheKey &cacheKey, std::any value, qint64 cost)
+{
+    QMutexLocker locker(&m_mutex);
+    const int ttlMs = ttlLocked(cacheKey.queryName);
+    if (!m_enabled || ttlMs <= 0) {
+        return;
+    }
+    // Таблицю змінили, поки виконувався запит - результат може бути застарілим
+    if (cacheKey.versionStamp != versionStampLocked(cacheKey.tables)) {
+        return;
+    }
+
+    auto *entry = new Entry;
+    entry->value = std::move(value);
+    entry->tables = cacheKey.tables;
+    entry->versionStamp = cacheKey.versionStamp;
+    entry->expiry = QDeadlineTimer(ttlMs);
+    // Запис, більший за весь бюджет, QCache одразу видаляє
+    m_entries.insert(cacheKey.key, entry, qMax<qint64>(1, cost));
+}
+
+void QueryResultCache::bumpTables(const QStringList &tables)
+{
+    QMutexLocker locker(&m_mutex);
+    for (const QString &table : tables) {
+        ++m_tableVersions[table];
+    }
+}
+
+void QueryResultCache::clear()
+{
+    QMutexLocker locker(&m_mutex);
+    m_entries.clear();
+    m_serverVersions.clear();
+}
+
+void QueryResultCache::setEnabled(bool enabled)
+{
+    QMutexLocker locker(&m_mutex);
+    m_enabled = enabled;
+    if (!enabled) {
+        m_entries.clear();
+    }
+}
+
+void QueryResultCache::setDefaultTtl(int ttlMs)
+{
+    QMutexLocker locker(&m_mutex);
+    m_defaultTtlMs = ttlMs;
+}
+
+void QueryResultCache::setTtl(const QString &queryName, int ttlMs)
+{
+    QMutexLocker locker(&m_mutex);
+    m_ttls.insert(queryName, ttlMs);
+}
+
+void QueryResultCache::setMaxMemory(qint64 bytes)
+{
+    QMutexLocker locker(&m_mutex);
+    m_entries.setMaxCost(bytes);
+}
+
+void QueryResultCache::setServerVersionProvider(ServerVersionProvider provider)
+{
+    QMutexLocker locker(&m_mutex);
+    m_serverVersionProvider = std::move(provider);
+}
+
+bool QueryResultCache::isEnabled() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_enabled;
+}
+
+QueryCacheStats QueryResultCache::stats() const
+{
+    QMutexLocker locker(&m_mutex);
+    QueryCacheStats stats;
+    stats.hits = m_hits;
+    stats.misses = m_misses;
+    stats.staleDrops = m_staleDrops;
+    stats.expiredDrops = m_expiredDrops;
+    stats.entries = m_entries.count();
+    stats.memoryBytes = m_entries.totalCost();
+    stats.maxMemoryBytes = m_entries.maxCost();
+    return stats;
+}
+
+void QueryResultCache::refreshServerVersions()
+{
+    ServerVersionProvider provider;
+    {
+        QMutexLocker locker(&m_mutex);
+        if (!m_serverVersionProvider || m_serverCheckRunning) {
+            return;
+        }
+        m_serverCheckRunning = true;
+        provider = m_serverVersionProvider;
+    }
+
+    // Запит до сервера - поза м'ютексом, інші потоки тим часом читають кеш
+    const QHash<QString, qint64> serverVersions = provider();
+
+    QMutexLocker locker(&m_mutex);
+    m_serverCheckRunning = false;
+    for (auto it = serverVersions.constBegin(); it != serverVersions.constEnd(); ++it) {
+        auto known = m_serverVersions.constFind(it.key());
+        if (known != m_serverVersions.constEnd() && known.value() != it.value()) {
+            qCDebug(lcDbCache) << "QueryResultCache: таблицю" << it.key() << "змінено на сервері, версія" << it.value();
+            ++m_tableVersions[it.key()];
+        }
+        m_serverVersions.insert(it.key(), it.value());
+    }
+}
+
+quint64 QueryResultCache::versionStampLocked(const QStringList &tables) const
+{
+    // Лічильники лише зростають, тож сума змінюється тоді й лише тоді, коли змінився хоч один
+    quint64 stamp = 0;
+    for (const QString &table : tables) {
+        stamp += m_tableVersions.value(table);
+    }
+    return stamp;
+}
+
+int QueryResultCache::ttlLocked(const QString &queryName) const
+{
+    return m_ttls.value(queryName, m_defaultTtlMs);
+}
@@ -0,0 +1,141 @@
+#ifndef QUERYCACHE_H
+#define QUERYCACHE_H
+
+#include <QCache>
+#include <QDeadlineTimer>
+#include <QHash>
+#include <QList>
+#include <QMutex>
+#include <QString>
+#include <QStringList>
+#include <QVariant>
+#include <any>
+#include <functional>
+
+// Статистика кешу результатів запитів
+struct QueryCacheStats {
+    quint64 hits = 0;
+    quint64 misses = 0;
+    quint64 staleDrops = 0;     // Відкинуто через зміну версії таблиці
+    quint64 expiredDrops = 0;   // Відкинуто через TTL
+    int entries = 0;
+    qint64 memoryBytes = 0;     // Оцінка пам'яті результатів (сума cost)
+    qint64 maxMemoryBytes = 0;
+
+    double hitRate() const { return hits + misses > 0 ? double(hits) / double(hits + misses) : 0.0; }
+};
+
+// Ключ запису: ім'я запиту + параметри, таблиці, від яких залежить результат,
+// і знімок їхніх версій на момент перед виконанням запиту
+struct QueryCacheKey {
+    QString key;
+    QString queryName;
+    QStringList tables;
+    quint64 versionStamp = 0;
+};
+
+// Приблизна кількість байтів результату - використовується як cost у QCache.
+// Для власних типів оголошуйте перевантаження queryCacheCost поруч із типом.
+inline qint64 queryCacheCost(const QString &value) { return qint64(sizeof(QString)) + value.size() * qint64(sizeof(QChar)); }
+inline qint64 queryCacheCost(const QStringList &values)
+{
+    qint64 cost = sizeof(QStringList);
+    for (const QString &value : values) cost += queryCacheCost(value);
+    return cost;
+}
+template <typename T>
+qint64 queryCacheCost(const QList<T> &values)
+{
+    qint64 cost = sizeof(QList<T>);
+    for (const T &value : values) cost += queryCacheCost(value);
+    return cost;
+}
+
+// Кеш результатів читання для DatabaseManager. Запис живе до TTL свого запиту або доки
+// не зміниться версія однієї з його таблиць. Версії піднімаються локально після записів
+// (bumpTables) і періодично звіряються з послідовностями table_version_<таблиця> на сервері.
+// Потокобезпечний: викликається і з GUI, і з робочих потоків.
+class QueryResultCache
+{
+public:
+    // Повертає поточні версії таблиць із сервера; порожня мапа при помилці
+    using ServerVersionProvider = std::function<QHash<QString, qint64>()>;
+
+    QueryResultCache();
+
+    static QString makeKey(const QString &queryName, const QVariantList &params = QVariantList());
+
+    // Фіксує ключ і версії таблиць. Викликати до виконання запиту, щоб запис,
+    // зроблений паралельно з читанням, не потрапив у кеш як актуальний.
+    QueryCacheKey prepare(const QString &queryName, const QVariantList &params, const QStringList &tables);
+
+    template <typename T>
+    bool lookup(const QueryCacheKey &cacheKey, T *value)
+    {
+        QMutexLocker locker(&m_mutex);
+        const Entry *entry = findLocked(cacheKey);
+        if (!entry) {
+            return false;
+        }
+        const T *stored = std::any_cast<T>(&entry->value);
+        if (!stored) {
+            ++m_misses;
+            return false;
+        }
+        ++m_hits;
+        *value = *stored;
+        return true;
+    }
+
+    template <typename T>
+    void insert(const QueryCacheKey &cacheKey, const T &value)
+    {
+        insertAny(cacheKey, std::any(value), queryCacheCost(value));
+    }
+
+    void bumpTables(const QStringList &tables);
+    void clear();
+
+    void setEnabled(bool enabled);
+    void setDefaultTtl(int ttlMs);
+    void setTtl(const QString &queryName, int ttlMs);     // 0 - не кешувати цей запит
+    void setMaxMemory(qint64 bytes);
+    bool isEnabled() const;
+    void setServerVersionProvider(ServerVersionProvider provider);
+    // Звіряє версії з сервером через провайдера (мережевий запит) - викликати з робочого
+    // потоку; prepare() і lookup() лише читають уже отримані версії
+    void refreshServerVersions();
+
+    QueryCacheStats stats() const;
+
+private:
+    struct Entry {
+        std::any value;
+        QStringList tables;
+        quint64 versionStamp = 0;
+        QDeadlineTimer expiry;
+    };
+
+    const Entry *findLocked(const QueryCacheKey &cacheKey);
+    void insertAny(const QueryCacheKey &cacheKey, std::any value, qint64 cost);
+    quint64 versionStampLocked(const QStringList &tables) const;
+    int ttlLocked(const QString &queryName) const;
+
+    mutable QMutex m_mutex;
+    QCache<QString, Entry> m_entries;
+    QHash<QString, quint64> m_tableVersions;     // Локальні лічильники (лише зростають)
+    QHash<QString, qint64> m_serverVersions;     // Останні побачені версії з сервера
+    QHash<QString, int> m_ttls;
+    int m_defaultTtlMs = 5 * 60 * 1000;
+    bool m_enabled = true;
+
+    ServerVersionProvider m_serverVersionProvider;
+    bool m_serverCheckRunning = false;
+
+    quint64 m_hits = 0;
+    quint64 m_misses = 0;
+    quint64 m_staleDrops = 0;
+    quint64 m_expiredDrops = 0;
+};
+
+#endif // QUERYCACHE_H
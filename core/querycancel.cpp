@@ -0,0 +1,84 @@
+#include "querycancel.h"
+#include "logging.h"
+#include <QSqlDriver>
+#include <QVariant>
+#include <QDebug>
+
+#ifdef BOOKSTORE_HAVE_LIBPQ
+#include <libpq-fe.h>
+#endif
+
+QueryCancelToken::Scope::Scope(std::shared_ptr<QueryCancelToken> token, const QSqlDatabase &db)
+    : m_token(std::move(token))
+{
+    if (m_token) {
+        m_token->attach(db);
+    }
+}
+
+QueryCancelToken::Scope::~Scope()
+{
+    if (m_token) {
+        m_token->detach();
+    }
+}
+
+QueryCancelToken::~QueryCancelToken()
+{
+    detach();
+}
+
+void QueryCancelToken::attach(const QSqlDatabase &db)
+{
+#ifdef BOOKSTORE_HAVE_LIBPQ
+    QMutexLocker locker(&m_mutex);
+    if (m_cancelled || m_cancelHandle || !db.driver()) {
+        return;
+    }
+    const QVariant handle = db.driver()->handle();
+    if (qstrcmp(handle.typeName(), "PGconn*") == 0) {
+        PGconn *connection = *static_cast<PGconn *const *>(handle.constData());
+        if (connection) {
+            m_cancelHandle = PQgetCancel(connection);
+        }
+    }
+#else
+    Q_UNUSED(db);
+#endif
+}
+
+// Під м'ютексом: після повернення з detach() з'єднання може виконувати інший запит,
+// і запізнілий cancel() його вже не зачепить
+void QueryCancelToken::detach()
+{
+#ifdef BOOKSTORE_HAVE_LIBPQ
+    QMutexLocker locker(&m_mutex);
+    if (m_cancelHandle) {
+        PQfreeCancel(static_cast<PGcancel *>(m_cancelHandle));
+        m_cancelHandle = nullptr;
+    }
+#endif
+}
+
+void QueryCancelToken::cancel()
+{
+    QMutexLocker locker(&m_mutex);
+    if (m_cancelled) {
+        return;
+    }
+    m_cancelled = true;
+#ifdef BOOKSTORE_HAVE_LIBPQ
+    if (m_cancelHandle) {
+        char error[256] = {};
+        if (!PQcancel(static_cast<PGcancel *>(m_cancelHandle), error, sizeof(error))) {
+            qCWarning(lcDbConnection) << "Не вдалося скасувати запит на сервері:" << error;
+        }
+    }
+#endif
+}
+
+bool QueryCancelToken::isCancelled() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_cancelled;
+}
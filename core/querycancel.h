@@ -0,0 +1,47 @@
+#ifndef QUERYCANCEL_H
+#define QUERYCANCEL_H
+
+#include <QMutex>
+#include <QSqlDatabase>
+#include <memory>
+
+// Скасування запиту, що виконується на робочому потоці. Потік-виконавець прив'язує своє
+// з'єднання через Scope на час запиту; cancel() можна викликати з будь-якого потоку.
+//
+// З libpq (BOOKSTORE_HAVE_LIBPQ) cancel() надсилає серверу PQcancel, і запит завершується
+// помилкою 57014 (query_canceled). Без libpq токен лише позначається скасованим: запит
+// доробляє сервер, а виклик, що перевіряє isCancelled(), відкидає результат.
+//
+// cancel() відкриває окреме з'єднання з сервером, тому з потоку GUI його викликають асинхронно.
+class QueryCancelToken
+{
+public:
+    class Scope
+    {
+    public:
+        Scope(std::shared_ptr<QueryCancelToken> token, const QSqlDatabase &db);
+        ~Scope();
+        Scope(const Scope &) = delete;
+        Scope &operator=(const Scope &) = delete;
+    private:
+        std::shared_ptr<QueryCancelToken> m_token;
+    };
+
+    QueryCancelToken() = default;
+    ~QueryCancelToken();
+    QueryCancelToken(const QueryCancelToken &) = delete;
+    QueryCancelToken &operator=(const QueryCancelToken &) = delete;
+
+    void cancel();
+    bool isCancelled() const;
+
+private:
+    void attach(const QSqlDatabase &db);
+    void detach();
+
+    mutable QMutex m_mutex;
+    bool m_cancelled = false;
+    void *m_cancelHandle = nullptr;   // PGcancel*, поки запит виконується
+};
+
+#endif // QUERYCANCEL_H
@@ -0,0 +1,163 @@
+#include "querystats.h"
+#include "logging.h"
+#include <QDateTime>
+#include <QDebug>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QMutexLocker>
+#include <QSqlQuery>
+#include <algorithm>
+
+namespace {
+
+QJsonObject summaryToJson(const HistogramSummary &summary)
+{
+    QJsonObject object;
+    object["count"] = static_cast<qint64>(summary.count);
+    object["min"] = summary.min;
+    object["mean"] = summary.mean;
+    object["p50"] = summary.p50;
+    object["p95"] = summary.p95;
+    object["p99"] = summary.p99;
+    object["max"] = summary.max;
+    return object;
+}
+
+} // namespace
+
+void QueryStatsRegistry::recordPrepare(const QString &queryName, qint64 elapsedUs)
+{
+    QMutexLocker locker(&m_mutex);
+    if (!m_enabled) {
+        return;
+    }
+    m_entries[queryName].prepareUs.record(elapsedUs);
+}
+
+void QueryStatsRegistry::recordExecution(const QString &queryName, bool ok, qint64 executeUs, qint64 decodeUs, qint64 rows)
+{
+    QMutexLocker locker(&m_mutex);
+    if (!m_enabled) {
+        return;
+    }
+    Entry &entry = m_entries[queryName];
+    ++entry.executions;
+    entry.executeUs.record(executeUs);
+    if (!ok) {
+        ++entry.errors;
+        return;
+    }
+    entry.decodeUs.record(decodeUs);
+    if (rows >= 0) {
+        entry.rows.record(rows);
+    }
+}
+
+void QueryStatsRegistry::setEnabled(bool enabled)
+{
+    QMutexLocker locker(&m_mutex);
+    m_enabled = enabled;
+}
+
+bool QueryStatsRegistry::isEnabled() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_enabled;
+}
+
+void QueryStatsRegistry::reset()
+{
+    QMutexLocker locker(&m_mutex);
+    m_entries.clear();
+}
+
+QList<NamedQueryStats> QueryStatsRegistry::snapshot() const
+{
+    QList<NamedQueryStats> result;
+    {
+        QMutexLocker locker(&m_mutex);
+        result.reserve(m_entries.size());
+        for (auto it = m_entries.constBegin(); it != m_entries.constEnd(); ++it) {
+            NamedQueryStats stats;
+            stats.queryName = it.key();
+            stats.executions = it->executions;
+            stats.errors = it->errors;
+            stats.prepareUs = it->prepareUs.summary();
+            stats.executeUs = it->executeUs.summary();
+            stats.decodeUs = it->decodeUs.summary();
+            stats.rows = it->rows.summary();
+            result.append(stats);
+        }
+    }
+    std::sort(result.begin(), result.end(), [](const NamedQueryStats &a, const NamedQueryStats &b) {
+        return a.queryName < b.queryName;
+    });
+    return result;
+}
+
+QJsonObject QueryStatsRegistry::toJson() const
+{
+    QJsonArray queries;
+    for (const NamedQueryStats &stats : snapshot()) {
+        QJsonObject object;
+        object["name"] = stats.queryName;
+        object["executions"] = static_cast<qint64>(stats.executions);
+        object["errors"] = static_cast<qint64>(stats.errors);
+        object["prepareUs"] = summaryToJson(stats.prepareUs);
+        object["executeUs"] = summaryToJson(stats.executeUs);
+        object["decodeUs"] = summaryToJson(stats.decodeUs);
+        object["rows"] = summaryToJson(stats.rows);
+        queries.append(object);
+    }
+
+    QJsonObject root;
+    root["generatedAt"] = QDateTime::currentDateTimeUtc().toString(Qt::ISODateWithMs);
+    root["queries"] = queries;
+    return root;
+}
+
+bool QueryStatsRegistry::dumpJson(const QString &filePath) const
+{
+    QFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qCWarning(lcDbConnection) << "QueryStats: не вдалося відкрити файл" << filePath << ":" << file.errorString();
+        return false;
+    }
+    file.write(QJsonDocument(toJson()).toJson(QJsonDocument::Indented));
+    qCInfo(lcDbConnection) << "QueryStats: статистику запитів записано у" << filePath;
+    return true;
+}
+
+QueryTrace::QueryTrace(QueryStatsRegistry &registry, const QString &queryName)
+    : m_registry(registry), m_queryName(queryName)
+{
+}
+
+QueryTrace::~QueryTrace()
+{
+    finish();
+}
+
+bool QueryTrace::exec(QSqlQuery &query)
+{
+    finish();
+
+    m_timer.start();
+    m_ok = query.exec();
+    m_executeUs = m_timer.nsecsElapsed() / 1000;
+    m_rows = query.isSelect() ? query.size() : query.numRowsAffected();
+    m_pending = true;
+    m_timer.restart();
+    return m_ok;
+}
+
+void QueryTrace::finish()
+{
+    if (!m_pending) {
+        return;
+    }
+    m_pending = false;
+    const qint64 decodeUs = m_ok ? m_timer.nsecsElapsed() / 1000 : 0;
+    m_registry.recordExecution(m_queryName, m_ok, m_executeUs, decodeUs, m_rows);
+}
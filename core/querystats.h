@@ -0,0 +1,80 @@
+#ifndef QUERYSTATS_H
+#define QUERYSTATS_H
+
+#include <QElapsedTimer>
+#include <QHash>
+#include <QJsonObject>
+#include <QList>
+#include <QMutex>
+#include <QString>
+#include "histogram.h"
+
+class QSqlQuery;
+
+// Зведена статистика одного іменованого запиту. Час - у мікросекундах.
+struct NamedQueryStats {
+    QString queryName;
+    quint64 executions = 0;
+    quint64 errors = 0;
+    HistogramSummary prepareUs;     // Лише справжні підготовки (промахи кешу запитів)
+    HistogramSummary executeUs;     // QSqlQuery::exec (мережа + сервер)
+    HistogramSummary decodeUs;      // Від кінця exec до завершення розбору рядків
+    HistogramSummary rows;          // Рядків у результаті (або змінених для DML)
+};
+
+// Гістограми затримок для кожного іменованого запиту. Потокобезпечний.
+class QueryStatsRegistry
+{
+public:
+    void recordPrepare(const QString &queryName, qint64 elapsedUs);
+    void recordExecution(const QString &queryName, bool ok, qint64 executeUs, qint64 decodeUs, qint64 rows);
+
+    void setEnabled(bool enabled);
+    bool isEnabled() const;
+    void reset();
+
+    QList<NamedQueryStats> snapshot() const;   // Відсортовано за іменем запиту
+    QJsonObject toJson() const;
+    bool dumpJson(const QString &filePath) const;
+
+private:
+    struct Entry {
+        quint64 executions = 0;
+        quint64 errors = 0;
+        HdrHistogram prepareUs;
+        HdrHistogram executeUs;
+        HdrHistogram decodeUs;
+        HdrHistogram rows;
+    };
+
+    mutable QMutex m_mutex;
+    QHash<QString, Entry> m_entries;
+    bool m_enabled = true;
+};
+
+// Вимірює одне або кілька виконань запиту: exec() засікає час виконання, а розбір
+// результату триває до наступного exec() або до знищення об'єкта.
+class QueryTrace
+{
+public:
+    QueryTrace(QueryStatsRegistry &registry, const QString &queryName);
+    ~QueryTrace();
+
+    QueryTrace(const QueryTrace &) = delete;
+    QueryTrace &operator=(const QueryTrace &) = delete;
+
+    bool exec(QSqlQuery &query);
+    // Фіксує вимір раніше, ніж об'єкт вийде з області (коли далі йдуть інші запити)
+    void finish();
+
+private:
+    QueryStatsRegistry &m_registry;
+    QString m_queryName;
+    QElapsedTimer m_timer;
+    qint64 m_executeUs = 0;
+    qint64 m_rows = -1;
+    bool m_ok = false;
+    bool m_pending = false;
+};
+
+#endif // QUERYSTATS_H
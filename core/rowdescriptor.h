@@ -0,0 +1,32 @@
+#ifndef ROWDESCRIPTOR_H
+#define ROWDESCRIPTOR_H
+
+#include <tuple>
+
+// Опис відповідності "стовпець результату -> поле структури" для RowMapper (rowmapper.h).
+// Для кожної структури оголошується одна спеціалізація RowDescriptor поруч з її визначенням:
+//
+//     template <> struct RowDescriptor<Foo> {
+//         static constexpr auto columns = std::make_tuple(
+//             rowColumn("foo_id", &Foo::fooId),
+//             rowColumn("name", &Foo::name));
+//     };
+//
+// Стовпці, яких немає в конкретному результаті, пропускаються - поле лишається за замовчуванням.
+
+template <typename T, typename M>
+struct RowColumn {
+    const char *name;
+    M T::*member;
+};
+
+template <typename T, typename M>
+constexpr RowColumn<T, M> rowColumn(const char *name, M T::*member)
+{
+    return RowColumn<T, M>{name, member};
+}
+
+template <typename T>
+struct RowDescriptor;
+
+#endif // ROWDESCRIPTOR_H
@@ -0,0 +1,133 @@
+#ifndef ROWMAPPER_H
+#define ROWMAPPER_H
+
+#include <QDate>
+#include <QDateTime>
+#include <QList>
+#include <QSqlQuery>
+#include <QSqlRecord>
+#include <QString>
+#include <QVariant>
+#include <array>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include "rowdescriptor.h"
+
+// Перетворення QVariant у тип поля. NULL дає значення за замовчуванням (0, порожній рядок, недійсна дата).
+template <typename M>
+struct RowValue;
+
+template <> struct RowValue<int> {
+    static int from(const QVariant &value) { return value.toInt(); }
+};
+template <> struct RowValue<qint64> {
+    static qint64 from(const QVariant &value) { return value.toLongLong(); }
+};
+template <> struct RowValue<double> {
+    static double from(const QVariant &value) { return value.toDouble(); }
+};
+template <> struct RowValue<bool> {
+    static bool from(const QVariant &value) { return value.toBool(); }
+};
+template <> struct RowValue<QString> {
+    static QString from(const QVariant &value) { return value.isNull() ? QString() : value.toString(); }
+};
+template <> struct RowValue<QDate> {
+    static QDate from(const QVariant &value) { return value.toDate(); }
+};
+template <> struct RowValue<QDateTime> {
+    // Деякі запити повертають час як TEXT (CAST), тому рядок розбираємо явно
+    static QDateTime from(const QVariant &value)
+    {
+        if (value.isNull()) {
+            return QDateTime();
+        }
+        if (value.typeId() == QMetaType::QString) {
+            const QString text = value.toString();
+            QDateTime parsed = QDateTime::fromString(text, Qt::ISODateWithMs);
+            return parsed.isValid() ? parsed : QDateTime::fromString(text, Qt::ISODate);
+        }
+        return value.toDateTime();
+    }
+};
+
+namespace rowmapper_detail {
+template <typename T, typename = void>
+struct HasFoundFlag : std::false_type {};
+template <typename T>
+struct HasFoundFlag<T, std::void_t<decltype(std::declval<T &>().found)>> : std::true_type {};
+}
+
+// Декодує рядки QSqlQuery у структуру T за RowDescriptor<T>.
+// Індекси стовпців шукаються за іменем один раз - у конструкторі, для всього результату;
+// далі кожне поле читається за індексом. Створювати після exec(), до першого next().
+template <typename T>
+class RowMapper
+{
+public:
+    explicit RowMapper(const QSqlQuery &query)
+    {
+        const QSqlRecord record = query.record();
+        resolve(record, std::make_index_sequence<ColumnCount>());
+    }
+
+    // Читає поточний рядок. Якщо T має поле found, воно стає true.
+    T read(const QSqlQuery &query) const
+    {
+        T row{};
+        readInto(query, row);
+        return row;
+    }
+
+    void readInto(const QSqlQuery &query, T &row) const
+    {
+        decode(query, row, std::make_index_sequence<ColumnCount>());
+        if constexpr (rowmapper_detail::HasFoundFlag<T>::value) {
+            row.found = true;
+        }
+    }
+
+private:
+    using Columns = std::remove_cv_t<decltype(RowDescriptor<T>::columns)>;
+    static constexpr std::size_t ColumnCount = std::tuple_size_v<Columns>;
+
+    template <std::size_t... I>
+    void resolve(const QSqlRecord &record, std::index_sequence<I...>)
+    {
+        ((m_indexes[I] = record.indexOf(QLatin1String(std::get<I>(RowDescriptor<T>::columns).name))), ...);
+    }
+
+    template <std::size_t... I>
+    void decode(const QSqlQuery &query, T &row, std::index_sequence<I...>) const
+    {
+        (decodeColumn(query, row, std::get<I>(RowDescriptor<T>::columns), m_indexes[I]), ...);
+    }
+
+    template <typename M>
+    static void decodeColumn(const QSqlQuery &query, T &row, const RowColumn<T, M> &column, int index)
+    {
+        if (index >= 0) {
+            row.*(column.member) = RowValue<M>::from(query.value(index));
+        }
+    }
+
+    std::array<int, ColumnCount> m_indexes{};
+};
+
+// Читає всі рядки, що лишилися в результаті
+template <typename T>
+QList<T> readAllRows(QSqlQuery &query)
+{
+    QList<T> rows;
+    if (query.size() > 0) {
+        rows.reserve(query.size());
+    }
+    const RowMapper<T> mapper(query);
+    while (query.next()) {
+        rows.append(mapper.read(query));
+    }
+    return rows;
+}
+
+#endif // ROWMAPPER_H
@@ -0,0 +1,446 @@
+#include "suggestionindex.h"
+#include <QSet>
+#include <QtAlgorithms>
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <queue>
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+#include <emmintrin.h>
+#define SUGGESTIONINDEX_SSE2
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+#include <arm_neon.h>
+#define SUGGESTIONINDEX_NEON
+#endif
+
+namespace {
+
+// Довжина спільного префікса a і b в межах перших n байтів, по 16 байтів за крок
+int commonPrefixLength(const char *a, const char *b, int n)
+{
+    int i = 0;
+#if defined(SUGGESTIONINDEX_SSE2)
+    for (; i + 16 <= n; i += 16) {
+        const __m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i *>(a + i));
+        const __m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i *>(b + i));
+        const unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(va, vb)));
+        if (mask != 0xFFFFu) {
+            return i + static_cast<int>(qCountTrailingZeroBits(~mask & 0xFFFFu));
+        }
+    }
+#elif defined(SUGGESTIONINDEX_NEON)
+    for (; i + 16 <= n; i += 16) {
+        const uint8x16_t eq = vceqq_u8(vld1q_u8(reinterpret_cast<const uint8_t *>(a + i)),
+                                       vld1q_u8(reinterpret_cast<const uint8_t *>(b + i)));
+        if (vminvq_u8(eq) != 0xFF) {
+            break;  // Розбіжність у цих 16 байтах - позицію знайде скалярний хвіст
+        }
+    }
+#endif
+    while (i < n && a[i] == b[i]) {
+        ++i;
+    }
+    return i;
+}
+
+// Лексикографічне порівняння байтів (як memcmp, але через commonPrefixLength)
+int compareKeys(const char *a, int aLength, const char *b, int bLength)
+{
+    const int common = commonPrefixLength(a, b, qMin(aLength, bLength));
+    if (common == qMin(aLength, bLength)) {
+        return aLength < bLength ? -1 : (aLength > bLength ? 1 : 0);
+    }
+    return static_cast<uchar>(a[common]) < static_cast<uchar>(b[common]) ? -1 : 1;
+}
+
+bool isWordChar(QChar c)
+{
+    return c.isLetterOrNumber() || c.isMark();
+}
+
+// 0xFF не трапляється в UTF-8, тож prefix + 0xFF більший за будь-який ключ із цим префіксом
+QByteArray prefixUpperBound(const QByteArray &prefix)
+{
+    return prefix + char(0xFF);
+}
+
+} // namespace
+
+quint64 SuggestionIndex::itemKey(SearchSuggestionInfo::SuggestionType type, int id)
+{
+    return (quint64(type) << 32) | quint32(id);
+}
+
+QString SuggestionIndex::normalize(const QString &text)
+{
+    QString folded = text.toCaseFolded();
+    // Апостроф у "п'ять" пишуть кількома символами; у ключі лише ASCII-варіант
+    for (QChar &c : folded) {
+        const char16_t u = c.unicode();
+        if (u == u'\u2019' || u == u'\u02BC' || u == u'\u2018' || u == u'`') {
+            c = QLatin1Char('\'');
+        }
+    }
+    return folded.simplified();
+}
+
+QByteArray SuggestionIndex::foldKey(const QString &text)
+{
+    QByteArray key = normalize(text).toUtf8();
+    if (key.size() > MaxKeyBytes) {
+        key.truncate(MaxKeyBytes);
+    }
+    return key;
+}
+
+// Ключі від початку кожного з перших MaxWordStarts слів: "тарас шевченко", "шевченко"
+QList<QByteArray> SuggestionIndex::wordStartKeys(const QString &text)
+{
+    QList<QByteArray> keys;
+    const QString normalized = normalize(text);
+    for (int i = 0; i < normalized.size() && keys.size() < MaxWordStarts; ++i) {
+        const bool wordStart = isWordChar(normalized.at(i))
+                               && (i == 0 || (!isWordChar(normalized.at(i - 1)) && normalized.at(i - 1) != QLatin1Char('\'')));
+        if (!wordStart) continue;
+        QByteArray key = normalized.mid(i, MaxKeyBytes).toUtf8();
+        if (key.size() > MaxKeyBytes) {
+            key.truncate(MaxKeyBytes);
+        }
+        if (!keys.contains(key)) {
+            keys.append(key);
+        }
+    }
+    return keys;
+}
+
+quint32 SuggestionIndex::appendItem(const SuggestionSourceItem &source)
+{
+    const SearchSuggestionInfo &suggestion = source.suggestion;
+    const quint64 key = itemKey(suggestion.type, suggestion.id);
+    const auto existing = m_liveItems.constFind(key);
+    if (existing != m_liveItems.constEnd()) {
+        m_items[existing.value()].alive = false;
+        ++m_deadItems;
+    }
+
+    Item item;
+    item.suggestion = suggestion;
+    item.suggestion.fuzzyMatch = false;
+    item.popularity = static_cast<float>(source.popularity);
+    m_items.push_back(item);
+    const quint32 index = static_cast<quint32>(m_items.size() - 1);
+    m_liveItems.insert(key, index);
+
+    int &maxId = suggestion.type == SearchSuggestionInfo::Book ? m_maxBookId : m_maxAuthorId;
+    maxId = qMax(maxId, suggestion.id);
+    return index;
+}
+
+void SuggestionIndex::build(const QList<SuggestionSourceItem> &items)
+{
+    m_items.clear();
+    m_liveItems.clear();
+    m_deadItems = 0;
+    m_delta.clear();
+    m_maxBookId = 0;
+    m_maxAuthorId = 0;
+    m_items.reserve(items.size());
+    m_liveItems.reserve(items.size());
+
+    std::vector<DeltaEntry> keys;
+    keys.reserve(size_t(items.size()) * 2);
+    for (const SuggestionSourceItem &source : items) {
+        const quint32 index = appendItem(source);
+        for (const QByteArray &key : wordStartKeys(source.suggestion.displayText)) {
+            keys.emplace_back(key, index);
+        }
+    }
+    // Повтори (type, id) у джерелі: лишається останній, ключі попередніх не потрібні
+    keys.erase(std::remove_if(keys.begin(), keys.end(),
+                              [this](const DeltaEntry &entry) { return !m_items[entry.second].alive; }),
+               keys.end());
+    std::sort(keys.begin(), keys.end());
+
+    // Front coding: перший ключ блоку повністю, далі - спільний префікс із попереднім і суфікс
+    m_entries.clear();
+    m_entries.reserve(keys.size());
+    m_keyBytes.clear();
+    const QByteArray *previous = nullptr;
+    for (size_t i = 0; i < keys.size(); ++i) {
+        const QByteArray &key = keys[i].first;
+        Entry entry;
+        if (i % BlockSize != 0 && previous) {
+            entry.shared = static_cast<quint8>(commonPrefixLength(previous->constData(), key.constData(),
+                                                                  qMin(previous->size(), key.size())));
+        }
+        entry.offset = static_cast<quint32>(m_keyBytes.size());
+        entry.suffixLength = static_cast<quint8>(key.size() - entry.shared);
+        entry.item = keys[i].second;
+        m_keyBytes.append(key.constData() + entry.shared, entry.suffixLength);
+        m_entries.push_back(entry);
+        previous = &key;
+    }
+    m_keyBytes.squeeze();
+
+    rebuildBlockTree();
+}
+
+int SuggestionIndex::blockCount() const
+{
+    return static_cast<int>((m_entries.size() + BlockSize - 1) / BlockSize);
+}
+
+float SuggestionIndex::entryWeight(int entry) const
+{
+    return m_items[m_entries[size_t(entry)].item].popularity;
+}
+
+void SuggestionIndex::rebuildBlockTree()
+{
+    const int blocks = blockCount();
+    m_treeLeaves = 1;
+    while (m_treeLeaves < blocks) {
+        m_treeLeaves *= 2;
+    }
+    m_blockTree.assign(size_t(m_treeLeaves) * 2, -std::numeric_limits<float>::infinity());
+    for (int entry = 0; entry < int(m_entries.size()); ++entry) {
+        float &leaf = m_blockTree[size_t(m_treeLeaves + entry / BlockSize)];
+        leaf = qMax(leaf, entryWeight(entry));
+    }
+    for (int node = m_treeLeaves - 1; node >= 1; --node) {
+        m_blockTree[size_t(node)] = qMax(m_blockTree[size_t(2 * node)], m_blockTree[size_t(2 * node + 1)]);
+    }
+}
+
+// Відновлює ключ запису в buffer (MaxKeyBytes байтів), повертає його довжину
+int SuggestionIndex::decodeKey(int entry, char *buffer) const
+{
+    int length = 0;
+    for (int i = entry - entry % BlockSize; i <= entry; ++i) {
+        const Entry &e = m_entries[size_t(i)];
+        std::memcpy(buffer + e.shared, m_keyBytes.constData() + e.offset, e.suffixLength);
+        length = e.shared + e.suffixLength;
+    }
+    return length;
+}
+
+// Перший запис із ключем >= key: двійковий пошук по перших ключах блоків, далі лінійно в блоці
+int SuggestionIndex::lowerBound(const QByteArray &key) const
+{
+    const int blocks = blockCount();
+    int low = 0;
+    int high = blocks;
+    while (low < high) {
+        const int middle = (low + high) / 2;
+        const Entry &head = m_entries[size_t(middle) * BlockSize];
+        if (compareKeys(m_keyBytes.constData() + head.offset, head.suffixLength, key.constData(), key.size()) < 0) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+    // Блок low починається з ключа >= key; шуканий запис - у попередньому блоці або його початок
+    if (low == 0) {
+        return 0;
+    }
+    const int begin = (low - 1) * BlockSize;
+    const int end = qMin(begin + BlockSize, int(m_entries.size()));
+    char buffer[MaxKeyBytes];
+    for (int i = begin; i < end; ++i) {
+        const Entry &e = m_entries[size_t(i)];
+        std::memcpy(buffer + e.shared, m_keyBytes.constData() + e.offset, e.suffixLength);
+        if (compareKeys(buffer, e.shared + e.suffixLength, key.constData(), key.size()) >= 0) {
+            return i;
+        }
+    }
+    return end;
+}
+
+void SuggestionIndex::upsert(const QList<SuggestionSourceItem> &items)
+{
+    for (const SuggestionSourceItem &source : items) {
+        const quint32 index = appendItem(source);
+        for (const QByteArray &key : wordStartKeys(source.suggestion.displayText)) {
+            const DeltaEntry entry(key, index);
+            m_delta.insert(std::upper_bound(m_delta.begin(), m_delta.end(), entry), entry);
+        }
+    }
+}
+
+void SuggestionIndex::remove(SearchSuggestionInfo::SuggestionType type, int id)
+{
+    const auto it = m_liveItems.find(itemKey(type, id));
+    if (it == m_liveItems.end()) return;
+    m_items[it.value()].alive = false;
+    ++m_deadItems;
+    m_liveItems.erase(it);
+}
+
+bool SuggestionIndex::needsCompaction() const
+{
+    return m_delta.size() > qMax<size_t>(1024, m_entries.size() / 8)
+           || size_t(m_deadItems) > qMax<size_t>(1024, m_items.size() / 4);
+}
+
+void SuggestionIndex::compact()
+{
+    QList<SuggestionSourceItem> live;
+    live.reserve(m_liveItems.size());
+    for (const Item &item : m_items) {
+        if (!item.alive) continue;
+        SuggestionSourceItem source;
+        source.suggestion = item.suggestion;
+        source.popularity = item.popularity;
+        live.append(source);
+    }
+    build(live);
+}
+
+int SuggestionIndex::itemCount() const
+{
+    return int(m_liveItems.size());
+}
+
+int SuggestionIndex::keyCount() const
+{
+    return int(m_entries.size() + m_delta.size());
+}
+
+int SuggestionIndex::maxId(SearchSuggestionInfo::SuggestionType type) const
+{
+    return type == SearchSuggestionInfo::Book ? m_maxBookId : m_maxAuthorId;
+}
+
+qsizetype SuggestionIndex::memoryUsage() const
+{
+    qsizetype bytes = m_keyBytes.capacity()
+                      + qsizetype(m_entries.capacity() * sizeof(Entry))
+                      + qsizetype(m_blockTree.capacity() * sizeof(float))
+                      + qsizetype(m_items.capacity() * sizeof(Item))
+                      + qsizetype(m_liveItems.capacity()) * qsizetype(sizeof(quint64) + sizeof(quint32));
+    for (const Item &item : m_items) {
+        bytes += (item.suggestion.displayText.capacity() + item.suggestion.imagePath.capacity()) * qsizetype(sizeof(QChar));
+    }
+    for (const DeltaEntry &entry : m_delta) {
+        bytes += qsizetype(sizeof(DeltaEntry)) + entry.first.capacity();
+    }
+    return bytes;
+}
+
+QList<SearchSuggestionInfo> SuggestionIndex::lookup(const QString &prefix, int limit, Ranking ranking) const
+{
+    QList<SearchSuggestionInfo> results;
+    const QByteArray key = foldKey(prefix);
+    if (key.isEmpty() || limit <= 0) {
+        return results;
+    }
+
+    const QByteArray upper = prefixUpperBound(key);
+    const int begin = lowerBound(key);
+    const int end = lowerBound(upper);
+    const auto deltaBegin = std::lower_bound(m_delta.begin(), m_delta.end(), DeltaEntry(key, 0));
+    const auto deltaEnd = std::lower_bound(deltaBegin, m_delta.end(), DeltaEntry(upper, 0));
+
+    // Один елемент може знайтися за кількома словами - показуємо його один раз
+    QSet<quint32> emitted;
+    auto emitItem = [&](quint32 index) {
+        const Item &item = m_items[index];
+        if (!item.alive || emitted.contains(index)) return false;
+        emitted.insert(index);
+        results.append(item.suggestion);
+        return results.size() >= limit;
+    };
+
+    if (ranking == Ranking::Alphabetical) {
+        // Злиття основного діапазону з додатком; ключі основного відновлюються послідовно
+        auto delta = deltaBegin;
+        char buffer[MaxKeyBytes];
+        int decoded = -1;
+        for (int i = begin; i < end; ++i) {
+            if (decoded != i - 1) {
+                decodeKey(i, buffer);
+            } else {
+                const Entry &e = m_entries[size_t(i)];
+                std::memcpy(buffer + e.shared, m_keyBytes.constData() + e.offset, e.suffixLength);
+            }
+            decoded = i;
+            const Entry &e = m_entries[size_t(i)];
+            const int length = e.shared + e.suffixLength;
+            for (; delta != deltaEnd
+                   && compareKeys(delta->first.constData(), delta->first.size(), buffer, length) < 0; ++delta) {
+                if (emitItem(delta->second)) return results;
+            }
+            if (emitItem(e.item)) return results;
+        }
+        for (; delta != deltaEnd; ++delta) {
+            if (emitItem(delta->second)) return results;
+        }
+        return results;
+    }
+
+    // Best-first по дереву максимумів: вузол розкривається, лише коли його максимум найбільший
+    // серед кандидатів, тож для короткого префікса читаються кілька блоків, а не весь діапазон.
+    enum CandidateKind { TreeNode, BaseEntry, DeltaKey };
+    struct Candidate {
+        float weight;
+        CandidateKind kind;
+        int position;
+    };
+    // Більша вага першою; за рівної - спершу вузли (в них може бути рівний, але раніший ключ),
+    // далі записи в порядку ключів
+    auto lessUrgent = [](const Candidate &a, const Candidate &b) {
+        if (a.weight != b.weight) return a.weight < b.weight;
+        if (a.kind != b.kind) return a.kind > b.kind;
+        return a.position > b.position;
+    };
+    std::priority_queue<Candidate, std::vector<Candidate>, decltype(lessUrgent)> queue(lessUrgent);
+
+    auto pushEntries = [&](int from, int to) {
+        for (int i = from; i < to; ++i) {
+            queue.push({entryWeight(i), BaseEntry, i});
+        }
+    };
+    const int firstFullBlock = (begin + BlockSize - 1) / BlockSize;
+    const int lastFullBlock = end / BlockSize;   // Не включно
+    if (firstFullBlock >= lastFullBlock) {
+        pushEntries(begin, end);
+    } else {
+        pushEntries(begin, firstFullBlock * BlockSize);
+        pushEntries(lastFullBlock * BlockSize, end);
+        // Канонічне розбиття [firstFullBlock, lastFullBlock) на вузли дерева
+        for (int left = firstFullBlock + m_treeLeaves, right = lastFullBlock + m_treeLeaves; left < right;
+             left /= 2, right /= 2) {
+            if (left & 1) {
+                queue.push({m_blockTree[size_t(left)], TreeNode, left});
+                ++left;
+            }
+            if (right & 1) {
+                --right;
+                queue.push({m_blockTree[size_t(right)], TreeNode, right});
+            }
+        }
+    }
+    for (auto it = deltaBegin; it != deltaEnd; ++it) {
+        queue.push({m_items[it->second].popularity, DeltaKey, int(it - m_delta.begin())});
+    }
+
+    while (!queue.empty()) {
+        const Candidate candidate = queue.top();
+        queue.pop();
+        if (candidate.kind == TreeNode) {
+            if (candidate.position >= m_treeLeaves) {
+                const int block = candidate.position - m_treeLeaves;
+                pushEntries(block * BlockSize, qMin((block + 1) * BlockSize, int(m_entries.size())));
+            } else {
+                queue.push({m_blockTree[size_t(2 * candidate.position)], TreeNode, 2 * candidate.position});
+                queue.push({m_blockTree[size_t(2 * candidate.position + 1)], TreeNode, 2 * candidate.position + 1});
+            }
+        } else if (candidate.kind == BaseEntry) {
+            if (emitItem(m_entries[size_t(candidate.position)].item)) break;
+        } else {
+            if (emitItem(m_delta[size_t(candidate.position)].second)) break;
+        }
+    }
+    return results;
+}
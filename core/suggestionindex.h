@@ -0,0 +1,95 @@
+#ifndef SUGGESTIONINDEX_H
+#define SUGGESTIONINDEX_H
+
+#include <QByteArray>
+#include <QHash>
+#include <QList>
+#include <QString>
+#include <utility>
+#include <vector>
+#include "datatypes.h"
+
+// Автодоповнення в пам'яті: префіксний пошук за назвами книг та іменами авторів без звернень до БД.
+//
+// Ключі - case-folded UTF-8 (QString::toCaseFolded, зокрема для кирилиці), по одному від початку
+// кожного з перших слів, тож "шевч" знаходить "Тарас Шевченко". Ключі відсортовані й лежать блоками
+// по BlockSize з front coding: перший ключ блоку повністю, решта - довжина спільного з попереднім
+// ключем префікса та суфікс. Порівняння ключів - SSE2/NEON по 16 байтів.
+//
+// Ранжування за популярністю: дерево максимумів над блоками дає найпопулярніші збіги за
+// O(limit * log n), не перебираючи весь діапазон (префікс "т" - десятки тисяч ключів).
+//
+// upsert()/remove() змінюють невеликий відсортований додаток до основного масиву; коли він
+// розростається, needsCompaction() підказує викликати compact() або перебудувати індекс.
+// Не потокобезпечний: будується в будь-якому потоці, використовується з одного.
+class SuggestionIndex
+{
+public:
+    enum class Ranking {
+        Alphabetical,   // У порядку ключів
+        Popularity      // За спаданням популярності, при рівності - за ключем
+    };
+
+    static constexpr int BlockSize = 16;
+    static constexpr int MaxKeyBytes = 64;      // Довші ключі обрізаються (префікси довші за це не вводять)
+    static constexpr int MaxWordStarts = 4;     // Скільки перших слів назви індексується
+
+    void build(const QList<SuggestionSourceItem> &items);
+    void upsert(const QList<SuggestionSourceItem> &items);
+    void remove(SearchSuggestionInfo::SuggestionType type, int id);
+    void compact();
+    bool needsCompaction() const;
+
+    QList<SearchSuggestionInfo> lookup(const QString &prefix, int limit, Ranking ranking = Ranking::Popularity) const;
+
+    int itemCount() const;
+    int keyCount() const;
+    int maxId(SearchSuggestionInfo::SuggestionType type) const;   // Для дозавантаження новіших рядків
+    qsizetype memoryUsage() const;
+
+    // Нормалізація для ключів і запитів: case folding, єдиний апостроф, стиснуті пробіли
+    static QByteArray foldKey(const QString &text);
+
+private:
+    struct Item {
+        SearchSuggestionInfo suggestion;
+        float popularity = 0.0f;
+        bool alive = true;
+    };
+
+    struct Entry {
+        quint32 offset = 0;         // Суфікс у m_keyBytes
+        quint8 shared = 0;          // Спільний з попереднім ключем префікс (0 для першого в блоці)
+        quint8 suffixLength = 0;
+        quint32 item = 0;
+    };
+
+    using DeltaEntry = std::pair<QByteArray, quint32>;
+
+    static QString normalize(const QString &text);
+    static quint64 itemKey(SearchSuggestionInfo::SuggestionType type, int id);
+    static QList<QByteArray> wordStartKeys(const QString &text);
+
+    quint32 appendItem(const SuggestionSourceItem &source);
+    void rebuildBlockTree();
+    int blockCount() const;
+    int lowerBound(const QByteArray &key) const;
+    int decodeKey(int entry, char *buffer) const;
+    float entryWeight(int entry) const;
+
+    std::vector<Item> m_items;
+    QHash<quint64, quint32> m_liveItems;        // (тип, id) -> індекс у m_items
+    int m_deadItems = 0;
+
+    QByteArray m_keyBytes;
+    std::vector<Entry> m_entries;
+    std::vector<float> m_blockTree;             // Дерево відрізків: максимум популярності в блоках
+    int m_treeLeaves = 0;
+
+    std::vector<DeltaEntry> m_delta;            // Ключі, додані після build(), відсортовані
+
+    int m_maxBookId = 0;
+    int m_maxAuthorId = 0;
+};
+
+#endif // SUGGESTIONINDEX_H
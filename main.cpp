@@ -5,10 +5,13 @@
 #include "logindialog.h"
 #include "database.h"
 #include "testdata.h"
+#include "logging.h"
 
 int main(int argc, char *argv[])
 {
     QApplication a(argc, argv);
+    // Повідомлення пишуться у stderr фоновим потоком; зупиняється автоматично при виході
+    Logging::installAsyncHandler();
     a.setWindowIcon(QIcon("D:/projects/DB_Kurs/QtAPP/untitled/icons/app_icon.png"));
     QApplication::setApplicationName("Bookstore");
     QApplication::setOrganizationName("Patsera_Ihor");
@@ -0,0 +1,155 @@
+#include "database.h"
+
+// Асинхронні обгортки над синхронними методами. Кожна виконується на m_workerPool,
+// де ThreadConnectionScope прив'язує до потоку власне з'єднання з пулу.
+
+QFuture<QList<BookDisplayInfo>> DatabaseManager::getAllBooksForDisplayAsync(int limit, int offset) const
+{
+    return runAsync([this, limit, offset]() { return getAllBooksForDisplay(limit, offset); });
+}
+
+QFuture<int> DatabaseManager::getTotalBookCountAsync() const
+{
+    return runAsync([this]() { return getTotalBookCount(); });
+}
+
+QFuture<QList<BookDisplayInfo>> DatabaseManager::getBooksByGenreAsync(const QString &genre, int limit) const
+{
+    return runAsync([this, genre, limit]() { return getBooksByGenre(genre, limit); });
+}
+
+QFuture<QList<AuthorDisplayInfo>> DatabaseManager::getAllAuthorsForDisplayAsync() const
+{
+    return runAsync([this]() { return getAllAuthorsForDisplay(); });
+}
+
+QFuture<CustomerLoginInfo> DatabaseManager::getCustomerLoginInfoAsync(const QString &email) const
+{
+    return runAsync([this, email]() { return getCustomerLoginInfo(email); });
+}
+
+QFuture<CustomerProfileInfo> DatabaseManager::getCustomerProfileInfoAsync(int customerId) const
+{
+    return runAsync([this, customerId]() { return getCustomerProfileInfo(customerId); });
+}
+
+QFuture<QList<OrderDisplayInfo>> DatabaseManager::getCustomerOrdersForDisplayAsync(int customerId) const
+{
+    return runAsync([this, customerId]() { return getCustomerOrdersForDisplay(customerId); });
+}
+
+QFuture<QList<SearchSuggestionInfo>> DatabaseManager::getSearchSuggestionsAsync(const QString &prefix, int limit,
+                                                                                  std::shared_ptr<QueryCancelToken> cancelToken) const
+{
+    return runAsync([this, prefix, limit, cancelToken]() {
+        // Скасовано, поки чекали вільного потоку - до сервера не звертаємось
+        if (cancelToken && cancelToken->isCancelled()) {
+            return QList<SearchSuggestionInfo>();
+        }
+        QueryCancelToken::Scope scope(cancelToken, connection());
+        return getSearchSuggestions(prefix, limit);
+    });
+}
+
+QFuture<QList<SuggestionSourceItem>> DatabaseManager::getSuggestionSourceAsync(int afterBookId, int afterAuthorId) const
+{
+    return runAsync([this, afterBookId, afterAuthorId]() { return getSuggestionSource(afterBookId, afterAuthorId); });
+}
+
+QFuture<QList<BookFilterSourceItem>> DatabaseManager::getBookFilterSourceAsync() const
+{
+    return runAsync([this]() { return getBookFilterSource(); });
+}
+
+QFuture<BookSearchPage> DatabaseManager::searchBooksAsync(const QString &queryText, int limit, int offset) const
+{
+    return runAsync([this, queryText, limit, offset]() { return searchBooks(queryText, limit, offset); });
+}
+
+QFuture<BookDetailsInfo> DatabaseManager::getBookDetailsAsync(int bookId) const
+{
+    return runAsync([this, bookId]() { return getBookDetails(bookId); });
+}
+
+QFuture<QList<CommentDisplayInfo>> DatabaseManager::getBookCommentsAsync(int bookId) const
+{
+    return runAsync([this, bookId]() { return getBookComments(bookId); });
+}
+
+QFuture<BookDisplayInfo> DatabaseManager::getBookDisplayInfoByIdAsync(int bookId) const
+{
+    return runAsync([this, bookId]() { return getBookDisplayInfoById(bookId); });
+}
+
+QFuture<QMap<int, BookDisplayInfo>> DatabaseManager::getBookDisplayInfoByIdsAsync(const QList<int> &bookIds) const
+{
+    return runAsync([this, bookIds]() { return getBookDisplayInfoByIds(bookIds); });
+}
+
+QFuture<BookDisplayInfo> DatabaseManager::loadBookDisplayInfo(int bookId)
+{
+    return m_bookLoader->load(bookId);
+}
+
+QFuture<QMap<int, BookDisplayInfo>> DatabaseManager::loadBookDisplayInfos(const QList<int> &bookIds)
+{
+    return m_bookLoader->loadMany(bookIds);
+}
+
+QFuture<bool> DatabaseManager::hasUserCommentedOnBookAsync(int bookId, int customerId) const
+{
+    return runAsync([this, bookId, customerId]() { return hasUserCommentedOnBook(bookId, customerId); });
+}
+
+QFuture<OrderDisplayInfo> DatabaseManager::getOrderDetailsByIdAsync(int orderId) const
+{
+    return runAsync([this, orderId]() { return getOrderDetailsById(orderId); });
+}
+
+QFuture<AuthorDetailsInfo> DatabaseManager::getAuthorDetailsAsync(int authorId) const
+{
+    return runAsync([this, authorId]() { return getAuthorDetails(authorId); });
+}
+
+QFuture<QList<BookDisplayInfo>> DatabaseManager::getSimilarBooksAsync(int currentBookId, const QString &genre, int limit) const
+{
+    return runAsync([this, currentBookId, genre, limit]() { return getSimilarBooks(currentBookId, genre, limit); });
+}
+
+QFuture<QList<BookDisplayInfo>> DatabaseManager::getFilteredBooksForDisplayAsync(const BookFilterCriteria &criteria) const
+{
+    return runAsync([this, criteria]() { return getFilteredBooksForDisplay(criteria); });
+}
+
+QFuture<BookPage> DatabaseManager::getFilteredBooksPageAsync(const BookFilterCriteria &criteria, BookSortOrder sortOrder,
+                                                             int pageSize, const QString &pageToken) const
+{
+    return runAsync([this, criteria, sortOrder, pageSize, pageToken]() {
+        return getFilteredBooksPage(criteria, sortOrder, pageSize, pageToken);
+    });
+}
+
+QFuture<BookPage> DatabaseManager::getAllBooksPageAsync(BookSortOrder sortOrder, int pageSize, const QString &pageToken) const
+{
+    return runAsync([this, sortOrder, pageSize, pageToken]() { return getAllBooksPage(sortOrder, pageSize, pageToken); });
+}
+
+QFuture<QStringList> DatabaseManager::getAllGenresAsync() const
+{
+    return runAsync([this]() { return getAllGenres(); });
+}
+
+QFuture<QStringList> DatabaseManager::getAllLanguagesAsync() const
+{
+    return runAsync([this]() { return getAllLanguages(); });
+}
+
+QFuture<BookFacetCounts> DatabaseManager::getBookFacetCountsAsync(const BookFilterCriteria &criteria) const
+{
+    return runAsync([this, criteria]() { return getBookFacetCounts(criteria); });
+}
+
+QFuture<QMap<int, int>> DatabaseManager::getCartItemsAsync(int customerId) const
+{
+    return runAsync([this, customerId]() { return getCartItems(customerId); });
+}
@@ -1,45 +1,42 @@
 #include "database.h"
+#include "logging.h"
 #include <QDebug>
 #include <QSqlDatabase>
 #include <QSqlError>
 #include <QSqlQuery>
 #include <QVariant>
+#include "rowmapper.h"
 
 QList<AuthorDisplayInfo> DatabaseManager::getAllAuthorsForDisplay() const
 {
     QList<AuthorDisplayInfo> authors;
-    if (!m_isConnected || !m_db.isOpen()) {
-        qWarning() << "Неможливо отримати авторів: немає активного з'єднання з БД.";
+    QSqlDatabase db = connection();
+    if (!m_isConnected || !db.isOpen()) {
+        qCWarning(lcDbAuthor) << "Неможливо отримати авторів: немає активного з'єднання з БД.";
         return authors;
     }
 
-    const QString sql = getSqlQuery("GetAllAuthorsForDisplay");
-    if (sql.isEmpty()) return authors;
-
-    QSqlQuery query(m_db);
-    qInfo() << "Executing SQL 'GetAllAuthorsForDisplay' to get authors for display...";
-    if (!query.exec(sql)) {
-        qCritical() << "Помилка при виконанні 'GetAllAuthorsForDisplay':";
-        qCritical() << query.lastError().text();
-        qCritical() << "SQL запит:" << sql;
+    const QueryCacheKey cacheKey = m_resultCache.prepare("GetAllAuthorsForDisplay", {}, {"author"});
+    if (m_resultCache.lookup(cacheKey, &authors)) {
         return authors;
     }
 
-    qInfo() << "Successfully fetched authors. Processing results...";
-    int count = 0;
-    while (query.next()) {
-        AuthorDisplayInfo authorInfo;
-        authorInfo.authorId = query.value("author_id").toInt();
-        authorInfo.firstName = query.value("first_name").toString();
-        authorInfo.lastName = query.value("last_name").toString();
-        authorInfo.nationality = query.value("nationality").toString();
-        authorInfo.imagePath = query.value("image_path").toString();
-
-        authors.append(authorInfo);
-        count++;
+    CachedStatement query = preparedQuery(SqlQueryId::GetAllAuthorsForDisplay, db);
+    QueryTrace trace(m_queryStats, "GetAllAuthorsForDisplay");
+    if (!query) return authors;
+    qCInfo(lcDbAuthor) << "Executing SQL 'GetAllAuthorsForDisplay' to get authors for display...";
+    if (!trace.exec(*query)) {
+        qCCritical(lcDbAuthor) << "Помилка при виконанні 'GetAllAuthorsForDisplay':";
+        qCCritical(lcDbAuthor) << query->lastError().text();
+        qCCritical(lcDbAuthor) << "SQL запит:" << query->lastQuery();
+        return authors;
     }
-    qInfo() << "Processed" << count << "authors for display.";
 
+    qCInfo(lcDbAuthor) << "Successfully fetched authors. Processing results...";
+    authors = readAllRows<AuthorDisplayInfo>(*query);
+    qCInfo(lcDbAuthor) << "Processed" << authors.size() << "authors for display.";
+
+    m_resultCache.insert(cacheKey, authors);
     return authors;
 }
 
@@ -47,81 +44,59 @@ AuthorDetailsInfo DatabaseManager::getAuthorDetails(int authorId) const
 {
     AuthorDetailsInfo details;
     details.found = false;
-    if (!m_isConnected || !m_db.isOpen() || authorId <= 0) {
-        qWarning() << "Неможливо отримати деталі автора: немає з'єднання або невірний authorId.";
+    QSqlDatabase db = connection();
+    if (!m_isConnected || !db.isOpen() || authorId <= 0) {
+        qCWarning(lcDbAuthor) << "Неможливо отримати деталі автора: немає з'єднання або невірний authorId.";
         return details;
     }
 
-    const QString authorSql = getSqlQuery("GetAuthorDetailsById");
-    if (authorSql.isEmpty()) return details;
-
-    QSqlQuery authorQuery(m_db);
-    if (!authorQuery.prepare(authorSql)) {
-        qCritical() << "Помилка підготовки запиту 'GetAuthorDetailsById':" << authorQuery.lastError().text();
+    // Ключ - весь результат (автор + його книги), тож і таблиць кілька
+    const QueryCacheKey cacheKey = m_resultCache.prepare("GetAuthorDetails", {authorId},
+                                                         {"author", "book", "book_author"});
+    if (m_resultCache.lookup(cacheKey, &details)) {
         return details;
     }
-    authorQuery.bindValue(":authorId", authorId);
 
-    qInfo() << "Executing SQL 'GetAuthorDetailsById' for author ID:" << authorId;
-    if (!authorQuery.exec()) {
-        qCritical() << "Помилка при виконанні 'GetAuthorDetailsById' для author ID '" << authorId << "':";
-        qCritical() << authorQuery.lastError().text();
-        qCritical() << "SQL запит:" << authorQuery.lastQuery();
+    CachedStatement authorQuery = preparedQuery(SqlQueryId::GetAuthorDetailsById, db);
+    QueryTrace authorTrace(m_queryStats, "GetAuthorDetailsById");
+    if (!authorQuery) return details;
+    authorQuery->bindValue(SqlParam::GetAuthorDetailsById::authorId, authorId);
+
+    qCInfo(lcDbAuthor) << "Executing SQL 'GetAuthorDetailsById' for author ID:" << authorId;
+    if (!authorTrace.exec(*authorQuery)) {
+        qCCritical(lcDbAuthor) << "Помилка при виконанні 'GetAuthorDetailsById' для author ID '" << authorId << "':";
+        qCCritical(lcDbAuthor) << authorQuery->lastError().text();
+        qCCritical(lcDbAuthor) << "SQL запит:" << authorQuery->lastQuery();
         return details;
     }
 
-    if (authorQuery.next()) {
-        details.authorId = authorQuery.value("author_id").toInt();
-        details.firstName = authorQuery.value("first_name").toString();
-        details.lastName = authorQuery.value("last_name").toString();
-        details.nationality = authorQuery.value("nationality").toString();
-        details.imagePath = authorQuery.value("image_path").toString();
-        details.biography = authorQuery.value("biography").toString();
-        details.birthDate = authorQuery.value("birth_date").toDate();
-        details.found = true;
-        qInfo() << "Author details found for author ID:" << authorId;
+    if (authorQuery->next()) {
+        RowMapper<AuthorDetailsInfo>(*authorQuery).readInto(*authorQuery, details);
+        authorTrace.finish();
+        qCInfo(lcDbAuthor) << "Author details found for author ID:" << authorId;
     } else {
-        qInfo() << "Author details not found for author ID:" << authorId;
+        qCInfo(lcDbAuthor) << "Author details not found for author ID:" << authorId;
         return details;
     }
 
-    const QString booksSql = getSqlQuery("GetAuthorBooksForDisplay");
-    if (booksSql.isEmpty()) return details;
-
-    QSqlQuery booksQuery(m_db);
-     if (!booksQuery.prepare(booksSql)) {
-        qCritical() << "Помилка підготовки запиту 'GetAuthorBooksForDisplay':" << booksQuery.lastError().text();
+    CachedStatement booksQuery = preparedQuery(SqlQueryId::GetAuthorBooksForDisplay, db);
+    QueryTrace booksTrace(m_queryStats, "GetAuthorBooksForDisplay");
+    if (!booksQuery) return details;
+    booksQuery->bindValue(SqlParam::GetAuthorBooksForDisplay::authorId, authorId);
+
+    qCInfo(lcDbAuthor) << "Executing SQL 'GetAuthorBooksForDisplay' for author ID:" << authorId;
+    if (!booksTrace.exec(*booksQuery)) {
+        qCCritical(lcDbAuthor) << "Помилка при виконанні 'GetAuthorBooksForDisplay' для автора ID '" << authorId << "':";
+        qCCritical(lcDbAuthor) << booksQuery->lastError().text();
+        qCCritical(lcDbAuthor) << "SQL запит:" << booksQuery->lastQuery();
+        // Неповний результат (без книг) не кешуємо
         return details;
-    }
-    booksQuery.bindValue(":authorId", authorId);
-
-    qInfo() << "Executing SQL 'GetAuthorBooksForDisplay' for author ID:" << authorId;
-    if (!booksQuery.exec()) {
-        qCritical() << "Помилка при виконанні 'GetAuthorBooksForDisplay' для автора ID '" << authorId << "':";
-        qCritical() << booksQuery.lastError().text();
-        qCritical() << "SQL запит:" << booksQuery.lastQuery();
     } else {
-        qInfo() << "Successfully fetched books for author ID:" << authorId << ". Processing results...";
-        int count = 0;
-        while (booksQuery.next()) {
-            BookDisplayInfo bookInfo;
-            bookInfo.bookId = booksQuery.value("book_id").toInt();
-            bookInfo.title = booksQuery.value("title").toString();
-            bookInfo.price = booksQuery.value("price").toDouble();
-            bookInfo.coverImagePath = booksQuery.value("cover_image_path").toString();
-            bookInfo.stockQuantity = booksQuery.value("stock_quantity").toInt();
-            bookInfo.authors = booksQuery.value("authors").toString();
-            bookInfo.genre = booksQuery.value("genre").toString();
-            bookInfo.found = true;
-
-            if (booksQuery.value("authors").isNull()) {
-                 bookInfo.authors = "";
-            }
-            details.books.append(bookInfo);
-            count++;
-        }
-         qInfo() << "Processed" << count << "books for author ID:" << authorId;
+        qCInfo(lcDbAuthor) << "Successfully fetched books for author ID:" << authorId << ". Processing results...";
+        details.books = readAllRows<BookDisplayInfo>(*booksQuery);
+        qCInfo(lcDbAuthor) << "Processed" << details.books.size() << "books for author ID:" << authorId;
     }
 
+    m_resultCache.insert(cacheKey, details);
     return details;
 }
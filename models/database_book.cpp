@@ -1,121 +1,207 @@
 #include "database.h"
+#include "logging.h"
 #include <QDebug>
 #include <QSqlDatabase>
 #include <QSqlError>
 #include <QSqlQuery>
+#include <QSqlRecord>
 #include <QVariant>
 #include <QStringList>
 #include <QDate>
-
-QList<BookDisplayInfo> DatabaseManager::getAllBooksForDisplay(int limit, int offset) const
+#include <QJsonDocument>
+#include <QJsonObject>
+#include "pgarray.h"
+#include "rowmapper.h"
+
+namespace {
+
+// Умови фільтра окремо для кожної вимірності; порожній рядок - умови немає.
+// Списки жанрів/мов прив'язуються одним масивом, тож текст запиту залежить лише від набору
+// активних фільтрів (shapeKey) і його можна кешувати як підготовлений.
+struct FilterDimensionConditions {
+    QString genre;
+    QString language;
+    QString price;
+    QString stock;
+};
+
+FilterDimensionConditions filterDimensionConditions(const BookFilterCriteria &criteria,
+                                                    QMap<QString, QVariant> &bindValues, QString &shapeKey)
 {
-    QList<BookDisplayInfo> books;
-    if (!m_isConnected || !m_db.isOpen()) {
-        qWarning() << "Неможливо отримати книги: немає активного з'єднання з БД.";
-        return books;
+    FilterDimensionConditions conditions;
+    if (!criteria.genres.isEmpty()) {
+        conditions.genre = "b.genre = ANY(CAST(:genres AS TEXT[]))";
+        bindValues[":genres"] = toPgTextArray(criteria.genres);
+        shapeKey += 'g';
+    }
+    if (!criteria.languages.isEmpty()) {
+        conditions.language = "b.language = ANY(CAST(:languages AS TEXT[]))";
+        bindValues[":languages"] = toPgTextArray(criteria.languages);
+        shapeKey += 'l';
+    }
+    QStringList priceConditions;
+    if (criteria.minPrice >= 0.0) {
+        priceConditions << "b.price >= :minPrice";
+        bindValues[":minPrice"] = criteria.minPrice;
+        shapeKey += 'n';
+    }
+    if (criteria.maxPrice >= 0.0) {
+        priceConditions << "b.price <= :maxPrice";
+        bindValues[":maxPrice"] = criteria.maxPrice;
+        shapeKey += 'x';
     }
+    conditions.price = priceConditions.join(" AND ");
+    if (criteria.inStockOnly) {
+        conditions.stock = "b.stock_quantity > 0";
+        shapeKey += 's';
+    }
+    return conditions;
+}
 
-    QString sql = getSqlQuery("GetAllBooksForDisplay");
-    if (sql.isEmpty()) {
-        qCritical() << "SQL запит 'GetAllBooksForDisplay' не знайдено.";
-        return books;
+// Додає умови фільтра для WHERE
+void appendFilterConditions(const BookFilterCriteria &criteria, QStringList &conditions,
+                            QMap<QString, QVariant> &bindValues, QString &shapeKey)
+{
+    const FilterDimensionConditions dimensions = filterDimensionConditions(criteria, bindValues, shapeKey);
+    for (const QString &condition : {dimensions.genre, dimensions.language, dimensions.price, dimensions.stock}) {
+        if (!condition.isEmpty()) {
+            conditions << condition;
+        }
     }
+}
 
-    // Додаємо LIMIT та OFFSET, якщо вони вказані
-    if (limit > 0) {
-        sql += QString(" LIMIT %1 OFFSET %2").arg(limit).arg(offset);
+// Вирази ключа сортування; ті самі вирази використовуються в індексах
+QString sortKeyExpression(BookSortOrder sortOrder)
+{
+    switch (sortOrder) {
+    case BookSortOrder::Price:  return "COALESCE(b.price, 0)";
+    case BookSortOrder::Newest: return "COALESCE(b.publication_date, DATE '0001-01-01')";
+    case BookSortOrder::Title:
+    default:                    return "b.title";
     }
+}
 
-    QSqlQuery query(m_db);
-    qInfo() << "Виконання SQL 'GetAllBooksForDisplay' для отримання книг для відображення...";
-    qDebug() << "SQL запит:" << sql; // Для налагодження
+QString orderByClause(BookSortOrder sortOrder)
+{
+    const QString direction = (sortOrder == BookSortOrder::Newest) ? " DESC" : "";
+    return sortKeyExpression(sortOrder) + direction + ", b.book_id" + direction;
+}
 
-    if (!query.exec(sql)) {
-        qCritical() << "Помилка при виконанні 'GetAllBooksForDisplay':";
-        qCritical() << query.lastError().text();
-        qCritical() << "SQL запит:" << sql;
-        return books;
+QString seekCondition(BookSortOrder sortOrder)
+{
+    switch (sortOrder) {
+    case BookSortOrder::Price:
+        return QString("(%1, b.book_id) > (CAST(:after_key AS NUMERIC), :after_id)").arg(sortKeyExpression(sortOrder));
+    case BookSortOrder::Newest:
+        return QString("(%1, b.book_id) < (CAST(:after_key AS DATE), :after_id)").arg(sortKeyExpression(sortOrder));
+    case BookSortOrder::Title:
+    default:
+        return QString("(%1, b.book_id) > (CAST(:after_key AS VARCHAR), :after_id)").arg(sortKeyExpression(sortOrder));
     }
+}
 
-    qInfo() << "Книги успішно отримано. Обробка результатів...";
-    int count = 0;
-    while (query.next()) {
-        BookDisplayInfo bookInfo;
-        bookInfo.bookId = query.value("book_id").toInt();
-        bookInfo.title = query.value("title").toString();
-        bookInfo.price = query.value("price").toDouble();
-        bookInfo.coverImagePath = query.value("cover_image_path").toString();
-        bookInfo.stockQuantity = query.value("stock_quantity").toInt();
-        bookInfo.authors = query.value("authors").toString();
-        bookInfo.genre = query.value("genre").toString();
-        bookInfo.found = true;
-
-        if (query.value("authors").isNull()) {
-            bookInfo.authors = "";
-        }
+// Токен сторінки: base64url(JSON {"s": порядок, "k": ключ сортування, "id": book_id})
+QString encodePageToken(BookSortOrder sortOrder, const QString &key, int bookId)
+{
+    QJsonObject obj;
+    obj["s"] = static_cast<int>(sortOrder);
+    obj["k"] = key;
+    obj["id"] = bookId;
+    return QString::fromLatin1(QJsonDocument(obj).toJson(QJsonDocument::Compact)
+                                   .toBase64(QByteArray::Base64UrlEncoding | QByteArray::OmitTrailingEquals));
+}
 
+bool decodePageToken(const QString &token, BookSortOrder sortOrder, QString &key, int &bookId)
+{
+    const QByteArray json = QByteArray::fromBase64(token.toLatin1(), QByteArray::Base64UrlEncoding | QByteArray::OmitTrailingEquals);
+    const QJsonObject obj = QJsonDocument::fromJson(json).object();
+    if (obj.isEmpty() || obj.value("s").toInt(-1) != static_cast<int>(sortOrder) || !obj.contains("k") || !obj.contains("id")) {
+        return false;
+    }
+    key = obj.value("k").toString();
+    bookId = obj.value("id").toInt();
+    return true;
+}
 
-        books.append(bookInfo);
-        count++;
+// Текст GetBooksPageBase для фільтра, порядку і токена (keyset-умова після першої сторінки).
+// Спільний для getFilteredBooksPage і explainBooksPage, тож пояснюється той самий запит.
+QString booksPageSql(QString sql, const BookFilterCriteria &criteria, BookSortOrder sortOrder, int pageSize,
+                     const QString &pageToken, QMap<QString, QVariant> &bindValues, QString &shapeKey)
+{
+    QStringList whereConditions;
+    appendFilterConditions(criteria, whereConditions, bindValues, shapeKey);
+
+    QString afterKey;
+    int afterId = 0;
+    if (!pageToken.isEmpty()) {
+        if (decodePageToken(pageToken, sortOrder, afterKey, afterId)) {
+            whereConditions << seekCondition(sortOrder);
+            bindValues[":after_key"] = afterKey;
+            bindValues[":after_id"] = afterId;
+            shapeKey += 'k';
+        } else {
+            qCWarning(lcDbBook) << "getFilteredBooksPage: недійсний токен сторінки або інший порядок сортування, повертаємо першу сторінку.";
+        }
     }
-    qInfo() << "Оброблено" << count << "книг для відображення.";
+    // Беремо на один рядок більше, щоб дізнатися, чи є наступна сторінка
+    bindValues[":page_limit"] = pageSize + 1;
 
-    return books;
+    sql.replace("/*WHERE*/", whereConditions.isEmpty() ? QString() : "WHERE " + whereConditions.join(" AND "));
+    sql.replace("/*ORDER*/", orderByClause(sortOrder));
+    return sql;
 }
 
+} // namespace
 
-QList<BookDisplayInfo> DatabaseManager::getFilteredBooksForDisplay(const BookFilterCriteria &criteria) const
+QList<BookDisplayInfo> DatabaseManager::getAllBooksForDisplay(int limit, int offset) const
 {
     QList<BookDisplayInfo> books;
-    if (!m_isConnected || !m_db.isOpen()) {
-        qWarning() << "Неможливо отримати відфільтровані книги: немає активного з'єднання з БД.";
+    QSqlDatabase db = connection();
+    if (!m_isConnected || !db.isOpen()) {
+        qCWarning(lcDbBook) << "Неможливо отримати книги: немає активного з'єднання з БД.";
         return books;
     }
 
-    QString sqlBase = getSqlQuery("GetFilteredBooksForDisplayBase");
-    if (sqlBase.isEmpty()) {
-        qCritical() << "SQL запит 'GetFilteredBooksForDisplayBase' не знайдено.";
+    // LIMIT/OFFSET прив'язуються параметрами, тож запит готується один раз.
+    // Для глибоких сторінок використовуйте getAllBooksPage (keyset).
+    CachedStatement query = preparedQuery(SqlQueryId::GetAllBooksForDisplay, db);
+    QueryTrace trace(m_queryStats, "GetAllBooksForDisplay");
+    if (!query) return books;
+    query->bindValue(SqlParam::GetAllBooksForDisplay::limit, limit > 0 ? QVariant(limit) : QVariant(QMetaType::fromType<int>())); // NULL = без обмеження
+    query->bindValue(SqlParam::GetAllBooksForDisplay::offset, qMax(0, offset));
+
+    qCInfo(lcDbBook) << "Виконання SQL 'GetAllBooksForDisplay' для отримання книг для відображення...";
+    if (!trace.exec(*query)) {
+        qCCritical(lcDbBook) << "Помилка при виконанні 'GetAllBooksForDisplay':";
+        qCCritical(lcDbBook) << query->lastError().text();
+        qCCritical(lcDbBook) << "SQL запит:" << query->lastQuery();
         return books;
     }
 
-    QString sql = sqlBase;
-
-    QStringList whereConditions;
-    QMap<QString, QVariant> bindValues;
+    qCInfo(lcDbBook) << "Книги успішно отримано. Обробка результатів...";
+    books = readAllRows<BookDisplayInfo>(*query);
+    qCInfo(lcDbBook) << "Оброблено" << books.size() << "книг для відображення.";
 
-    if (!criteria.genres.isEmpty()) {
-        QStringList genrePlaceholders;
-        for (int i = 0; i < criteria.genres.size(); ++i) {
-            QString placeholder = QString(":genre_%1").arg(i);
-            genrePlaceholders << placeholder;
-            bindValues[placeholder] = criteria.genres[i];
-        }
-        whereConditions << QString("b.genre IN (%1)").arg(genrePlaceholders.join(", "));
-    }
+    return books;
+}
 
-    if (!criteria.languages.isEmpty()) {
-        QStringList langPlaceholders;
-        for (int i = 0; i < criteria.languages.size(); ++i) {
-            QString placeholder = QString(":lang_%1").arg(i);
-            langPlaceholders << placeholder;
-            bindValues[placeholder] = criteria.languages[i];
-        }
-        whereConditions << QString("b.language IN (%1)").arg(langPlaceholders.join(", "));
-    }
 
-    if (criteria.minPrice >= 0.0) {
-        whereConditions << "b.price >= :minPrice";
-        bindValues[":minPrice"] = criteria.minPrice;
+QList<BookDisplayInfo> DatabaseManager::getFilteredBooksForDisplay(const BookFilterCriteria &criteria) const
+{
+    QList<BookDisplayInfo> books;
+    QSqlDatabase db = connection();
+    if (!m_isConnected || !db.isOpen()) {
+        qCWarning(lcDbBook) << "Неможливо отримати відфільтровані книги: немає активного з'єднання з БД.";
+        return books;
     }
 
-    if (criteria.maxPrice >= 0.0) {
-        whereConditions << "b.price <= :maxPrice";
-        bindValues[":maxPrice"] = criteria.maxPrice;
-    }
+    // Умови WHERE додаються в коді, тому беремо текст з іменованими параметрами
+    QString sql = getSqlQuery(SqlQueryId::GetFilteredBooksForDisplayBase);
 
-    if (criteria.inStockOnly) {
-        whereConditions << "b.stock_quantity > 0";
-    }
+    QStringList whereConditions;
+    QMap<QString, QVariant> bindValues;
+    QString shapeKey;
+    appendFilterConditions(criteria, whereConditions, bindValues, shapeKey);
 
     if (!whereConditions.isEmpty()) {
         sql += "\nWHERE " + whereConditions.join(" AND ");
@@ -123,170 +209,315 @@ QList<BookDisplayInfo> DatabaseManager::getFilteredBooksForDisplay(const BookFil
 
     sql += R"(
         GROUP BY b.book_id, b.title, b.price, b.cover_image_path, b.stock_quantity, b.genre, b.language, p.name
-        ORDER BY b.title;
+        ORDER BY b.title, b.book_id;
     )";
 
-    QSqlQuery query(m_db);
-    query.prepare(sql);
+    CachedStatement query = preparedQuery("GetFilteredBooksForDisplay/" + shapeKey, sql, db);
+    QueryTrace trace(m_queryStats, "GetFilteredBooksForDisplay");
+    if (!query) return books;
 
     for (auto it = bindValues.constBegin(); it != bindValues.constEnd(); ++it) {
-        query.bindValue(it.key(), it.value());
+        query->bindValue(it.key(), it.value());
     }
 
-    qInfo() << "Виконання SQL для отримання відфільтрованих книг...";
-    qDebug() << "SQL:" << sql;
-    qDebug() << "Прив'язані значення:" << bindValues;
+    qCInfo(lcDbBook) << "Виконання SQL для отримання відфільтрованих книг...";
+    qCDebug(lcDbBook) << "SQL:" << sql;
+    qCDebug(lcDbBook) << "Прив'язані значення:" << bindValues;
 
-    if (!query.exec()) {
-        qCritical() << "Помилка при отриманні відфільтрованого списку книг:";
-        qCritical() << query.lastError().text();
-        qCritical() << "SQL запит:" << query.lastQuery();
+    if (!trace.exec(*query)) {
+        qCCritical(lcDbBook) << "Помилка при отриманні відфільтрованого списку книг:";
+        qCCritical(lcDbBook) << query->lastError().text();
+        qCCritical(lcDbBook) << "SQL запит:" << query->lastQuery();
         return books;
     }
 
-    qInfo() << "Відфільтровані книги успішно отримано. Обробка результатів...";
-    int count = 0;
-    while (query.next()) {
-        BookDisplayInfo bookInfo;
-        bookInfo.bookId = query.value("book_id").toInt();
-        bookInfo.title = query.value("title").toString();
-        bookInfo.price = query.value("price").toDouble();
-        bookInfo.coverImagePath = query.value("cover_image_path").toString();
-        bookInfo.stockQuantity = query.value("stock_quantity").toInt();
-        bookInfo.authors = query.value("authors").toString();
-        bookInfo.genre = query.value("genre").toString();
-
-        bookInfo.found = true;
-
-        if (query.value("authors").isNull()) {
-            bookInfo.authors = "";
+    qCInfo(lcDbBook) << "Відфільтровані книги успішно отримано. Обробка результатів...";
+    books = readAllRows<BookDisplayInfo>(*query);
+    qCInfo(lcDbBook) << "Оброблено" << books.size() << "відфільтрованих книг.";
+
+    return books;
+}
+
+BookPage DatabaseManager::getFilteredBooksPage(const BookFilterCriteria &criteria, BookSortOrder sortOrder,
+                                               int pageSize, const QString &pageToken) const
+{
+    BookPage page;
+    QSqlDatabase db = connection();
+    if (!m_isConnected || !db.isOpen() || pageSize <= 0) {
+        qCWarning(lcDbBook) << "Неможливо отримати сторінку книг: немає з'єднання з БД або невірний розмір сторінки.";
+        return page;
+    }
+
+    QMap<QString, QVariant> bindValues;
+    QString shapeKey;
+    const QString sql = booksPageSql(getSqlQuery(SqlQueryId::GetBooksPageBase), criteria, sortOrder, pageSize,
+                                     pageToken, bindValues, shapeKey);
+
+    const QString cacheKey = QString("GetBooksPage/%1/%2").arg(static_cast<int>(sortOrder)).arg(shapeKey);
+    CachedStatement query = preparedQuery(cacheKey, sql, db);
+    QueryTrace trace(m_queryStats, "GetBooksPage");
+    if (!query) return page;
+
+    for (auto it = bindValues.constBegin(); it != bindValues.constEnd(); ++it) {
+        query->bindValue(it.key(), it.value());
+    }
+
+    qCInfo(lcDbBook) << "Виконання SQL 'GetBooksPageBase' (розмір сторінки" << pageSize << ")...";
+    if (!trace.exec(*query)) {
+        qCCritical(lcDbBook) << "Помилка при отриманні сторінки книг:";
+        qCCritical(lcDbBook) << query->lastError().text();
+        qCCritical(lcDbBook) << "SQL запит:" << query->lastQuery();
+        return page;
+    }
+
+    const RowMapper<BookDisplayInfo> mapper(*query);
+    const int priceIndex = query->record().indexOf("price");
+    const int publicationDateIndex = query->record().indexOf("publication_date");
+    QString lastKey;
+    while (query->next()) {
+        if (page.books.size() == pageSize) {
+            page.hasMore = true;
+            break;
+        }
+        const BookDisplayInfo bookInfo = mapper.read(*query);
+
+        // Ключ сортування останнього рядка - у тому ж вигляді, що й вираз у seekCondition
+        switch (sortOrder) {
+        case BookSortOrder::Price:
+            lastKey = query->isNull(priceIndex) ? QString("0") : query->value(priceIndex).toString();
+            break;
+        case BookSortOrder::Newest:
+            lastKey = query->isNull(publicationDateIndex) ? QString("0001-01-01")
+                                                          : query->value(publicationDateIndex).toDate().toString(Qt::ISODate);
+            break;
+        case BookSortOrder::Title:
+        default:
+            lastKey = bookInfo.title;
+            break;
         }
 
-        books.append(bookInfo);
-        count++;
+        page.books.append(bookInfo);
     }
-    qInfo() << "Оброблено" << count << "відфільтрованих книг.";
 
-    return books;
+    if (page.hasMore && !page.books.isEmpty()) {
+        page.nextPageToken = encodePageToken(sortOrder, lastKey, page.books.last().bookId);
+    }
+    qCInfo(lcDbBook) << "Отримано сторінку з" << page.books.size() << "книг, є наступна:" << page.hasMore;
+    return page;
+}
+
+BookPage DatabaseManager::getAllBooksPage(BookSortOrder sortOrder, int pageSize, const QString &pageToken) const
+{
+    return getFilteredBooksPage(BookFilterCriteria(), sortOrder, pageSize, pageToken);
+}
+
+QJsonArray DatabaseManager::explainBooksPage(const BookFilterCriteria &criteria, BookSortOrder sortOrder,
+                                             int pageSize, const QString &pageToken) const
+{
+    QMap<QString, QVariant> bindValues;
+    QString shapeKey;
+    const QString sql = booksPageSql(getSqlQuery(SqlQueryId::GetBooksPageBase), criteria, sortOrder, pageSize,
+                                     pageToken, bindValues, shapeKey);
+    return explainSql(QString("GetBooksPage/%1/%2").arg(static_cast<int>(sortOrder)).arg(shapeKey), sql, bindValues);
 }
 
 QStringList DatabaseManager::getAllGenres() const
 {
     QStringList genres;
-    if (!m_isConnected || !m_db.isOpen()) {
-        qWarning() << "Неможливо отримати жанри: немає активного з'єднання з БД.";
+    QSqlDatabase db = connection();
+    if (!m_isConnected || !db.isOpen()) {
+        qCWarning(lcDbBook) << "Неможливо отримати жанри: немає активного з'єднання з БД.";
         return genres;
     }
 
-    const QString sql = getSqlQuery("GetAllDistinctGenres");
-    if (sql.isEmpty()) {
-        qCritical() << "SQL запит 'GetAllDistinctGenres' не знайдено.";
+    const QueryCacheKey cacheKey = m_resultCache.prepare("GetAllDistinctGenres", {}, {"book"});
+    if (m_resultCache.lookup(cacheKey, &genres)) {
         return genres;
     }
 
-    QSqlQuery query(m_db);
-    qInfo() << "Виконання SQL 'GetAllDistinctGenres' для отримання всіх унікальних жанрів...";
-    if (!query.exec(sql)) {
-        qCritical() << "Помилка при виконанні 'GetAllDistinctGenres':";
-        qCritical() << query.lastError().text();
-        qCritical() << "SQL запит:" << sql;
+    CachedStatement query = preparedQuery(SqlQueryId::GetAllDistinctGenres, db);
+    QueryTrace trace(m_queryStats, "GetAllDistinctGenres");
+    if (!query) return genres;
+    qCInfo(lcDbBook) << "Виконання SQL 'GetAllDistinctGenres' для отримання всіх унікальних жанрів...";
+    if (!trace.exec(*query)) {
+        qCCritical(lcDbBook) << "Помилка при виконанні 'GetAllDistinctGenres':";
+        qCCritical(lcDbBook) << query->lastError().text();
+        qCCritical(lcDbBook) << "SQL запит:" << query->lastQuery();
         return genres;
     }
 
-    while (query.next()) {
-        genres.append(query.value(0).toString());
+    while (query->next()) {
+        genres.append(query->value(0).toString());
     }
-    qInfo() << "Отримано" << genres.size() << "унікальних жанрів.";
+    qCInfo(lcDbBook) << "Отримано" << genres.size() << "унікальних жанрів.";
+    m_resultCache.insert(cacheKey, genres);
     return genres;
 }
 
 QStringList DatabaseManager::getAllLanguages() const
 {
     QStringList languages;
-    if (!m_isConnected || !m_db.isOpen()) {
-        qWarning() << "Неможливо отримати мови: немає активного з'єднання з БД.";
+    QSqlDatabase db = connection();
+    if (!m_isConnected || !db.isOpen()) {
+        qCWarning(lcDbBook) << "Неможливо отримати мови: немає активного з'єднання з БД.";
         return languages;
     }
 
-    const QString sql = getSqlQuery("GetAllDistinctLanguages");
-    if (sql.isEmpty()) {
-        qCritical() << "SQL запит 'GetAllDistinctLanguages' не знайдено.";
+    const QueryCacheKey cacheKey = m_resultCache.prepare("GetAllDistinctLanguages", {}, {"book"});
+    if (m_resultCache.lookup(cacheKey, &languages)) {
         return languages;
     }
 
-    QSqlQuery query(m_db);
-    qInfo() << "Виконання SQL 'GetAllDistinctLanguages' для отримання всіх унікальних мов...";
-    if (!query.exec(sql)) {
-        qCritical() << "Помилка при виконанні 'GetAllDistinctLanguages':";
-        qCritical() << query.lastError().text();
-        qCritical() << "SQL запит:" << sql;
+    CachedStatement query = preparedQuery(SqlQueryId::GetAllDistinctLanguages, db);
+    QueryTrace trace(m_queryStats, "GetAllDistinctLanguages");
+    if (!query) return languages;
+    qCInfo(lcDbBook) << "Виконання SQL 'GetAllDistinctLanguages' для отримання всіх унікальних мов...";
+    if (!trace.exec(*query)) {
+        qCCritical(lcDbBook) << "Помилка при виконанні 'GetAllDistinctLanguages':";
+        qCCritical(lcDbBook) << query->lastError().text();
+        qCCritical(lcDbBook) << "SQL запит:" << query->lastQuery();
         return languages;
     }
 
-    while (query.next()) {
-        languages.append(query.value(0).toString());
+    while (query->next()) {
+        languages.append(query->value(0).toString());
     }
-    qInfo() << "Отримано" << languages.size() << "унікальних мов.";
+    qCInfo(lcDbBook) << "Отримано" << languages.size() << "унікальних мов.";
+    m_resultCache.insert(cacheKey, languages);
     return languages;
 }
 
-BookDetailsInfo DatabaseManager::getBookDetails(int bookId) const
+BookFacetCounts DatabaseManager::getBookFacetCounts(const BookFilterCriteria &criteria) const
 {
-    BookDetailsInfo details;
-    details.found = false;
-    if (!m_isConnected || !m_db.isOpen() || bookId <= 0) {
-        qWarning() << "Неможливо отримати деталі книги: немає з'єднання або невірний bookId.";
-        return details;
+    BookFacetCounts facets;
+    QSqlDatabase db = connection();
+    if (!m_isConnected || !db.isOpen()) {
+        qCWarning(lcDbBook) << "Неможливо отримати фасети фільтрів: немає активного з'єднання з БД.";
+        return facets;
     }
 
-    const QString sql = getSqlQuery("GetBookDetailsById");
-    if (sql.isEmpty()) {
-        qCritical() << "SQL запит 'GetBookDetailsById' не знайдено.";
-        return details;
+    const QueryCacheKey cacheKey = m_resultCache.prepare("GetBookFacetCounts",
+        {toPgTextArray(criteria.genres), toPgTextArray(criteria.languages), criteria.minPrice, criteria.maxPrice,
+         criteria.inStockOnly}, {"book"});
+    if (m_resultCache.lookup(cacheKey, &facets)) {
+        return facets;
     }
 
-    QSqlQuery query(m_db);
-    if (!query.prepare(sql)) {
-        qCritical() << "Помилка підготовки запиту 'GetBookDetailsById':" << query.lastError().text();
+    QMap<QString, QVariant> bindValues;
+    QString shapeKey;
+    const FilterDimensionConditions dimensions = filterDimensionConditions(criteria, bindValues, shapeKey);
+    bindValues[":bucket_width"] = BookFacetCounts::PriceBucketWidth;
+    bindValues[":last_bucket"] = BookFacetCounts::PriceBuckets - 1;
+
+    auto orTrue = [](const QString &condition) { return condition.isEmpty() ? QString("TRUE") : "(" + condition + ")"; };
+    QString sql = getSqlQuery(SqlQueryId::GetBookFacetCountsBase);
+    sql.replace("/*GENRE*/", orTrue(dimensions.genre));
+    sql.replace("/*LANGUAGE*/", orTrue(dimensions.language));
+    sql.replace("/*PRICE*/", orTrue(dimensions.price));
+    sql.replace("/*STOCK*/", orTrue(dimensions.stock));
+
+    CachedStatement query = preparedQuery("GetBookFacetCounts/" + shapeKey, sql, db);
+    QueryTrace trace(m_queryStats, "GetBookFacetCounts");
+    if (!query) return facets;
+
+    for (auto it = bindValues.constBegin(); it != bindValues.constEnd(); ++it) {
+        query->bindValue(it.key(), it.value());
+    }
+
+    qCInfo(lcDbBook) << "Виконання SQL 'GetBookFacetCountsBase' для фасетів фільтрів...";
+    qCDebug(lcDbBook) << "Прив'язані значення:" << bindValues;
+    if (!trace.exec(*query)) {
+        qCCritical(lcDbBook) << "Помилка при виконанні 'GetBookFacetCountsBase':";
+        qCCritical(lcDbBook) << query->lastError().text();
+        qCCritical(lcDbBook) << "SQL запит:" << query->lastQuery();
+        return facets;
+    }
+
+    for (int bucket = 0; bucket < BookFacetCounts::PriceBuckets; ++bucket) {
+        PriceBucketCount priceBucket;
+        priceBucket.minPrice = bucket * BookFacetCounts::PriceBucketWidth;
+        priceBucket.maxPrice = bucket + 1 < BookFacetCounts::PriceBuckets ? priceBucket.minPrice + BookFacetCounts::PriceBucketWidth : -1.0;
+        facets.priceBuckets.append(priceBucket);
+    }
+
+    const QSqlRecord record = query->record();
+    const int facetSetIndex = record.indexOf("facet_set");
+    const int genreIndex = record.indexOf("genre");
+    const int languageIndex = record.indexOf("language");
+    const int bucketIndex = record.indexOf("price_bucket");
+    const int genreCountIndex = record.indexOf("genre_count");
+    const int languageCountIndex = record.indexOf("language_count");
+    const int priceCountIndex = record.indexOf("price_count");
+    const int inStockCountIndex = record.indexOf("in_stock_count");
+    const int totalCountIndex = record.indexOf("total_count");
+    while (query->next()) {
+        // Бітова маска GROUPING(genre, language, price_bucket): 1 - стовпця немає в наборі
+        switch (query->value(facetSetIndex).toInt()) {
+        case 3:
+            if (!query->isNull(genreIndex)) {
+                facets.genres.append({query->value(genreIndex).toString(), query->value(genreCountIndex).toInt()});
+            }
+            break;
+        case 5:
+            if (!query->isNull(languageIndex)) {
+                facets.languages.append({query->value(languageIndex).toString(), query->value(languageCountIndex).toInt()});
+            }
+            break;
+        case 6:
+            if (!query->isNull(bucketIndex)) {
+                const int bucket = qBound(0, query->value(bucketIndex).toInt(), BookFacetCounts::PriceBuckets - 1);
+                facets.priceBuckets[bucket].count = query->value(priceCountIndex).toInt();
+            }
+            break;
+        case 7:
+            facets.inStock = query->value(inStockCountIndex).toInt();
+            facets.total = query->value(totalCountIndex).toInt();
+            break;
+        default:
+            break;
+        }
+    }
+    facets.found = true;
+    qCInfo(lcDbBook) << "Фасети:" << facets.genres.size() << "жанрів," << facets.languages.size() << "мов, за фільтрами"
+                     << facets.total << "книг.";
+    m_resultCache.insert(cacheKey, facets);
+    return facets;
+}
+
+BookDetailsInfo DatabaseManager::getBookDetails(int bookId) const
+{
+    BookDetailsInfo details;
+    details.found = false;
+    QSqlDatabase db = connection();
+    if (!m_isConnected || !db.isOpen() || bookId <= 0) {
+        qCWarning(lcDbBook) << "Неможливо отримати деталі книги: немає з'єднання або невірний bookId.";
         return details;
     }
-    query.bindValue(":bookId", bookId);
 
-    qInfo() << "Виконання SQL 'GetBookDetailsById' для ID книги:" << bookId;
-    if (!query.exec()) {
-        qCritical() << "Помилка при виконанні 'GetBookDetailsById' для book ID '" << bookId << "':";
-        qCritical() << query.lastError().text();
-        qCritical() << "SQL запит:" << query.lastQuery();
+    CachedStatement query = preparedQuery(SqlQueryId::GetBookDetailsById, db);
+    QueryTrace trace(m_queryStats, "GetBookDetailsById");
+    if (!query) return details;
+    query->bindValue(SqlParam::GetBookDetailsById::bookId, bookId);
+
+    qCInfo(lcDbBook) << "Виконання SQL 'GetBookDetailsById' для ID книги:" << bookId;
+    if (!trace.exec(*query)) {
+        qCCritical(lcDbBook) << "Помилка при виконанні 'GetBookDetailsById' для book ID '" << bookId << "':";
+        qCCritical(lcDbBook) << query->lastError().text();
+        qCCritical(lcDbBook) << "SQL запит:" << query->lastQuery();
         return details;
     }
 
-    if (query.next()) {
-        details.bookId = query.value("book_id").toInt();
-        details.title = query.value("title").toString();
-        details.price = query.value("price").toDouble();
-        details.coverImagePath = query.value("cover_image_path").toString();
-        details.stockQuantity = query.value("stock_quantity").toInt();
-        details.genre = query.value("genre").toString();
-        details.description = query.value("description").toString();
-        details.publicationDate = query.value("publication_date").toDate();
-        details.isbn = query.value("isbn").toString();
-        details.pageCount = query.value("page_count").toInt();
-        details.language = query.value("language").toString();
-        details.publisherName = query.value("publisher_name").toString();
-        details.authors = query.value("authors").toString();
-        if (query.value("authors").isNull()) {
-            details.authors = "";
-        }
-        details.found = true;
-        qInfo() << "Деталі книги знайдено для ID книги:" << bookId;
+    if (query->next()) {
+        RowMapper<BookDetailsInfo>(*query).readInto(*query, details);
+        qCInfo(lcDbBook) << "Деталі книги знайдено для ID книги:" << bookId;
     } else {
-        qInfo() << "Деталі книги не знайдено для ID книги:" << bookId;
+        qCInfo(lcDbBook) << "Деталі книги не знайдено для ID книги:" << bookId;
 
     }
-
+    trace.finish();
 
     details.comments = getBookComments(bookId);
-    qInfo() << "Отримано" << details.comments.size() << "коментарів для ID книги:" << bookId;
+    qCInfo(lcDbBook) << "Отримано" << details.comments.size() << "коментарів для ID книги:" << bookId;
 
 
     return details;
@@ -296,109 +527,118 @@ BookDisplayInfo DatabaseManager::getBookDisplayInfoById(int bookId) const
 {
     BookDisplayInfo bookInfo;
     bookInfo.found = false;
-    if (!m_isConnected || !m_db.isOpen() || bookId <= 0) {
-        qWarning() << "Неможливо отримати BookDisplayInfo: немає з'єднання або невірний bookId.";
+    QSqlDatabase db = connection();
+    if (!m_isConnected || !db.isOpen() || bookId <= 0) {
+        qCWarning(lcDbBook) << "Неможливо отримати BookDisplayInfo: немає з'єднання або невірний bookId.";
         return bookInfo;
     }
 
-    const QString sql = getSqlQuery("GetBookDisplayInfoById");
-    if (sql.isEmpty()) {
-        qCritical() << "SQL запит 'GetBookDisplayInfoById' не знайдено.";
+    CachedStatement query = preparedQuery(SqlQueryId::GetBookDisplayInfoById, db);
+    QueryTrace trace(m_queryStats, "GetBookDisplayInfoById");
+    if (!query) return bookInfo;
+    query->bindValue(SqlParam::GetBookDisplayInfoById::bookId, bookId);
+
+    qCInfo(lcDbBook) << "Виконання SQL 'GetBookDisplayInfoById' для ID книги:" << bookId;
+    if (!trace.exec(*query)) {
+        qCCritical(lcDbBook) << "Помилка при виконанні 'GetBookDisplayInfoById' для book ID '" << bookId << "':";
+        qCCritical(lcDbBook) << query->lastError().text();
+        qCCritical(lcDbBook) << "SQL запит:" << query->lastQuery();
         return bookInfo;
     }
 
-    QSqlQuery query(m_db);
-    if (!query.prepare(sql)) {
-        qCritical() << "Помилка підготовки запиту 'GetBookDisplayInfoById':" << query.lastError().text();
-        return bookInfo;
+    if (query->next()) {
+        bookInfo = RowMapper<BookDisplayInfo>(*query).read(*query);
+        qCInfo(lcDbBook) << "BookDisplayInfo знайдено для ID книги:" << bookId;
+    } else {
+        qCInfo(lcDbBook) << "BookDisplayInfo не знайдено для ID книги:" << bookId;
     }
-    query.bindValue(":bookId", bookId);
 
-    qInfo() << "Виконання SQL 'GetBookDisplayInfoById' для ID книги:" << bookId;
-    if (!query.exec()) {
-        qCritical() << "Помилка при виконанні 'GetBookDisplayInfoById' для book ID '" << bookId << "':";
-        qCritical() << query.lastError().text();
-        qCritical() << "SQL запит:" << query.lastQuery();
-        return bookInfo;
+    return bookInfo;
+}
+
+QMap<int, BookDisplayInfo> DatabaseManager::getBookDisplayInfoByIds(const QList<int> &bookIds) const
+{
+    QMap<int, BookDisplayInfo> books;
+    QSqlDatabase db = connection();
+    if (!m_isConnected || !db.isOpen()) {
+        qCWarning(lcDbBook) << "Неможливо отримати BookDisplayInfo для списку книг: немає активного з'єднання з БД.";
+        return books;
     }
 
-    if (query.next()) {
-        bookInfo.bookId = query.value("book_id").toInt();
-        bookInfo.title = query.value("title").toString();
-        bookInfo.price = query.value("price").toDouble();
-        bookInfo.coverImagePath = query.value("cover_image_path").toString();
-        bookInfo.stockQuantity = query.value("stock_quantity").toInt();
-        bookInfo.authors = query.value("authors").toString();
-        bookInfo.genre = query.value("genre").toString();
-        if (query.value("authors").isNull()) {
-            bookInfo.authors = "";
+    QList<int> uniqueIds;
+    uniqueIds.reserve(bookIds.size());
+    for (int bookId : bookIds) {
+        if (bookId > 0 && !uniqueIds.contains(bookId)) {
+            uniqueIds.append(bookId);
         }
-        bookInfo.found = true;
-        qInfo() << "BookDisplayInfo знайдено для ID книги:" << bookId;
-    } else {
-        qInfo() << "BookDisplayInfo не знайдено для ID книги:" << bookId;
+    }
+    if (uniqueIds.isEmpty()) {
+        return books;
     }
 
-    return bookInfo;
+    CachedStatement query = preparedQuery(SqlQueryId::GetBookDisplayInfoByIds, db);
+    QueryTrace trace(m_queryStats, "GetBookDisplayInfoByIds");
+    if (!query) return books;
+    query->bindValue(SqlParam::GetBookDisplayInfoByIds::bookIds, toPgIntArray(uniqueIds));
+
+    qCInfo(lcDbBook) << "Виконання SQL 'GetBookDisplayInfoByIds' для" << uniqueIds.size() << "книг(и)";
+    if (!trace.exec(*query)) {
+        qCCritical(lcDbBook) << "Помилка при виконанні 'GetBookDisplayInfoByIds':";
+        qCCritical(lcDbBook) << query->lastError().text();
+        qCCritical(lcDbBook) << "SQL запит:" << query->lastQuery();
+        return books;
+    }
+
+    const RowMapper<BookDisplayInfo> mapper(*query);
+    while (query->next()) {
+        const BookDisplayInfo bookInfo = mapper.read(*query);
+        books.insert(bookInfo.bookId, bookInfo);
+    }
+    qCInfo(lcDbBook) << "BookDisplayInfo знайдено для" << books.size() << "з" << uniqueIds.size() << "книг(и)";
+
+    return books;
 }
 
 QList<BookDisplayInfo> DatabaseManager::getBooksByGenre(const QString &genre, int limit) const
 {
     QList<BookDisplayInfo> books;
-    if (!m_isConnected || !m_db.isOpen()) {
-        qWarning() << "Неможливо отримати книги за жанром: немає активного з'єднання з БД.";
+    QSqlDatabase db = connection();
+    if (!m_isConnected || !db.isOpen()) {
+        qCWarning(lcDbBook) << "Неможливо отримати книги за жанром: немає активного з'єднання з БД.";
         return books;
     }
     if (genre.isEmpty()) {
-        qWarning() << "Неможливо отримати книги: не вказано жанр.";
+        qCWarning(lcDbBook) << "Неможливо отримати книги: не вказано жанр.";
         return books;
     }
 
-    const QString sql = getSqlQuery("GetBooksByGenre");
-    if (sql.isEmpty()) {
-        qCritical() << "SQL запит 'GetBooksByGenre' не знайдено.";
+    const int effectiveLimit = limit > 0 ? limit : 10;
+    const QueryCacheKey cacheKey = m_resultCache.prepare("GetBooksByGenre", {genre, effectiveLimit},
+                                                         {"book", "author", "book_author", "publisher"});
+    if (m_resultCache.lookup(cacheKey, &books)) {
         return books;
     }
 
-    QSqlQuery query(m_db);
-    if (!query.prepare(sql)) {
-        qCritical() << "Помилка підготовки запиту 'GetBooksByGenre':" << query.lastError().text();
-        return books;
-    }
-    query.bindValue(":genre", genre);
-    query.bindValue(":limit", limit > 0 ? limit : 10);
+    CachedStatement query = preparedQuery(SqlQueryId::GetBooksByGenre, db);
+    QueryTrace trace(m_queryStats, "GetBooksByGenre");
+    if (!query) return books;
+    query->bindValue(SqlParam::GetBooksByGenre::genre, genre);
+    query->bindValue(SqlParam::GetBooksByGenre::limit, effectiveLimit);
 
-    qInfo() << "Виконання SQL 'GetBooksByGenre' для жанру:" << genre << "з лімітом:" << query.boundValue(":limit").toInt();
-    if (!query.exec()) {
-        qCritical() << "Помилка при виконанні 'GetBooksByGenre' для жанру '" << genre << "':";
-        qCritical() << query.lastError().text();
-        qCritical() << "SQL запит:" << query.lastQuery();
-        qCritical() << "Прив'язані значення:" << query.boundValues();
+    qCInfo(lcDbBook) << "Виконання SQL 'GetBooksByGenre' для жанру:" << genre << "з лімітом:" << query->boundValue(SqlParam::GetBooksByGenre::limit).toInt();
+    if (!trace.exec(*query)) {
+        qCCritical(lcDbBook) << "Помилка при виконанні 'GetBooksByGenre' для жанру '" << genre << "':";
+        qCCritical(lcDbBook) << query->lastError().text();
+        qCCritical(lcDbBook) << "SQL запит:" << query->lastQuery();
+        qCCritical(lcDbBook) << "Прив'язані значення:" << query->boundValues();
         return books;
     }
 
-    qInfo() << "Книги за жанром" << genre << "успішно отримано. Обробка результатів...";
-    int count = 0;
-    while (query.next()) {
-        BookDisplayInfo bookInfo;
-        bookInfo.bookId = query.value("book_id").toInt();
-        bookInfo.title = query.value("title").toString();
-        bookInfo.price = query.value("price").toDouble();
-        bookInfo.coverImagePath = query.value("cover_image_path").toString();
-        bookInfo.stockQuantity = query.value("stock_quantity").toInt();
-        bookInfo.authors = query.value("authors").toString();
-        bookInfo.genre = query.value("genre").toString();
-        bookInfo.found = true;
-
-        if (query.value("authors").isNull()) {
-            bookInfo.authors = "";
-        }
-
-        books.append(bookInfo);
-        count++;
-    }
-    qInfo() << "Оброблено" << count << "книг за жанром" << genre;
+    qCInfo(lcDbBook) << "Книги за жанром" << genre << "успішно отримано. Обробка результатів...";
+    books = readAllRows<BookDisplayInfo>(*query);
+    qCInfo(lcDbBook) << "Оброблено" << books.size() << "книг за жанром" << genre;
 
+    m_resultCache.insert(cacheKey, books);
     return books;
 }
 
@@ -406,138 +646,276 @@ QList<SearchSuggestionInfo> DatabaseManager::getSearchSuggestions(const QString
 {
     QList<SearchSuggestionInfo> suggestions;
 
-    if (!m_isConnected || !m_db.isOpen() || prefix.isEmpty()) {
-        qWarning() << "Неможливо отримати пропозиції пошуку: немає з'єднання або префікс порожній.";
-        return suggestions;
-    }
-
-    const QString sql = getSqlQuery("GetSearchSuggestions");
-    if (sql.isEmpty()) {
-        qCritical() << "SQL запит 'GetSearchSuggestions' не знайдено.";
+    QSqlDatabase db = connection();
+    if (!m_isConnected || !db.isOpen() || prefix.isEmpty()) {
+        qCWarning(lcDbBook) << "Неможливо отримати пропозиції пошуку: немає з'єднання або префікс порожній.";
         return suggestions;
     }
 
-    QSqlQuery query(m_db);
-    if (!query.prepare(sql)) {
-        qCritical() << "Помилка підготовки запиту 'GetSearchSuggestions':" << query.lastError().text();
-        return suggestions;
-    }
-    query.bindValue(":prefix", prefix);
-    query.bindValue(":total_limit", limit > 0 ? limit : 10);
+    CachedStatement query = preparedQuery(SqlQueryId::GetSearchSuggestions, db);
+    QueryTrace trace(m_queryStats, "GetSearchSuggestions");
+    if (!query) return suggestions;
+    query->bindValue(SqlParam::GetSearchSuggestions::prefix, prefix);
+    query->bindValue(SqlParam::GetSearchSuggestions::total_limit, limit > 0 ? limit : 10);
 
-    qInfo() << "Виконання SQL 'GetSearchSuggestions' для префікса:" << prefix << "з лімітом:" << query.boundValue(":total_limit").toInt();
-    if (!query.exec()) {
-        qCritical() << "Помилка при виконанні 'GetSearchSuggestions' для префікса '" << prefix << "':";
-        qCritical() << query.lastError().text();
-        qCritical() << "SQL запит:" << query.lastQuery();
-        qCritical() << "Прив'язані значення:" << query.boundValues();
+    qCInfo(lcDbBook) << "Виконання SQL 'GetSearchSuggestions' для префікса:" << prefix << "з лімітом:" << query->boundValue(SqlParam::GetSearchSuggestions::total_limit).toInt();
+    if (!trace.exec(*query)) {
+        if (query->lastError().nativeErrorCode() == QLatin1String("57014")) {
+            qCInfo(lcDbBook) << "'GetSearchSuggestions' для префікса" << prefix << "скасовано";
+            return suggestions;
+        }
+        qCCritical(lcDbBook) << "Помилка при виконанні 'GetSearchSuggestions' для префікса '" << prefix << "':";
+        qCCritical(lcDbBook) << query->lastError().text();
+        qCCritical(lcDbBook) << "SQL запит:" << query->lastQuery();
+        qCCritical(lcDbBook) << "Прив'язані значення:" << query->boundValues();
         return suggestions;
     }
 
-    qInfo() << "Розширені пропозиції успішно отримано. Обробка результатів...";
+    qCInfo(lcDbBook) << "Розширені пропозиції успішно отримано. Обробка результатів...";
     int count = 0;
-    while (query.next()) {
-        SearchSuggestionInfo suggestion;
-        QString typeStr = query.value("type").toString();
-        suggestion.id = query.value("id").toInt();
-        suggestion.displayText = query.value("display_text").toString();
-        suggestion.imagePath = query.value("image_path").toString();
-        suggestion.price = query.value("price").toDouble();
+    const RowMapper<SearchSuggestionInfo> mapper(*query);
+    const int typeIndex = query->record().indexOf("type");
+    while (query->next()) {
+        SearchSuggestionInfo suggestion = mapper.read(*query);
+        QString typeStr = query->value(typeIndex).toString();
 
         if (typeStr == "book") {
             suggestion.type = SearchSuggestionInfo::Book;
         } else if (typeStr == "author") {
             suggestion.type = SearchSuggestionInfo::Author;
         } else {
-            qWarning() << "Зустрінуто невідомий тип пропозиції:" << typeStr;
+            qCWarning(lcDbBook) << "Зустрінуто невідомий тип пропозиції:" << typeStr;
             continue;
         }
 
         suggestions.append(suggestion);
         count++;
     }
-    qInfo() << "Оброблено" << count << "розширених пропозицій для префікса" << prefix;
+    qCInfo(lcDbBook) << "Оброблено" << count << "розширених пропозицій для префікса" << prefix;
+    trace.finish();
+
+    // Префікс нічого не дав - можливо, помилка в слові. Триграмам потрібно хоча б 3 символи.
+    if (suggestions.isEmpty() && prefix.trimmed().size() >= 3) {
+        suggestions = getFuzzySearchSuggestions(prefix.trimmed(), limit > 0 ? limit : 10, db);
+    }
 
     return suggestions;
 }
 
-QList<BookDisplayInfo> DatabaseManager::getSimilarBooks(int currentBookId, const QString &genre, int limit) const
+QList<SearchSuggestionInfo> DatabaseManager::getFuzzySearchSuggestions(const QString &text, int limit, const QSqlDatabase &db) const
 {
-    QList<BookDisplayInfo> books;
-    if (!m_isConnected || !m_db.isOpen() || genre.isEmpty() || currentBookId <= 0) {
-        qWarning() << "Неможливо отримати схожі книги: немає з'єднання, порожній жанр або невірний currentBookId.";
-        return books;
+    QList<SearchSuggestionInfo> suggestions;
+
+    CachedStatement query = preparedQuery(SqlQueryId::GetFuzzySearchSuggestions, db);
+    QueryTrace trace(m_queryStats, "GetFuzzySearchSuggestions");
+    if (!query) return suggestions;
+    query->bindValue(SqlParam::GetFuzzySearchSuggestions::query, text);
+    query->bindValue(SqlParam::GetFuzzySearchSuggestions::total_limit, limit);
+
+    qCInfo(lcDbBook) << "Виконання SQL 'GetFuzzySearchSuggestions' для тексту:" << text;
+    if (!trace.exec(*query)) {
+        if (query->lastError().nativeErrorCode() == QLatin1String("57014")) {
+            qCInfo(lcDbBook) << "'GetFuzzySearchSuggestions' для тексту" << text << "скасовано";
+            return suggestions;
+        }
+        qCCritical(lcDbBook) << "Помилка при виконанні 'GetFuzzySearchSuggestions' для тексту '" << text << "':";
+        qCCritical(lcDbBook) << query->lastError().text();
+        return suggestions;
     }
 
-    const QString sql = getSqlQuery("GetSimilarBooksByGenre");
-    if (sql.isEmpty()) {
-        qCritical() << "SQL запит 'GetSimilarBooksByGenre' не знайдено.";
-        return books;
+    const RowMapper<SearchSuggestionInfo> mapper(*query);
+    const int typeIndex = query->record().indexOf("type");
+    while (query->next()) {
+        SearchSuggestionInfo suggestion = mapper.read(*query);
+        const QString typeStr = query->value(typeIndex).toString();
+        if (typeStr == "book") {
+            suggestion.type = SearchSuggestionInfo::Book;
+        } else if (typeStr == "author") {
+            suggestion.type = SearchSuggestionInfo::Author;
+        } else {
+            continue;
+        }
+        suggestion.fuzzyMatch = true;
+        suggestions.append(suggestion);
     }
+    qCInfo(lcDbBook) << "Нечіткий пошук дав" << suggestions.size() << "кандидатів для" << text;
+    return suggestions;
+}
 
-    QSqlQuery query(m_db);
-    if (!query.prepare(sql)) {
-        qCritical() << "Помилка підготовки запиту 'GetSimilarBooksByGenre':" << query.lastError().text();
-        return books;
+QList<SuggestionSourceItem> DatabaseManager::getSuggestionSource(int afterBookId, int afterAuthorId) const
+{
+    QList<SuggestionSourceItem> items;
+
+    QSqlDatabase db = connection();
+    if (!m_isConnected || !db.isOpen()) {
+        qCWarning(lcDbBook) << "Неможливо завантажити джерело автодоповнення: немає з'єднання.";
+        return items;
+    }
+
+    CachedStatement query = preparedQuery(SqlQueryId::GetSuggestionSource, db);
+    QueryTrace trace(m_queryStats, "GetSuggestionSource");
+    if (!query) return items;
+    query->bindValue(SqlParam::GetSuggestionSource::after_book_id, afterBookId);
+    query->bindValue(SqlParam::GetSuggestionSource::after_author_id, afterAuthorId);
+
+    qCInfo(lcDbBook) << "Виконання SQL 'GetSuggestionSource' після книги" << afterBookId << "та автора" << afterAuthorId;
+    if (!trace.exec(*query)) {
+        qCCritical(lcDbBook) << "Помилка при виконанні 'GetSuggestionSource':";
+        qCCritical(lcDbBook) << query->lastError().text();
+        return items;
+    }
+
+    const RowMapper<SearchSuggestionInfo> mapper(*query);
+    const int typeIndex = query->record().indexOf("type");
+    const int popularityIndex = query->record().indexOf("popularity");
+    while (query->next()) {
+        SuggestionSourceItem item;
+        item.suggestion = mapper.read(*query);
+        const QString typeStr = query->value(typeIndex).toString();
+        if (typeStr == "book") {
+            item.suggestion.type = SearchSuggestionInfo::Book;
+        } else if (typeStr == "author") {
+            item.suggestion.type = SearchSuggestionInfo::Author;
+        } else {
+            continue;
+        }
+        item.popularity = query->value(popularityIndex).toDouble();
+        items.append(item);
+    }
+    qCInfo(lcDbBook) << "Джерело автодоповнення:" << items.size() << "рядків";
+    return items;
+}
+
+QList<BookFilterSourceItem> DatabaseManager::getBookFilterSource() const
+{
+    QList<BookFilterSourceItem> items;
+
+    QSqlDatabase db = connection();
+    if (!m_isConnected || !db.isOpen()) {
+        qCWarning(lcDbBook) << "Неможливо завантажити знімок каталогу для фільтрів: немає з'єднання.";
+        return items;
     }
-    query.bindValue(":genre", genre);
-    query.bindValue(":currentBookId", currentBookId);
-    query.bindValue(":limit", limit > 0 ? limit : 5);
 
-    qInfo() << "Виконання SQL 'GetSimilarBooksByGenre' для жанру:" << genre << "виключаючи книгу з ID:" << currentBookId << "з лімітом:" << query.boundValue(":limit").toInt();
-    if (!query.exec()) {
-        qCritical() << "Помилка при виконанні 'GetSimilarBooksByGenre' для жанру '" << genre << "':";
-        qCritical() << query.lastError().text();
-        qCritical() << "SQL запит:" << query.lastQuery();
-        qCritical() << "Прив'язані значення:" << query.boundValues();
+    CachedStatement query = preparedQuery(SqlQueryId::GetBookFilterSource, db);
+    QueryTrace trace(m_queryStats, "GetBookFilterSource");
+    if (!query) return items;
+
+    qCInfo(lcDbBook) << "Виконання SQL 'GetBookFilterSource'...";
+    if (!trace.exec(*query)) {
+        qCCritical(lcDbBook) << "Помилка при виконанні 'GetBookFilterSource':";
+        qCCritical(lcDbBook) << query->lastError().text();
+        return items;
+    }
+
+    const RowMapper<BookDisplayInfo> mapper(*query);
+    const int languageIndex = query->record().indexOf("language");
+    const int priceIndex = query->record().indexOf("price");
+    while (query->next()) {
+        BookFilterSourceItem item;
+        item.book = mapper.read(*query);
+        item.language = query->value(languageIndex).toString();
+        item.hasPrice = !query->isNull(priceIndex);
+        items.append(item);
+    }
+    qCInfo(lcDbBook) << "Знімок каталогу для фільтрів:" << items.size() << "книг";
+    return items;
+}
+
+BookSearchPage DatabaseManager::searchBooks(const QString &queryText, int limit, int offset) const
+{
+    BookSearchPage page;
+    page.offset = qMax(0, offset);
+
+    QSqlDatabase db = connection();
+    const QString trimmedQuery = queryText.trimmed();
+    if (!m_isConnected || !db.isOpen() || trimmedQuery.isEmpty()) {
+        qCWarning(lcDbBook) << "Неможливо виконати пошук: немає з'єднання або запит порожній.";
+        return page;
+    }
+
+    CachedStatement query = preparedQuery(SqlQueryId::SearchBooks, db);
+    QueryTrace trace(m_queryStats, "SearchBooks");
+    if (!query) return page;
+    query->bindValue(SqlParam::SearchBooks::query, trimmedQuery);
+    query->bindValue(SqlParam::SearchBooks::limit, limit > 0 ? limit : 20);
+    query->bindValue(SqlParam::SearchBooks::offset, page.offset);
+
+    qCInfo(lcDbBook) << "Виконання SQL 'SearchBooks' для запиту:" << trimmedQuery << "зсув:" << page.offset;
+    if (!trace.exec(*query)) {
+        qCCritical(lcDbBook) << "Помилка при виконанні 'SearchBooks' для запиту '" << trimmedQuery << "':";
+        qCCritical(lcDbBook) << query->lastError().text();
+        return page;
+    }
+
+    const RowMapper<BookDisplayInfo> bookMapper(*query);
+    const RowMapper<BookSearchResult> resultMapper(*query);
+    const int totalCountIndex = query->record().indexOf("total_count");
+    while (query->next()) {
+        BookSearchResult result = resultMapper.read(*query);
+        result.book = bookMapper.read(*query);
+        result.book.found = true;
+        page.totalCount = query->value(totalCountIndex).toInt();
+        page.results.append(result);
+    }
+    qCInfo(lcDbBook) << "Знайдено" << page.totalCount << "книг, на сторінці" << page.results.size();
+    return page;
+}
+
+QList<BookDisplayInfo> DatabaseManager::getSimilarBooks(int currentBookId, const QString &genre, int limit) const
+{
+    QList<BookDisplayInfo> books;
+    QSqlDatabase db = connection();
+    if (!m_isConnected || !db.isOpen() || genre.isEmpty() || currentBookId <= 0) {
+        qCWarning(lcDbBook) << "Неможливо отримати схожі книги: немає з'єднання, порожній жанр або невірний currentBookId.";
         return books;
     }
 
-    qInfo() << "Схожі книги за жанром" << genre << "успішно отримано. Обробка результатів...";
-    int count = 0;
-    while (query.next()) {
-        BookDisplayInfo bookInfo;
-        bookInfo.bookId = query.value("book_id").toInt();
-        bookInfo.title = query.value("title").toString();
-        bookInfo.price = query.value("price").toDouble();
-        bookInfo.coverImagePath = query.value("cover_image_path").toString();
-        bookInfo.stockQuantity = query.value("stock_quantity").toInt();
-        bookInfo.authors = query.value("authors").toString();
-        bookInfo.genre = query.value("genre").toString();
-        bookInfo.found = true;
-
-        if (query.value("authors").isNull()) {
-            bookInfo.authors = "";
-        }
+    CachedStatement query = preparedQuery(SqlQueryId::GetSimilarBooksByGenre, db);
+    QueryTrace trace(m_queryStats, "GetSimilarBooksByGenre");
+    if (!query) return books;
+    query->bindValue(SqlParam::GetSimilarBooksByGenre::genre, genre);
+    query->bindValue(SqlParam::GetSimilarBooksByGenre::currentBookId, currentBookId);
+    query->bindValue(SqlParam::GetSimilarBooksByGenre::limit, limit > 0 ? limit : 5);
 
-        books.append(bookInfo);
-        count++;
+    qCInfo(lcDbBook) << "Виконання SQL 'GetSimilarBooksByGenre' для жанру:" << genre << "виключаючи книгу з ID:" << currentBookId << "з лімітом:" << query->boundValue(SqlParam::GetSimilarBooksByGenre::limit).toInt();
+    if (!trace.exec(*query)) {
+        qCCritical(lcDbBook) << "Помилка при виконанні 'GetSimilarBooksByGenre' для жанру '" << genre << "':";
+        qCCritical(lcDbBook) << query->lastError().text();
+        qCCritical(lcDbBook) << "SQL запит:" << query->lastQuery();
+        qCCritical(lcDbBook) << "Прив'язані значення:" << query->boundValues();
+        return books;
     }
-    qInfo() << "Оброблено" << count << "схожих книг за жанром" << genre;
+
+    qCInfo(lcDbBook) << "Схожі книги за жанром" << genre << "успішно отримано. Обробка результатів...";
+    books = readAllRows<BookDisplayInfo>(*query);
+    qCInfo(lcDbBook) << "Оброблено" << books.size() << "схожих книг за жанром" << genre;
 
     return books;
 }
 
 int DatabaseManager::getTotalBookCount() const
 {
-    if (!m_isConnected || !m_db.isOpen()) {
-        qWarning() << "Неможливо отримати загальну кількість книг: немає активного з'єднання з БД.";
+    QSqlDatabase db = connection();
+    if (!m_isConnected || !db.isOpen()) {
+        qCWarning(lcDbBook) << "Неможливо отримати загальну кількість книг: немає активного з'єднання з БД.";
         return 0;
     }
 
-    const QString sql = "SELECT COUNT(*) FROM books;"; // Простий запит для підрахунку
-    QSqlQuery query(m_db);
-    qInfo() << "Виконання SQL для отримання загальної кількості книг...";
-    if (!query.exec(sql)) {
-        qCritical() << "Помилка при отриманні загальної кількості книг:";
-        qCritical() << query.lastError().text();
-        qCritical() << "SQL запит:" << sql;
+    CachedStatement query = preparedQuery(SqlQueryId::GetTotalBookCount, db);
+    QueryTrace trace(m_queryStats, "GetTotalBookCount");
+    if (!query) return 0;
+
+    qCInfo(lcDbBook) << "Виконання SQL 'GetTotalBookCount' для отримання загальної кількості книг...";
+    if (!trace.exec(*query)) {
+        qCCritical(lcDbBook) << "Помилка при отриманні загальної кількості книг:";
+        qCCritical(lcDbBook) << query->lastError().text();
+        qCCritical(lcDbBook) << "SQL запит:" << query->lastQuery();
         return 0;
     }
 
-    if (query.next()) {
-        int count = query.value(0).toInt();
-        qInfo() << "Загальна кількість книг:" << count;
+    if (query->next()) {
+        int count = query->value(0).toInt();
+        qCInfo(lcDbBook) << "Загальна кількість книг:" << count;
         return count;
     }
     return 0;
@@ -1,6 +1,8 @@
 #include "database.h"
+#include "logging.h"
 #include <QSqlQuery>
 #include <QSqlError>
+#include <QSqlRecord>
 #include <QVariant>
 #include <QDebug>
 #include <QMap>
@@ -9,144 +11,130 @@
 QMap<int, int> DatabaseManager::getCartItems(int customerId) const
 {
     QMap<int, int> cartItems;
-    if (!m_isConnected || !m_db.isOpen()) {
-        qWarning() << "getCartItems: Немає активного з'єднання з БД.";
+    QSqlDatabase db = connection();
+    if (!m_isConnected || !db.isOpen()) {
+        qCWarning(lcDbCart) << "getCartItems: Немає активного з'єднання з БД.";
         return cartItems; // Повертаємо порожню мапу
     }
 
-    const QString sql = getSqlQuery("GetCartItemsByCustomerId");
-    if (sql.isEmpty()) return cartItems; // Помилка завантаження запиту
+    CachedStatement query = preparedQuery(SqlQueryId::GetCartItemsByCustomerId, db);
+    QueryTrace trace(m_queryStats, "GetCartItemsByCustomerId");
+    if (!query) return cartItems;
+    query->bindValue(SqlParam::GetCartItemsByCustomerId::customerId, customerId);
 
-    QSqlQuery query(m_db);
-    if (!query.prepare(sql)) {
-        qCritical() << "Помилка підготовки запиту 'GetCartItemsByCustomerId':" << query.lastError().text();
-        return cartItems;
-    }
-    query.bindValue(":customerId", customerId);
-
-    qInfo() << "Executing SQL 'GetCartItemsByCustomerId' for customer ID:" << customerId;
-    if (!query.exec()) {
-        qCritical() << "Помилка при виконанні 'GetCartItemsByCustomerId' для customerId" << customerId << ":" << query.lastError().text();
+    qCInfo(lcDbCart) << "Executing SQL 'GetCartItemsByCustomerId' for customer ID:" << customerId;
+    if (!trace.exec(*query)) {
+        qCCritical(lcDbCart) << "Помилка при виконанні 'GetCartItemsByCustomerId' для customerId" << customerId << ":" << query->lastError().text();
         return cartItems; // Повертаємо порожню мапу
     }
 
-    while (query.next()) {
-        int bookId = query.value("book_id").toInt();
-        int quantity = query.value("quantity").toInt();
+    const int bookIdIndex = query->record().indexOf("book_id");
+    const int quantityIndex = query->record().indexOf("quantity");
+    while (query->next()) {
+        int bookId = query->value(bookIdIndex).toInt();
+        int quantity = query->value(quantityIndex).toInt();
         if (bookId > 0 && quantity > 0) {
             cartItems.insert(bookId, quantity);
         } else {
-            qWarning() << "getCartItems: Отримано некоректні дані з БД (bookId або quantity <= 0) для customerId" << customerId;
+            qCWarning(lcDbCart) << "getCartItems: Отримано некоректні дані з БД (bookId або quantity <= 0) для customerId" << customerId;
         }
     }
 
-    qInfo() << "Завантажено" << cartItems.size() << "товарів з корзини для customerId" << customerId;
+    qCInfo(lcDbCart) << "Завантажено" << cartItems.size() << "товарів з корзини для customerId" << customerId;
     return cartItems;
 }
 
 bool DatabaseManager::addOrUpdateCartItem(int customerId, int bookId, int quantity)
 {
-    if (!m_isConnected || !m_db.isOpen()) {
-        qWarning() << "addOrUpdateCartItem: Немає активного з'єднання з БД.";
+    QSqlDatabase db = connection();
+    if (!m_isConnected || !db.isOpen()) {
+        qCWarning(lcDbCart) << "addOrUpdateCartItem: Немає активного з'єднання з БД.";
         return false;
     }
     if (quantity <= 0) {
-        qWarning() << "addOrUpdateCartItem: Спроба додати товар з кількістю <= 0. Видалення товару...";
+        qCWarning(lcDbCart) << "addOrUpdateCartItem: Спроба додати товар з кількістю <= 0. Видалення товару...";
         return removeCartItem(customerId, bookId); // Якщо кількість 0 або менше, видаляємо товар
     }
 
     // Перевірка наявності товару на складі
     BookDisplayInfo bookInfo = getBookDisplayInfoById(bookId);
     if (!bookInfo.found) {
-        qWarning() << "addOrUpdateCartItem: Книгу з ID" << bookId << "не знайдено.";
+        qCWarning(lcDbCart) << "addOrUpdateCartItem: Книгу з ID" << bookId << "не знайдено.";
         return false;
     }
 
     if (quantity > bookInfo.stockQuantity) {
-        qWarning() << "addOrUpdateCartItem: Запитувана кількість" << quantity
+        qCWarning(lcDbCart) << "addOrUpdateCartItem: Запитувана кількість" << quantity
                    << "для книги ID" << bookId << "перевищує залишок на складі" << bookInfo.stockQuantity;
         return false; // Недостатньо товару
     }
 
-    QSqlQuery query(m_db);
-    // Використовуємо завантажений SQL запит
-    const QString sql = getSqlQuery("AddOrUpdateCartItem");
-     if (sql.isEmpty()) return false; // Помилка завантаження запиту
+    // Використовуємо кешований підготовлений запит
+    CachedStatement query = preparedQuery(SqlQueryId::AddOrUpdateCartItem, db);
+    QueryTrace trace(m_queryStats, "AddOrUpdateCartItem");
+    if (!query) return false;
+    query->bindValue(SqlParam::AddOrUpdateCartItem::customerId, customerId);
+    query->bindValue(SqlParam::AddOrUpdateCartItem::bookId, bookId);
+    query->bindValue(SqlParam::AddOrUpdateCartItem::quantity, quantity);
 
-    if (!query.prepare(sql)) {
-        qCritical() << "Помилка підготовки запиту 'AddOrUpdateCartItem':" << query.lastError().text();
-        return false;
-    }
-    query.bindValue(":customerId", customerId);
-    query.bindValue(":bookId", bookId);
-    query.bindValue(":quantity", quantity);
-
-    qInfo() << "Executing SQL 'AddOrUpdateCartItem' for customer ID:" << customerId << "Book ID:" << bookId << "Quantity:" << quantity;
-    if (!query.exec()) {
-        qCritical() << "Помилка при виконанні 'AddOrUpdateCartItem' (bookId" << bookId << ", quantity" << quantity
-                   << ") для customerId" << customerId << ":" << query.lastError().text();
+    qCInfo(lcDbCart) << "Executing SQL 'AddOrUpdateCartItem' for customer ID:" << customerId << "Book ID:" << bookId << "Quantity:" << quantity;
+    if (!trace.exec(*query)) {
+        qCCritical(lcDbCart) << "Помилка при виконанні 'AddOrUpdateCartItem' (bookId" << bookId << ", quantity" << quantity
+                   << ") для customerId" << customerId << ":" << query->lastError().text();
         return false;
     }
 
-    qInfo() << "Товар (bookId" << bookId << ", quantity" << quantity << ") успішно додано/оновлено в корзині БД для customerId" << customerId;
+    qCInfo(lcDbCart) << "Товар (bookId" << bookId << ", quantity" << quantity << ") успішно додано/оновлено в корзині БД для customerId" << customerId;
     return true;
 }
 
 bool DatabaseManager::removeCartItem(int customerId, int bookId)
 {
-    if (!m_isConnected || !m_db.isOpen()) {
-        qWarning() << "removeCartItem: Немає активного з'єднання з БД.";
+    QSqlDatabase db = connection();
+    if (!m_isConnected || !db.isOpen()) {
+        qCWarning(lcDbCart) << "removeCartItem: Немає активного з'єднання з БД.";
         return false;
     }
 
-    const QString sql = getSqlQuery("RemoveCartItem");
-    if (sql.isEmpty()) return false; // Помилка завантаження запиту
-
-    QSqlQuery query(m_db);
-    if (!query.prepare(sql)) {
-        qCritical() << "Помилка підготовки запиту 'RemoveCartItem':" << query.lastError().text();
-        return false;
-    }
-    query.bindValue(":customerId", customerId);
-    query.bindValue(":bookId", bookId);
+    CachedStatement query = preparedQuery(SqlQueryId::RemoveCartItem, db);
+    QueryTrace trace(m_queryStats, "RemoveCartItem");
+    if (!query) return false;
+    query->bindValue(SqlParam::RemoveCartItem::customerId, customerId);
+    query->bindValue(SqlParam::RemoveCartItem::bookId, bookId);
 
-    qInfo() << "Executing SQL 'RemoveCartItem' for customer ID:" << customerId << "Book ID:" << bookId;
-    if (!query.exec()) {
-        qCritical() << "Помилка при виконанні 'RemoveCartItem' (bookId" << bookId << ") для customerId" << customerId << ":" << query.lastError().text();
+    qCInfo(lcDbCart) << "Executing SQL 'RemoveCartItem' for customer ID:" << customerId << "Book ID:" << bookId;
+    if (!trace.exec(*query)) {
+        qCCritical(lcDbCart) << "Помилка при виконанні 'RemoveCartItem' (bookId" << bookId << ") для customerId" << customerId << ":" << query->lastError().text();
         return false;
     }
 
-    if (query.numRowsAffected() > 0) {
-        qInfo() << "Товар (bookId" << bookId << ") успішно видалено з корзини БД для customerId" << customerId;
+    if (query->numRowsAffected() > 0) {
+        qCInfo(lcDbCart) << "Товар (bookId" << bookId << ") успішно видалено з корзини БД для customerId" << customerId;
     } else {
-        qWarning() << "removeCartItem: Товар (bookId" << bookId << ") не знайдено в корзині БД для customerId" << customerId << " (можливо, вже видалено).";
+        qCWarning(lcDbCart) << "removeCartItem: Товар (bookId" << bookId << ") не знайдено в корзині БД для customerId" << customerId << " (можливо, вже видалено).";
     }
     return true; // Повертаємо true, навіть якщо нічого не було видалено (операція пройшла без помилок БД)
 }
 
 bool DatabaseManager::clearCart(int customerId)
 {
-    if (!m_isConnected || !m_db.isOpen()) {
-        qWarning() << "clearCart: Немає активного з'єднання з БД.";
+    QSqlDatabase db = connection();
+    if (!m_isConnected || !db.isOpen()) {
+        qCWarning(lcDbCart) << "clearCart: Немає активного з'єднання з БД.";
         return false;
     }
 
-    const QString sql = getSqlQuery("ClearCartByCustomerId");
-    if (sql.isEmpty()) return false; // Помилка завантаження запиту
-
-    QSqlQuery query(m_db);
-    if (!query.prepare(sql)) {
-        qCritical() << "Помилка підготовки запиту 'ClearCartByCustomerId':" << query.lastError().text();
-        return false;
-    }
-    query.bindValue(":customerId", customerId);
+    CachedStatement query = preparedQuery(SqlQueryId::ClearCartByCustomerId, db);
+    QueryTrace trace(m_queryStats, "ClearCartByCustomerId");
+    if (!query) return false;
+    query->bindValue(SqlParam::ClearCartByCustomerId::customerId, customerId);
 
-    qInfo() << "Executing SQL 'ClearCartByCustomerId' for customer ID:" << customerId;
-    if (!query.exec()) {
-        qCritical() << "Помилка при виконанні 'ClearCartByCustomerId' для customerId" << customerId << ":" << query.lastError().text();
+    qCInfo(lcDbCart) << "Executing SQL 'ClearCartByCustomerId' for customer ID:" << customerId;
+    if (!trace.exec(*query)) {
+        qCCritical(lcDbCart) << "Помилка при виконанні 'ClearCartByCustomerId' для customerId" << customerId << ":" << query->lastError().text();
         return false;
     }
 
-    qInfo() << "Корзину БД успішно очищено для customerId" << customerId << "(видалено рядків:" << query.numRowsAffected() << ")";
+    qCInfo(lcDbCart) << "Корзину БД успішно очищено для customerId" << customerId << "(видалено рядків:" << query->numRowsAffected() << ")";
     return true;
 }
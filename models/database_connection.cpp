@@ -1,4 +1,5 @@
 #include "database.h"
+#include "logging.h"
 #include <QDebug>
 #include <QSqlDatabase>
 #include <QSqlError>
@@ -7,21 +8,65 @@
 #include <QVector>
 #include <QDate>
 #include <QDateTime>
+#include <QElapsedTimer>
 #include <QSqlRecord>
+#include <QSqlDriver>
+#include <QSqlField>
 #include <QMap>
-#include <QFile>
-#include <QTextStream>
-#include <QDir>
+#include <QThread>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QRegularExpression>
+
+namespace {
+// З'єднання, прив'язане до робочого потоку через ThreadConnectionScope
+struct ThreadConnection {
+    const DatabaseManager *owner = nullptr;
+    QSqlDatabase db;
+};
+thread_local ThreadConnection t_threadConnection;
+
+// QString-копії таблиці SqlQueryTable: перетворюються один раз, далі пошук - індекс масиву
+struct CompiledSqlQueries {
+    QString names[SqlQueryCount];
+    QString texts[SqlQueryCount];
+    QString positional[SqlQueryCount];
+};
+
+const CompiledSqlQueries &compiledSqlQueries()
+{
+    static const CompiledSqlQueries queries = [] {
+        CompiledSqlQueries compiled;
+        for (int i = 0; i < SqlQueryCount; ++i) {
+            compiled.names[i] = QString::fromLatin1(SqlQueryTable[i].name);
+            compiled.texts[i] = QString::fromUtf8(SqlQueryTable[i].text);
+            compiled.positional[i] = QString::fromUtf8(SqlQueryTable[i].positional);
+        }
+        return compiled;
+    }();
+    return queries;
+}
+}
 
 DatabaseManager::DatabaseManager(QObject *parent) : QObject(parent), m_isConnected(false)
 {
-    if (!loadSqlQueries()) {
-        qCritical() << "ФАТАЛЬНА ПОМИЛКА: Не вдалося завантажити SQL запити. Операції з базою даних, ймовірно, завершаться невдачею.";
-    }
+    resetWorkerPool();
+    m_bookLoader = new BookDisplayInfoLoader(this, this);
+
+    // Довідники змінюються рідко, списки книг - частіше (залишки)
+    m_resultCache.setTtl("GetAllDistinctGenres", 10 * 60 * 1000);
+    m_resultCache.setTtl("GetAllDistinctLanguages", 10 * 60 * 1000);
+    m_resultCache.setTtl("GetAllAuthorsForDisplay", 10 * 60 * 1000);
+    m_resultCache.setTtl("GetAuthorDetails", 5 * 60 * 1000);
+    m_resultCache.setTtl("GetBooksByGenre", 2 * 60 * 1000);
+    m_resultCache.setServerVersionProvider([this]() { return fetchServerTableVersions(); });
+    m_versionCheckTimer = new QTimer(this);
+    m_versionCheckTimer->setInterval(ServerVersionCheckIntervalMs);
+    connect(m_versionCheckTimer, &QTimer::timeout, this, &DatabaseManager::scheduleServerVersionCheck);
 
     if (!QSqlDatabase::isDriverAvailable("QPSQL")) {
-        qCritical() << "Помилка: Драйвер QPSQL для PostgreSQL недоступний!";
-        qCritical() << "Доступні драйвери:" << QSqlDatabase::drivers();
+        qCCritical(lcDbConnection) << "Помилка: Драйвер QPSQL для PostgreSQL недоступний!";
+        qCCritical(lcDbConnection) << "Доступні драйвери:" << QSqlDatabase::drivers();
     }
 }
 
@@ -46,97 +91,319 @@ bool DatabaseManager::connectToDatabase(const QString &host,
     m_db.setPassword(password);
 
     if (!m_db.open()) {
-        qCritical() << "Не вдалося підключитися до бази даних:";
-        qCritical() << m_db.lastError().text();
+        qCCritical(lcDbConnection) << "Не вдалося підключитися до бази даних:";
+        qCCritical(lcDbConnection) << m_db.lastError().text();
         m_isConnected = false;
         QSqlDatabase::removeDatabase(connectionName);
         return false;
     }
 
-    qDebug() << "Успішно підключено до бази даних" << dbName << "на" << host << ":" << port << "З'єднання:" << connectionName;
+    qCDebug(lcDbConnection) << "Успішно підключено до бази даних" << dbName << "на" << host << ":" << port << "З'єднання:" << connectionName;
     m_isConnected = true;
+
+    // Основне з'єднання m_db лишається за потоком GUI, робочі потоки беруть свої з пулу
+    ConnectionPoolConfig poolConfig;
+    poolConfig.host = host;
+    poolConfig.port = port;
+    poolConfig.dbName = dbName;
+    poolConfig.user = user;
+    poolConfig.password = password;
+    poolConfig.minSize = m_poolMinSize;
+    poolConfig.maxSize = m_poolMaxSize;
+    m_pool = new ConnectionPool(poolConfig, this);
+    m_pool->setConnectionClosingHandler([this](const QString &name) {
+        clearStatementCache(name);
+    });
+    m_versionCheckTimer->start();
     return true;
 }
 
+void DatabaseManager::resetWorkerPool()
+{
+    m_workerPool.reset();
+    m_workerPool = std::make_unique<QThreadPool>();
+    // Кожен робочий потік тримає одне з'єднання пулу, тому потоків не більше, ніж з'єднань
+    m_workerPool->setMaxThreadCount(m_poolMaxSize);
+}
+
+void DatabaseManager::scheduleServerVersionCheck()
+{
+    // Попередня звірка ще в черзі чи виконується (усі робочі потоки зайняті) - не додаємо ще одну
+    if (!m_isConnected || !m_resultCache.isEnabled() || !m_versionCheck.isFinished()) {
+        return;
+    }
+    m_versionCheck = runAsync([this]() { m_resultCache.refreshServerVersions(); });
+}
+
 bool DatabaseManager::createSchemaTables()
 {
     if (!m_isConnected || !m_db.isOpen()) {
-        qWarning() << "Неможливо створити таблиці: немає активного з'єднання з БД.";
+        qCWarning(lcDbConnection) << "Неможливо створити таблиці: немає активного з'єднання з БД.";
         return false;
     }
 
     if (!m_db.transaction()) {
-        qCritical() << "Не вдалося розпочати транзакцію:" << m_db.lastError().text();
+        qCCritical(lcDbConnection) << "Не вдалося розпочати транзакцію:" << m_db.lastError().text();
         return false;
     }
-    qInfo() << "Транзакцію розпочато для створення схеми...";
+    qCInfo(lcDbConnection) << "Транзакцію розпочато для створення схеми...";
 
     QSqlQuery query(m_db);
     bool success = true;
 
     // Drop triggers and functions first
-    success &= executeQuery(query, getSqlQuery("DropAwardLoyaltyPointsTriggerDefinition"), "Видалення тригера trg_award_loyalty_points_on_order_completion");
-    if(success) success &= executeQuery(query, getSqlQuery("DropAwardLoyaltyPointsTriggerFunction"), "Видалення функції award_loyalty_points_on_order_completion");
-    if(success) success &= executeQuery(query, getSqlQuery("DropCalculateAverageRatingFunction"), "Видалення функції calculate_average_book_rating");
+    success &= executeQuery(query, getSqlQuery(SqlQueryId::DropAwardLoyaltyPointsTriggerDefinition), "Видалення тригера trg_award_loyalty_points_on_order_completion");
+    if(success) success &= executeQuery(query, getSqlQuery(SqlQueryId::DropAwardLoyaltyPointsTriggerFunction), "Видалення функції award_loyalty_points_on_order_completion");
+    if(success) success &= executeQuery(query, getSqlQuery(SqlQueryId::DropCalculateAverageRatingFunction), "Видалення функції calculate_average_book_rating");
+    if(success) success &= executeQuery(query, getSqlQuery(SqlQueryId::DropPlaceOrderFunction), "Видалення функції place_order");
+    if(success) success &= executeQuery(query, getSqlQuery(SqlQueryId::DropTableVersionFunction), "Видалення функції bump_table_version");
+    if(success) success &= executeQuery(query, getSqlQuery(SqlQueryId::DropTableVersionSequences), "Видалення послідовностей версій таблиць");
+    if(success) success &= executeQuery(query, getSqlQuery(SqlQueryId::DropBookSearchFunctions), "Видалення функцій і тригерів повнотекстового пошуку");
 
 
     // Drop tables
-    if(success) success &= executeQuery(query, getSqlQuery("DropOrderStatusTable"), "Видалення order_status");
-    if(success) success &= executeQuery(query, getSqlQuery("DropOrderItemTable"),   "Видалення order_item");
-    if(success) success &= executeQuery(query, getSqlQuery("DropCommentTable"),     "Видалення comment");
-    if(success) success &= executeQuery(query, getSqlQuery("DropBookAuthorTable"),  "Видалення book_author");
-    if(success) success &= executeQuery(query, getSqlQuery("DropOrderTable"),       "Видалення \"order\"");
-    if(success) success &= executeQuery(query, getSqlQuery("DropCartItemTable"),    "Видалення cart_item");
-    if(success) success &= executeQuery(query, getSqlQuery("DropBookTable"),        "Видалення book");
-    if(success) success &= executeQuery(query, getSqlQuery("DropAuthorTable"),      "Видалення author");
-    if(success) success &= executeQuery(query, getSqlQuery("DropPublisherTable"),   "Видалення publisher");
-    if(success) success &= executeQuery(query, getSqlQuery("DropCustomerTable"),    "Видалення customer");
+    if(success) success &= executeQuery(query, getSqlQuery(SqlQueryId::DropOrderStatusTable), "Видалення order_status");
+    if(success) success &= executeQuery(query, getSqlQuery(SqlQueryId::DropOrderItemTable),   "Видалення order_item");
+    if(success) success &= executeQuery(query, getSqlQuery(SqlQueryId::DropCommentTable),     "Видалення comment");
+    if(success) success &= executeQuery(query, getSqlQuery(SqlQueryId::DropBookAuthorTable),  "Видалення book_author");
+    if(success) success &= executeQuery(query, getSqlQuery(SqlQueryId::DropOrderTable),       "Видалення \"order\"");
+    if(success) success &= executeQuery(query, getSqlQuery(SqlQueryId::DropCartItemTable),    "Видалення cart_item");
+    if(success) success &= executeQuery(query, getSqlQuery(SqlQueryId::DropBookTable),        "Видалення book");
+    if(success) success &= executeQuery(query, getSqlQuery(SqlQueryId::DropAuthorTable),      "Видалення author");
+    if(success) success &= executeQuery(query, getSqlQuery(SqlQueryId::DropPublisherTable),   "Видалення publisher");
+    if(success) success &= executeQuery(query, getSqlQuery(SqlQueryId::DropCustomerTable),    "Видалення customer");
+    if(success) success &= executeQuery(query, getSqlQuery(SqlQueryId::DropBookSearchConfiguration), "Видалення конфігурації bookstore_search");
 
     // Create tables
-    if(success) success &= executeQuery(query, getSqlQuery("CreateCustomerTable"), "Створення customer");
-    if(success) success &= executeQuery(query, getSqlQuery("CreatePublisherTable"), "Створення publisher");
-    if(success) success &= executeQuery(query, getSqlQuery("CreateAuthorTable"), "Створення author");
-    if(success) success &= executeQuery(query, getSqlQuery("CreateBookTable"), "Створення book");
-    if(success) success &= executeQuery(query, getSqlQuery("CreateOrderTable"), "Створення \"order\"");
-    if(success) success &= executeQuery(query, getSqlQuery("CreateBookAuthorTable"), "Створення book_author");
-    if(success) success &= executeQuery(query, getSqlQuery("CreateOrderItemTable"), "Створення order_item");
-    if(success) success &= executeQuery(query, getSqlQuery("CreateOrderStatusTable"), "Створення order_status");
-    if(success) success &= executeQuery(query, getSqlQuery("CreateCommentTable"), "Створення comment");
-    if(success) success &= executeQuery(query, getSqlQuery("CreateCartItemTable"), "Створення cart_item");
+    if(success) success &= executeQuery(query, getSqlQuery(SqlQueryId::CreateCustomerTable), "Створення customer");
+    if(success) success &= executeQuery(query, getSqlQuery(SqlQueryId::CreatePublisherTable), "Створення publisher");
+    if(success) success &= executeQuery(query, getSqlQuery(SqlQueryId::CreateAuthorTable), "Створення author");
+    if(success) success &= executeQuery(query, getSqlQuery(SqlQueryId::CreateBookTable), "Створення book");
+    if(success) success &= executeQuery(query, getSqlQuery(SqlQueryId::CreateOrderTable), "Створення \"order\"");
+    if(success) success &= executeQuery(query, getSqlQuery(SqlQueryId::CreateBookAuthorTable), "Створення book_author");
+    if(success) success &= executeQuery(query, getSqlQuery(SqlQueryId::CreateOrderItemTable), "Створення order_item");
+    if(success) success &= executeQuery(query, getSqlQuery(SqlQueryId::CreateOrderStatusTable), "Створення order_status");
+    if(success) success &= executeQuery(query, getSqlQuery(SqlQueryId::CreateCommentTable), "Створення comment");
+    if(success) success &= executeQuery(query, getSqlQuery(SqlQueryId::CreateCartItemTable), "Створення cart_item");
+    if(success) success &= executeQuery(query, getSqlQuery(SqlQueryId::CreateSecondaryIndexes), "Створення вторинних індексів");
 
     // Create functions and triggers
-    if(success) success &= executeQuery(query, getSqlQuery("CreateCalculateAverageRatingFunction"), "Створення функції calculate_average_book_rating");
-    if(success) success &= executeQuery(query, getSqlQuery("CreateAwardLoyaltyPointsTrigger"), "Створення функції award_loyalty_points_on_order_completion");
-    if(success) success &= executeQuery(query, getSqlQuery("CreateAwardLoyaltyPointsTriggerDefinition"), "Створення тригера trg_award_loyalty_points_on_order_completion");
+    if(success) success &= executeQuery(query, getSqlQuery(SqlQueryId::CreateCalculateAverageRatingFunction), "Створення функції calculate_average_book_rating");
+    if(success) success &= executeQuery(query, getSqlQuery(SqlQueryId::CreateAwardLoyaltyPointsTrigger), "Створення функції award_loyalty_points_on_order_completion");
+    if(success) success &= executeQuery(query, getSqlQuery(SqlQueryId::CreateAwardLoyaltyPointsTriggerDefinition), "Створення тригера trg_award_loyalty_points_on_order_completion");
+    if(success) success &= executeQuery(query, getSqlQuery(SqlQueryId::CreatePlaceOrderFunction), "Створення функції place_order");
+    if(success) success &= executeQuery(query, getSqlQuery(SqlQueryId::CreateTableVersionFunction), "Створення функції bump_table_version");
+    if(success) success &= executeQuery(query, getSqlQuery(SqlQueryId::CreateTableVersionTriggers), "Створення послідовностей і тригерів версій таблиць");
+
+    // Повнотекстовий пошук: конфігурація потрібна до функцій, бо вони посилаються на неї за іменем
+    if(success) success &= executeQuery(query, getSqlQuery(SqlQueryId::CreateBookSearchConfiguration), "Створення конфігурації bookstore_search");
+    if(success) success &= executeQuery(query, getSqlQuery(SqlQueryId::CreateBookSearchFunctions), "Створення функцій пошукового документа книги");
+    if(success) success &= executeQuery(query, getSqlQuery(SqlQueryId::CreateBookSearchTriggers), "Створення тригерів пошукового документа книги");
+    if(success) success &= executeQuery(query, getSqlQuery(SqlQueryId::CreateBookSearchIndex), "Створення GIN-індексу idx_book_search_document");
+    if(success) success &= executeQuery(query, getSqlQuery(SqlQueryId::CreateTrigramExtension), "Встановлення розширення pg_trgm");
+    if(success) success &= executeQuery(query, getSqlQuery(SqlQueryId::CreateSuggestionTrigramIndexes), "Створення триграмних індексів назв книг і імен авторів");
+    if(success) success &= executeQuery(query, getSqlQuery(SqlQueryId::CreateFuzzySuggestionFunction), "Створення функції search_suggestions_fuzzy");
 
 
     if (success) {
         if (m_db.commit()) {
-            qInfo() << "Транзакцію створення схеми успішно завершено.";
+            qCInfo(lcDbConnection) << "Транзакцію створення схеми успішно завершено.";
+            m_resultCache.clear();
             return true;
         } else {
-            qCritical() << "Помилка при коміті транзакції створення схеми:" << m_db.lastError().text();
+            qCCritical(lcDbConnection) << "Помилка при коміті транзакції створення схеми:" << m_db.lastError().text();
             m_db.rollback();
             return false;
         }
     } else {
-        qWarning() << "Сталася помилка при створенні схеми. Відкат транзакції...";
+        qCWarning(lcDbConnection) << "Сталася помилка при створенні схеми. Відкат транзакції...";
         if (!m_db.rollback()) {
-            qCritical() << "Помилка при відкаті транзакції створення схеми:" << m_db.lastError().text();
+            qCCritical(lcDbConnection) << "Помилка при відкаті транзакції створення схеми:" << m_db.lastError().text();
         } else {
-            qInfo() << "Транзакцію створення схеми успішно скасовано.";
+            qCInfo(lcDbConnection) << "Транзакцію створення схеми успішно скасовано.";
         }
         return false;
     }
 }
 
+bool DatabaseManager::createSecondaryIndexes()
+{
+    if (!m_isConnected || !m_db.isOpen()) {
+        qCWarning(lcDbConnection) << "Неможливо створити індекси: немає активного з'єднання з БД.";
+        return false;
+    }
+    QSqlQuery query(m_db);
+    return executeQuery(query, getSqlQuery(SqlQueryId::CreateSecondaryIndexes), "Створення вторинних індексів");
+}
+
+bool DatabaseManager::dropSecondaryIndexes()
+{
+    if (!m_isConnected || !m_db.isOpen()) {
+        qCWarning(lcDbConnection) << "Неможливо видалити індекси: немає активного з'єднання з БД.";
+        return false;
+    }
+    QSqlQuery query(m_db);
+    return executeQuery(query, getSqlQuery(SqlQueryId::DropSecondaryIndexes), "Видалення вторинних індексів");
+}
+
+namespace {
+QString sqlLiteral(const QSqlDatabase &db, const QVariant &value)
+{
+    QSqlField field(QString(), value.metaType());
+    field.setValue(value);
+    return db.driver()->formatValue(field);
+}
+
+QJsonArray runExplain(QSqlQuery &query, const QString &name, const QString &statement)
+{
+    if (!query.exec("EXPLAIN (FORMAT JSON) " + statement) || !query.next()) {
+        qCCritical(lcDbConnection) << "Помилка виконання EXPLAIN для" << name << ":" << query.lastError().text();
+        return QJsonArray();
+    }
+    return QJsonDocument::fromJson(query.value(0).toString().toUtf8()).array();
+}
+
+// Елементи масиву PostgreSQL у текстовому вигляді ({a,"b c"}) - для службових полів pg_proc
+QStringList pgTextArrayItems(const QString &array)
+{
+    QStringList items;
+    const QString trimmed = array.trimmed();
+    if (!trimmed.startsWith('{') || !trimmed.endsWith('}')) {
+        return items;   // NULL - порожній рядок
+    }
+    for (QString item : trimmed.mid(1, trimmed.size() - 2).split(',', Qt::SkipEmptyParts)) {
+        item = item.trimmed();
+        if (item.startsWith('"') && item.endsWith('"') && item.size() >= 2) {
+            item = item.mid(1, item.size() - 2);
+        }
+        items.append(item);
+    }
+    return items;
+}
+}
+
+QJsonArray DatabaseManager::explainQuery(SqlQueryId id, const QVariantList &params) const
+{
+    const QString &name = compiledSqlQueries().names[static_cast<int>(id)];
+    QSqlDatabase db = connection();
+    if (!m_isConnected || !db.isOpen()) {
+        qCWarning(lcDbConnection) << "Неможливо отримати план" << name << ": немає активного з'єднання з БД.";
+        return QJsonArray();
+    }
+
+    // QPSQL перетворює prepare() на "PREPARE ... AS", а після AS EXPLAIN не допускається.
+    // Тому запит готуємо самі і пояснюємо EXECUTE з літералами: типи параметрів виводяться
+    // з тексту запиту, як і під час звичайного виконання.
+    static const QString statementName = QStringLiteral("bookstore_explain");
+    QSqlQuery query(db);
+    if (!query.exec(QString("PREPARE %1 AS %2").arg(statementName, compiledSqlQueries().positional[static_cast<int>(id)]))) {
+        qCCritical(lcDbConnection) << "Помилка підготовки" << name << "для EXPLAIN:" << query.lastError().text();
+        return QJsonArray();
+    }
+
+    QStringList literals;
+    for (const QVariant &value : params) {
+        literals.append(sqlLiteral(db, value));
+    }
+    QString statement = "EXECUTE " + statementName;
+    if (!literals.isEmpty()) {
+        statement += '(' + literals.join(", ") + ')';
+    }
+    const QJsonArray plan = runExplain(query, name, statement);
+
+    if (!query.exec("DEALLOCATE " + statementName)) {
+        qCWarning(lcDbConnection) << "Не вдалося звільнити" << statementName << ":" << query.lastError().text();
+    }
+    return plan;
+}
+
+QJsonArray DatabaseManager::explainSql(const QString &name, const QString &sql, const QMap<QString, QVariant> &bindValues) const
+{
+    QSqlDatabase db = connection();
+    if (!m_isConnected || !db.isOpen()) {
+        qCWarning(lcDbConnection) << "Неможливо отримати план" << name << ": немає активного з'єднання з БД.";
+        return QJsonArray();
+    }
+
+    // Один прохід по тексту: підставлене значення не перевіряється на параметри повторно,
+    // а приведення типів "::" не плутається з параметром
+    static const QRegularExpression parameterPattern(QStringLiteral("(?<!:):[A-Za-z_][A-Za-z0-9_]*"));
+    QString statement;
+    qsizetype copied = 0;
+    QRegularExpressionMatchIterator it = parameterPattern.globalMatch(sql);
+    while (it.hasNext()) {
+        const QRegularExpressionMatch match = it.next();
+        statement += QStringView(sql).mid(copied, match.capturedStart() - copied);
+        const auto value = bindValues.constFind(match.captured());
+        statement += value != bindValues.constEnd() ? sqlLiteral(db, value.value()) : match.captured();
+        copied = match.capturedEnd();
+    }
+    statement += QStringView(sql).mid(copied);
+
+    QSqlQuery query(db);
+    return runExplain(query, name, statement);
+}
+
+QJsonArray DatabaseManager::explainSqlFunction(const QString &functionName, const QVariantList &args) const
+{
+    QSqlDatabase db = connection();
+    if (!m_isConnected || !db.isOpen()) {
+        qCWarning(lcDbConnection) << "Неможливо отримати план" << functionName << ": немає активного з'єднання з БД.";
+        return QJsonArray();
+    }
+
+    QSqlQuery query(db);
+    const QString lookup = QString("SELECT p.prosrc, p.proargnames, p.proconfig FROM pg_proc p "
+                                   "JOIN pg_language l ON l.oid = p.prolang "
+                                   "WHERE p.proname = %1 AND l.lanname = 'sql' AND p.pronamespace = (SELECT oid FROM pg_namespace WHERE nspname = current_schema())")
+                               .arg(sqlLiteral(db, functionName));
+    if (!query.exec(lookup) || !query.next()) {
+        qCCritical(lcDbConnection) << "Не знайдено SQL-функцію" << functionName << "для EXPLAIN:" << query.lastError().text();
+        return QJsonArray();
+    }
+    QString body = query.value(0).toString().trimmed();
+    while (body.endsWith(';')) {
+        body.chop(1);
+    }
+    const QStringList argNames = pgTextArrayItems(query.value(1).toString());
+    const QStringList settings = pgTextArrayItems(query.value(2).toString());
+    query.finish();
+
+    // Вхідні параметри йдуть першими в proargnames (за ними - стовпці RETURNS TABLE)
+    for (int i = 0; i < args.size() && i < argNames.size(); ++i) {
+        body.replace(QRegularExpression("\\b" + QRegularExpression::escape(argNames.at(i)) + "\\b"), sqlLiteral(db, args.at(i)));
+    }
+
+    // SET функції діє лише під час її виклику - відтворюємо його в транзакції, що відкочується
+    if (!db.transaction()) {
+        qCCritical(lcDbConnection) << "Не вдалося розпочати транзакцію для EXPLAIN" << functionName << ":" << db.lastError().text();
+        return QJsonArray();
+    }
+    QJsonArray plan;
+    bool ready = true;
+    for (const QString &setting : settings) {
+        const qsizetype separator = setting.indexOf('=');
+        if (separator <= 0 || !query.exec(QString("SET LOCAL %1 = %2").arg(setting.left(separator), sqlLiteral(db, setting.mid(separator + 1))))) {
+            qCCritical(lcDbConnection) << "Не вдалося застосувати" << setting << "для EXPLAIN" << functionName << ":" << query.lastError().text();
+            ready = false;
+            break;
+        }
+    }
+    if (ready) {
+        plan = runExplain(query, functionName, body);
+    }
+    db.rollback();
+    return plan;
+}
+
 bool DatabaseManager::executeQuery(QSqlQuery &query, const QString &sql, const QString &description)
 {
-    qInfo().noquote() << QString("Виконання SQL (%1): %2").arg(description, sql.left(100).replace("\n", " ").simplified().append("..."));
+    // Аргументи qCInfo обчислюються лише при ввімкненому рівні, тож прев'ю SQL не будується в релізі
+    qCInfo(lcDbConnection).noquote() << QString("Виконання SQL (%1): %2").arg(description, sql.left(100).replace("\n", " ").simplified().append("..."));
     if (!query.exec(sql)) {
-        qCritical().noquote() << QString("Помилка при виконанні SQL (%1):").arg(description);
-        qCritical() << query.lastError().text();
-        qCritical() << "SQL запит:" << sql;
+        qCCritical(lcDbConnection).noquote() << QString("Помилка при виконанні SQL (%1):").arg(description);
+        qCCritical(lcDbConnection) << query.lastError().text();
+        qCCritical(lcDbConnection) << "SQL запит:" << sql;
         return false;
     }
     return true;
@@ -144,24 +411,24 @@ bool DatabaseManager::executeQuery(QSqlQuery &query, const QString &sql, const Q
 
 bool DatabaseManager::executeInsertQuery(QSqlQuery &query, const QString &description, QVariant &insertedId)
 {
-    qInfo().noquote() << QString("Виконання підготовленого INSERT (%1)...").arg(description);
+    qCInfo(lcDbConnection).noquote() << QString("Виконання підготовленого INSERT (%1)...").arg(description);
 
     if (!query.exec()) {
-        qCritical().noquote() << QString("Помилка виконання підготовленого INSERT (%1):").arg(description);
-        qCritical() << query.lastError().text();
-        qCritical() << "Підготовлений запит:" << query.lastQuery();
-        qCritical() << "Прив'язані значення:" << query.boundValues();
+        qCCritical(lcDbConnection).noquote() << QString("Помилка виконання підготовленого INSERT (%1):").arg(description);
+        qCCritical(lcDbConnection) << query.lastError().text();
+        qCCritical(lcDbConnection) << "Підготовлений запит:" << query.lastQuery();
+        qCCritical(lcDbConnection) << "Прив'язані значення:" << query.boundValues();
         return false;
     }
 
     if (query.next()) {
         insertedId = query.value(0);
         if (!insertedId.isValid() || insertedId.isNull()) {
-            qWarning() << "Попередження: Не вдалося отримати ID після INSERT для" << description;
+            qCWarning(lcDbConnection) << "Попередження: Не вдалося отримати ID після INSERT для" << description;
         }
         return true;
     } else {
-        qWarning() << "Попередження: Запит INSERT виконано, але RETURNING не повернув рядка для" << description;
+        qCWarning(lcDbConnection) << "Попередження: Запит INSERT виконано, але RETURNING не повернув рядка для" << description;
         return true;
     }
 }
@@ -174,33 +441,110 @@ bool DatabaseManager::isConnected() const
 QSqlDatabase& DatabaseManager::database()
 {
     if (!m_db.isValid()) {
-         qWarning() << "DatabaseManager::database(): Спроба доступу до недійсного об'єкту QSqlDatabase.";
+         qCWarning(lcDbConnection) << "DatabaseManager::database(): Спроба доступу до недійсного об'єкту QSqlDatabase.";
     } else if (m_isConnected && !m_db.isOpen()) {
-         qWarning() << "DatabaseManager::database(): З'єднання позначено як активне, але об'єкт QSqlDatabase закритий.";
+         qCWarning(lcDbConnection) << "DatabaseManager::database(): З'єднання позначено як активне, але об'єкт QSqlDatabase закритий.";
     }
     return m_db;
 }
 
+ConnectionPool *DatabaseManager::connectionPool() const
+{
+    return m_pool;
+}
+
+void DatabaseManager::setConnectionPoolLimits(int minSize, int maxSize)
+{
+    m_poolMinSize = minSize;
+    m_poolMaxSize = qMax(1, maxSize);
+    m_workerPool->setMaxThreadCount(m_poolMaxSize);
+    if (m_pool) {
+        m_pool->setLimits(minSize, maxSize);
+    }
+}
+
+QSqlDatabase DatabaseManager::workerConnection() const
+{
+    if (t_threadConnection.owner != this) {
+        qCWarning(lcDbConnection) << "DatabaseManager::workerConnection(): виклик поза runAsync.";
+        return QSqlDatabase();
+    }
+    return t_threadConnection.db;
+}
+
+QSqlDatabase DatabaseManager::connection() const
+{
+    if (t_threadConnection.owner == this) {
+        return t_threadConnection.db;
+    }
+    if (QThread::currentThread() == thread()) {
+        return m_db;
+    }
+    qCWarning(lcDbConnection) << "DatabaseManager: виклик з робочого потоку без орендованого з'єднання. Використовуйте runAsync або *Async методи.";
+    return QSqlDatabase();
+}
+
+DatabaseManager::ThreadConnectionScope::ThreadConnectionScope(const DatabaseManager *manager)
+{
+    if (t_threadConnection.owner == manager) {
+        return; // Вкладений виклик - з'єднання вже прив'язане
+    }
+    if (manager->m_pool) {
+        m_lease = manager->m_pool->acquire();
+    }
+    if (!m_lease.isValid()) {
+        qCWarning(lcDbConnection) << "DatabaseManager: не вдалося орендувати з'єднання з пулу для робочого потоку.";
+    }
+    t_threadConnection.owner = manager;
+    t_threadConnection.db = m_lease.database();
+    m_active = true;
+}
+
+DatabaseManager::ThreadConnectionScope::~ThreadConnectionScope()
+{
+    if (!m_active) {
+        return;
+    }
+    t_threadConnection.owner = nullptr;
+    t_threadConnection.db = QSqlDatabase();
+    m_lease.release();
+}
+
 QSqlError DatabaseManager::lastError() const
 {
     if (m_db.isValid()) {
         return m_db.lastError();
     } else {
-        qWarning() << "DatabaseManager::lastError(): Спроба отримати помилку для недійсного об'єкту QSqlDatabase.";
+        qCWarning(lcDbConnection) << "DatabaseManager::lastError(): Спроба отримати помилку для недійсного об'єкту QSqlDatabase.";
         return QSqlError();
     }
 }
 
 void DatabaseManager::closeConnection()
 {
+    if (m_versionCheckTimer) {
+        m_versionCheckTimer->stop();
+    }
+    // waitForDone() лише дочікується завдань, а вільні потоки живуть до expiryTimeout. Знищення
+    // пулу потоків завершує їх, і кожен закриває свої з'єднання сам (QThread::finished ->
+    // ConnectionPool::closeThreadConnections); з потоку GUI чужі з'єднання не закриваються.
+    resetWorkerPool();
+    if (m_pool) {
+        delete m_pool;
+        m_pool = nullptr;
+    }
+    if (m_db.isValid()) {
+        clearStatementCache(m_db.connectionName());
+    }
+    m_resultCache.clear();
     if (m_db.isOpen()) {
         QString connectionName = m_db.connectionName();
         m_db.close();
-        qInfo() << "З'єднання з базою даних" << connectionName << "закрито.";
+        qCInfo(lcDbConnection) << "З'єднання з базою даних" << connectionName << "закрито.";
     }
     if (QSqlDatabase::contains(m_db.connectionName())) {
          QSqlDatabase::removeDatabase(m_db.connectionName());
-         qInfo() << "З'єднання" << m_db.connectionName() << "видалено з пулу.";
+         qCInfo(lcDbConnection) << "З'єднання" << m_db.connectionName() << "видалено з пулу.";
     }
     m_isConnected = false;
 }
@@ -208,13 +552,13 @@ void DatabaseManager::closeConnection()
 bool DatabaseManager::printAllData() const
 {
     if (!m_isConnected || !m_db.isOpen()) {
-        qWarning() << "Неможливо вивести дані: немає активного з'єднання з БД.";
+        qCWarning(lcDbConnection) << "Неможливо вивести дані: немає активного з'єднання з БД.";
         return false;
     }
 
-    qInfo() << "\n===============================================";
-    qInfo() << "       ВИВЕДЕННЯ ДАНИХ З УСІХ ТАБЛИЦЬ        ";
-    qInfo() << "===============================================";
+    qCInfo(lcDbConnection) << "\n===============================================";
+    qCInfo(lcDbConnection) << "       ВИВЕДЕННЯ ДАНИХ З УСІХ ТАБЛИЦЬ        ";
+    qCInfo(lcDbConnection) << "===============================================";
 
     const QStringList tables = {"customer", "publisher", "author", "book", "\"order\"",
                                 "book_author", "order_item", "order_status", "comment", "cart_item"};
@@ -222,21 +566,21 @@ bool DatabaseManager::printAllData() const
     bool overallSuccess = true;
 
     for (const QString &tableName : tables) {
-        qInfo().noquote() << "\n--- Таблиця:" << tableName << "---";
+        qCInfo(lcDbConnection).noquote() << "\n--- Таблиця:" << tableName << "---";
 
         QSqlQuery query(m_db);
         QString sql = QString("SELECT * FROM %1;").arg(tableName);
 
         if (!query.exec(sql)) {
-            qCritical().noquote() << QString("Помилка при отриманні даних з таблиці '%1':").arg(tableName);
-            qCritical() << query.lastError().text();
+            qCCritical(lcDbConnection).noquote() << QString("Помилка при отриманні даних з таблиці '%1':").arg(tableName);
+            qCCritical(lcDbConnection) << query.lastError().text();
             overallSuccess = false;
             continue;
         }
 
         QSqlRecord record = query.record();
         if (record.isEmpty() && query.size() == 0) {
-            qInfo().noquote() << "(Таблиця порожня або не містить колонок)";
+            qCInfo(lcDbConnection).noquote() << "(Таблиця порожня або не містить колонок)";
             continue;
         }
 
@@ -244,13 +588,13 @@ bool DatabaseManager::printAllData() const
         for (int i = 0; i < record.count(); ++i) {
             headerLine += record.fieldName(i) + "\t";
         }
-        qInfo().noquote() << headerLine.trimmed();
+        qCInfo(lcDbConnection).noquote() << headerLine.trimmed();
 
         QString separatorLine;
         for (int i = 0; i < record.count(); ++i) {
             separatorLine += QString(record.fieldName(i).length(), '-') + "\t";
         }
-        qInfo().noquote() << separatorLine.trimmed();
+        qCInfo(lcDbConnection).noquote() << separatorLine.trimmed();
 
 
         int rowCount = 0;
@@ -260,101 +604,133 @@ bool DatabaseManager::printAllData() const
                 QVariant value = query.value(i);
                 dataLine += (value.isNull() ? "(NULL)" : value.toString()) + "\t";
             }
-            qInfo().noquote() << dataLine.trimmed();
+            qCInfo(lcDbConnection).noquote() << dataLine.trimmed();
             rowCount++;
         }
 
         if (rowCount == 0 && !record.isEmpty()) {
-            qInfo().noquote() << "(Немає даних)";
+            qCInfo(lcDbConnection).noquote() << "(Немає даних)";
         } else {
-            qInfo().noquote() << QString("-> Всього рядків: %1").arg(rowCount);
+            qCInfo(lcDbConnection).noquote() << QString("-> Всього рядків: %1").arg(rowCount);
         }
     }
 
-    qInfo() << "\n===============================================";
-    qInfo() << "       Завершення виведення даних           ";
-    qInfo() << "===============================================";
+    qCInfo(lcDbConnection) << "\n===============================================";
+    qCInfo(lcDbConnection) << "       Завершення виведення даних           ";
+    qCInfo(lcDbConnection) << "===============================================";
 
 
     return overallSuccess;
 }
 
-bool DatabaseManager::loadSqlQueries(const QString& directory)
+const QString &DatabaseManager::getSqlQuery(SqlQueryId id)
 {
-    m_sqlQueries.clear();
-    QDir sqlDir(directory);
-    if (!sqlDir.exists()) {
-        qCritical() << "Каталог SQL не знайдено:" << sqlDir.absolutePath();
-        return false;
-    }
+    return compiledSqlQueries().texts[static_cast<int>(id)];
+}
 
-    qInfo() << "Завантаження SQL запитів з каталогу:" << sqlDir.absolutePath();
-    QStringList sqlFiles = sqlDir.entryList(QStringList() << "*.sql", QDir::Files);
-    bool allParsed = true;
+DatabaseManager::CachedStatement DatabaseManager::preparedQuery(SqlQueryId id, const QSqlDatabase &db) const
+{
+    const CompiledSqlQueries &queries = compiledSqlQueries();
+    const int index = static_cast<int>(id);
+    return preparedQuery(queries.names[index], queries.positional[index], db);
+}
 
-    for (const QString& fileName : sqlFiles) {
-        QString filePath = sqlDir.absoluteFilePath(fileName);
-        if (!parseSqlFile(filePath)) {
-            qWarning() << "Не вдалося розібрати SQL файл:" << filePath;
-            allParsed = false;
+DatabaseManager::CachedStatement DatabaseManager::preparedQuery(const QString &cacheKey, const QString &sql, const QSqlDatabase &db) const
+{
+    const QString connectionName = db.connectionName();
+    {
+        QMutexLocker locker(&m_statementCacheMutex);
+        QSqlQuery *cached = m_statementCache.value(connectionName).value(cacheKey, nullptr);
+        if (cached) {
+            ++m_statementCacheHits;
+            return cached;
         }
     }
 
-    qInfo() << QString("Завантажено %1 SQL запитів з %2 файлів.").arg(m_sqlQueries.count()).arg(sqlFiles.count());
-    if (!allParsed) {
-         qWarning() << "Деякі SQL файли не вдалося розібрати коректно.";
+    // З'єднання належить поточному потоку, тож інший потік не підготує той самий запит паралельно
+    QSqlQuery *query = new QSqlQuery(db);
+    QElapsedTimer prepareTimer;
+    prepareTimer.start();
+    if (!query->prepare(sql)) {
+        qCCritical(lcDbConnection) << "Помилка підготовки запиту" << cacheKey << ":" << query->lastError().text();
+        delete query;
+        return nullptr;
     }
-    return allParsed;
+    // Динамічні ключі ("GetBooksPage/1/gk") зводимо до імені запиту
+    m_queryStats.recordPrepare(cacheKey.section('/', 0, 0), prepareTimer.nsecsElapsed() / 1000);
+
+    QMutexLocker locker(&m_statementCacheMutex);
+    ++m_statementCacheMisses;
+    m_statementCache[connectionName].insert(cacheKey, query);
+    return query;
 }
 
-bool DatabaseManager::parseSqlFile(const QString& filePath)
+void DatabaseManager::clearStatementCache(const QString &connectionName) const
 {
-    QFile file(filePath);
-    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
-        qCritical() << "Не вдається відкрити SQL файл для читання:" << filePath << file.errorString();
-        return false;
+    QHash<QString, QSqlQuery*> statements;
+    {
+        QMutexLocker locker(&m_statementCacheMutex);
+        statements = m_statementCache.take(connectionName);
     }
+    // Запити видаляються до закриття з'єднання, інакше removeDatabase попереджає про активні запити
+    qDeleteAll(statements);
+}
 
-    QTextStream in(&file);
-    QString currentQueryName;
-    QString currentQuerySql;
-    int queryCount = 0;
-
-    while (!in.atEnd()) {
-        QString line = in.readLine().trimmed();
+StatementCacheStats DatabaseManager::statementCacheStats() const
+{
+    QMutexLocker locker(&m_statementCacheMutex);
+    StatementCacheStats stats;
+    stats.hits = m_statementCacheHits;
+    stats.misses = m_statementCacheMisses;
+    stats.connections = m_statementCache.size();
+    for (auto it = m_statementCache.cbegin(); it != m_statementCache.cend(); ++it) {
+        stats.cachedStatements += it.value().size();
+    }
+    return stats;
+}
 
-        if (line.startsWith("-- name:")) {
-            if (!currentQueryName.isEmpty() && !currentQuerySql.isEmpty()) {
-                m_sqlQueries.insert(currentQueryName, currentQuerySql.trimmed());
-                queryCount++;
-            }
+QueryResultCache &DatabaseManager::queryResultCache() const
+{
+    return m_resultCache;
+}
 
-            currentQueryName = line.mid(8).trimmed();
-            currentQuerySql.clear();
+QueryCacheStats DatabaseManager::queryCacheStats() const
+{
+    return m_resultCache.stats();
+}
 
-            if (currentQueryName.isEmpty()) {
-                qWarning() << "Знайдено порожнє ім'я запиту після '-- name:' у файлі:" << filePath << "Рядок:" << line;
-            }
-        } else if (!currentQueryName.isEmpty() && !line.startsWith("--") && !line.isEmpty()) {
-            currentQuerySql += line + "\n";
-        }
-    }
+QueryStatsRegistry &DatabaseManager::queryStatsRegistry() const
+{
+    return m_queryStats;
+}
 
-    if (!currentQueryName.isEmpty() && !currentQuerySql.isEmpty()) {
-        m_sqlQueries.insert(currentQueryName, currentQuerySql.trimmed());
-        queryCount++;
-    }
+QList<NamedQueryStats> DatabaseManager::queryStats() const
+{
+    return m_queryStats.snapshot();
+}
 
-    file.close();
-    qInfo() << QString("Розібрано %1 запитів з файлу:").arg(queryCount) << filePath;
-    return true;
+bool DatabaseManager::dumpQueryStats(const QString &filePath) const
+{
+    return m_queryStats.dumpJson(filePath);
 }
 
-QString DatabaseManager::getSqlQuery(const QString& queryName) const
+QHash<QString, qint64> DatabaseManager::fetchServerTableVersions() const
 {
-    if (!m_sqlQueries.contains(queryName)) {
-        qCritical() << "SQL запит не знайдено:" << queryName;
-        return QString();
+    QHash<QString, qint64> versions;
+    QSqlDatabase db = connection();
+    if (!m_isConnected || !db.isOpen()) {
+        return versions;
+    }
+
+    CachedStatement query = preparedQuery(SqlQueryId::GetTableVersions, db);
+    QueryTrace trace(m_queryStats, "GetTableVersions");
+    if (!query) return versions;
+    if (!trace.exec(*query)) {
+        qCWarning(lcDbConnection) << "Не вдалося отримати версії таблиць:" << query->lastError().text();
+        return versions;
+    }
+    while (query->next()) {
+        versions.insert(query->value(0).toString(), query->value(1).toLongLong());
     }
-    return m_sqlQueries.value(queryName);
+    return versions;
 }
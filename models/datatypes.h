@@ -6,6 +6,7 @@
 #include <QDateTime>
 #include <QList>
 #include <QMap>
+#include "rowdescriptor.h"
 
 struct BookDisplayInfo {
     int bookId;
@@ -113,6 +114,47 @@ struct SearchSuggestionInfo {
     int id;
     QString imagePath;
     double price = 0.0;
+    bool fuzzyMatch = false;    // Нечіткий кандидат ("можливо, ви мали на увазі"), а не збіг префікса
+};
+
+// Рядок для SuggestionIndex: пропозиція та її вага для ранжування
+struct SuggestionSourceItem {
+    SearchSuggestionInfo suggestion;
+    double popularity = 0.0;    // Продані примірники (для автора - сума за його книгами)
+};
+
+// Рядок знімка каталогу для BookFilterManager: книга та поля, за якими фільтрує панель
+struct BookFilterSourceItem {
+    BookDisplayInfo book;
+    QString language;
+    bool hasPrice = true;       // price IS NOT NULL: умови на ціну такі книги відкидають, як і SQL
+};
+
+// Значення фільтра та кількість книг, які буде показано, якщо його обрати
+struct FacetValueCount {
+    QString value;
+    int count = 0;
+};
+
+// Ціновий інтервал [minPrice, maxPrice); maxPrice < 0 - без верхньої межі
+struct PriceBucketCount {
+    double minPrice = 0.0;
+    double maxPrice = -1.0;
+    int count = 0;
+};
+
+// Фасети панелі фільтрів для BookFilterCriteria. Кожна вимірність рахується з усіма умовами,
+// крім власної: видно, скільки книг дасть ще один жанр чи інший діапазон цін.
+struct BookFacetCounts {
+    static constexpr int PriceBucketWidth = 100;    // грн
+    static constexpr int PriceBuckets = 10;         // Останній інтервал - без верхньої межі
+
+    QList<FacetValueCount> genres;          // Усі жанри каталогу (зокрема з нулем), за назвою
+    QList<FacetValueCount> languages;
+    QList<PriceBucketCount> priceBuckets;   // PriceBuckets інтервалів за зростанням ціни
+    int inStock = 0;                        // Книг у наявності за рештою умов
+    int total = 0;                          // Книг за всіма умовами
+    bool found = false;                     // false - фасети не вдалося отримати
 };
 
 struct AuthorDetailsInfo {
@@ -135,4 +177,150 @@ struct BookFilterCriteria {
     bool inStockOnly = false;
 };
 
+// Порядок сортування каталогу для посторінкового (keyset) завантаження
+enum class BookSortOrder {
+    Title,  // (title, book_id) за зростанням
+    Price,  // (price, book_id) за зростанням
+    Newest  // (publication_date, book_id) за спаданням
+};
+
+// Сторінка каталогу. nextPageToken - непрозорий курсор, який передається в наступний запит
+struct BookPage {
+    QList<BookDisplayInfo> books;
+    QString nextPageToken;
+    bool hasMore = false;
+};
+
+// Результат повнотекстового пошуку. titleHeadline і snippet - фрагменти ts_headline,
+// збіги в них позначені символами U+0001...U+0002; решта тексту не екранована
+struct BookSearchResult {
+    BookDisplayInfo book;
+    double rank = 0.0;
+    QString titleHeadline;
+    QString snippet;
+};
+
+struct BookSearchPage {
+    QList<BookSearchResult> results;
+    int totalCount = 0;     // Усіх збігів, а не лише на цій сторінці
+    int offset = 0;
+};
+
+// --- Відповідність стовпців результатів запитів полям структур (для RowMapper) ---
+
+template <> struct RowDescriptor<BookDisplayInfo> {
+    static constexpr auto columns = std::make_tuple(
+        rowColumn("book_id", &BookDisplayInfo::bookId),
+        rowColumn("title", &BookDisplayInfo::title),
+        rowColumn("authors", &BookDisplayInfo::authors),
+        rowColumn("price", &BookDisplayInfo::price),
+        rowColumn("cover_image_path", &BookDisplayInfo::coverImagePath),
+        rowColumn("stock_quantity", &BookDisplayInfo::stockQuantity),
+        rowColumn("genre", &BookDisplayInfo::genre));
+};
+
+template <> struct RowDescriptor<AuthorDisplayInfo> {
+    static constexpr auto columns = std::make_tuple(
+        rowColumn("author_id", &AuthorDisplayInfo::authorId),
+        rowColumn("first_name", &AuthorDisplayInfo::firstName),
+        rowColumn("last_name", &AuthorDisplayInfo::lastName),
+        rowColumn("nationality", &AuthorDisplayInfo::nationality),
+        rowColumn("image_path", &AuthorDisplayInfo::imagePath));
+};
+
+template <> struct RowDescriptor<CustomerLoginInfo> {
+    static constexpr auto columns = std::make_tuple(
+        rowColumn("customer_id", &CustomerLoginInfo::customerId),
+        rowColumn("password_hash", &CustomerLoginInfo::passwordHash));
+};
+
+template <> struct RowDescriptor<BookDetailsInfo> {
+    static constexpr auto columns = std::make_tuple(
+        rowColumn("book_id", &BookDetailsInfo::bookId),
+        rowColumn("title", &BookDetailsInfo::title),
+        rowColumn("authors", &BookDetailsInfo::authors),
+        rowColumn("price", &BookDetailsInfo::price),
+        rowColumn("cover_image_path", &BookDetailsInfo::coverImagePath),
+        rowColumn("stock_quantity", &BookDetailsInfo::stockQuantity),
+        rowColumn("genre", &BookDetailsInfo::genre),
+        rowColumn("description", &BookDetailsInfo::description),
+        rowColumn("publisher_name", &BookDetailsInfo::publisherName),
+        rowColumn("publication_date", &BookDetailsInfo::publicationDate),
+        rowColumn("isbn", &BookDetailsInfo::isbn),
+        rowColumn("page_count", &BookDetailsInfo::pageCount),
+        rowColumn("language", &BookDetailsInfo::language));
+};
+
+template <> struct RowDescriptor<CommentDisplayInfo> {
+    static constexpr auto columns = std::make_tuple(
+        rowColumn("author_name", &CommentDisplayInfo::authorName),
+        rowColumn("comment_date", &CommentDisplayInfo::commentDate),
+        rowColumn("rating", &CommentDisplayInfo::rating),
+        rowColumn("comment_text", &CommentDisplayInfo::commentText));
+};
+
+template <> struct RowDescriptor<OrderItemDisplayInfo> {
+    static constexpr auto columns = std::make_tuple(
+        rowColumn("title", &OrderItemDisplayInfo::bookTitle),
+        rowColumn("quantity", &OrderItemDisplayInfo::quantity),
+        rowColumn("price_per_unit", &OrderItemDisplayInfo::pricePerUnit));
+};
+
+template <> struct RowDescriptor<OrderStatusDisplayInfo> {
+    static constexpr auto columns = std::make_tuple(
+        rowColumn("status", &OrderStatusDisplayInfo::status),
+        rowColumn("status_date", &OrderStatusDisplayInfo::statusDate),
+        rowColumn("tracking_number", &OrderStatusDisplayInfo::trackingNumber));
+};
+
+template <> struct RowDescriptor<OrderDisplayInfo> {
+    static constexpr auto columns = std::make_tuple(
+        rowColumn("order_id", &OrderDisplayInfo::orderId),
+        rowColumn("order_date", &OrderDisplayInfo::orderDate),
+        rowColumn("total_amount", &OrderDisplayInfo::totalAmount),
+        rowColumn("shipping_address", &OrderDisplayInfo::shippingAddress),
+        rowColumn("payment_method", &OrderDisplayInfo::paymentMethod));
+};
+
+template <> struct RowDescriptor<CustomerProfileInfo> {
+    static constexpr auto columns = std::make_tuple(
+        rowColumn("customer_id", &CustomerProfileInfo::customerId),
+        rowColumn("first_name", &CustomerProfileInfo::firstName),
+        rowColumn("last_name", &CustomerProfileInfo::lastName),
+        rowColumn("email", &CustomerProfileInfo::email),
+        rowColumn("phone", &CustomerProfileInfo::phone),
+        rowColumn("address", &CustomerProfileInfo::address),
+        rowColumn("join_date", &CustomerProfileInfo::joinDate),
+        rowColumn("loyalty_program", &CustomerProfileInfo::loyaltyProgram),
+        rowColumn("loyalty_points", &CustomerProfileInfo::loyaltyPoints));
+};
+
+// Поле book читається окремим RowMapper<BookDisplayInfo> з того ж рядка
+template <> struct RowDescriptor<BookSearchResult> {
+    static constexpr auto columns = std::make_tuple(
+        rowColumn("rank", &BookSearchResult::rank),
+        rowColumn("title_headline", &BookSearchResult::titleHeadline),
+        rowColumn("snippet", &BookSearchResult::snippet));
+};
+
+// type (book/author) перетворюється на enum у getSearchSuggestions
+template <> struct RowDescriptor<SearchSuggestionInfo> {
+    static constexpr auto columns = std::make_tuple(
+        rowColumn("id", &SearchSuggestionInfo::id),
+        rowColumn("display_text", &SearchSuggestionInfo::displayText),
+        rowColumn("image_path", &SearchSuggestionInfo::imagePath),
+        rowColumn("price", &SearchSuggestionInfo::price));
+};
+
+template <> struct RowDescriptor<AuthorDetailsInfo> {
+    static constexpr auto columns = std::make_tuple(
+        rowColumn("author_id", &AuthorDetailsInfo::authorId),
+        rowColumn("first_name", &AuthorDetailsInfo::firstName),
+        rowColumn("last_name", &AuthorDetailsInfo::lastName),
+        rowColumn("nationality", &AuthorDetailsInfo::nationality),
+        rowColumn("image_path", &AuthorDetailsInfo::imagePath),
+        rowColumn("biography", &AuthorDetailsInfo::biography),
+        rowColumn("birth_date", &AuthorDetailsInfo::birthDate));
+};
+
 #endif // DATATYPES_H
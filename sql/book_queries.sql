@@ -1,4 +1,11 @@
 -- name: GetAllBooksForDisplay
+-- Спершу id сторінки за idx_book_title_id, потім видавець і автори лише для цих рядків
+WITH page AS (
+    SELECT b.book_id
+    FROM book b
+    ORDER BY b.title, b.book_id
+    LIMIT :limit OFFSET :offset
+)
 SELECT
     b.book_id,
     b.title,
@@ -8,14 +15,15 @@ SELECT
     b.genre,
     COALESCE(p.name, 'Невідомий видавець') AS publisher_name,
     STRING_AGG(DISTINCT a.first_name || ' ' || a.last_name, ', ') AS authors
-FROM book b
+FROM page pg
+JOIN book b ON b.book_id = pg.book_id
 LEFT JOIN publisher p ON b.publisher_id = p.publisher_id
 LEFT JOIN book_author ba ON b.book_id = ba.book_id
 LEFT JOIN author a ON ba.author_id = a.author_id
-GROUP BY b.book_id, b.title, b.price, b.cover_image_path, b.stock_quantity, b.genre, p.name
-ORDER BY b.title
-LIMIT :limit;
+GROUP BY b.book_id, p.name
+ORDER BY b.title, b.book_id;
 
+-- name: GetFilteredBooksForDisplayBase
 SELECT DISTINCT
     b.book_id,
     b.title,
@@ -31,6 +39,34 @@ LEFT JOIN publisher p ON b.publisher_id = p.publisher_id
 LEFT JOIN book_author ba ON b.book_id = ba.book_id
 LEFT JOIN author a ON ba.author_id = a.author_id
 
+-- name: GetBooksPageBase
+-- Keyset-пагінація: спочатку вибираємо id сторінки за індексованим ключем сортування,
+-- потім приєднуємо авторів лише для цих рядків. /*WHERE*/ та /*ORDER*/ підставляються в коді.
+WITH page AS (
+    SELECT b.book_id
+    FROM book b
+    /*WHERE*/
+    ORDER BY /*ORDER*/
+    LIMIT :page_limit
+)
+SELECT
+    b.book_id,
+    b.title,
+    b.price,
+    b.cover_image_path,
+    b.stock_quantity,
+    b.genre,
+    b.publication_date,
+    STRING_AGG(DISTINCT a.first_name || ' ' || a.last_name, ', ') AS authors
+FROM page pg
+JOIN book b ON b.book_id = pg.book_id
+LEFT JOIN book_author ba ON b.book_id = ba.book_id
+LEFT JOIN author a ON ba.author_id = a.author_id
+GROUP BY b.book_id
+ORDER BY /*ORDER*/;
+
+-- name: GetTotalBookCount
+SELECT COUNT(*) FROM book;
 
 -- name: GetAllDistinctGenres
 SELECT DISTINCT genre FROM book WHERE genre IS NOT NULL AND genre != '' ORDER BY genre;
@@ -68,7 +104,31 @@ WHERE b.book_id = :bookId
 GROUP BY b.book_id, b.title, b.price, b.cover_image_path, b.stock_quantity, b.genre
 LIMIT 1;
 
+-- name: GetBookDisplayInfoByIds
+-- Пакетний варіант GetBookDisplayInfoById: :bookIds - масив INT[] у текстовому вигляді
+SELECT
+    b.book_id,
+    b.title,
+    b.price,
+    b.cover_image_path,
+    b.stock_quantity,
+    b.genre,
+    STRING_AGG(DISTINCT a.first_name || ' ' || a.last_name, ', ') AS authors
+FROM book b
+LEFT JOIN book_author ba ON b.book_id = ba.book_id
+LEFT JOIN author a ON ba.author_id = a.author_id
+WHERE b.book_id = ANY(CAST(:bookIds AS INT[]))
+GROUP BY b.book_id, b.title, b.price, b.cover_image_path, b.stock_quantity, b.genre;
+
 -- name: GetBooksByGenre
+-- Новинки жанру: :limit рядків у порядку idx_book_genre_newest, автори - лише для них
+WITH page AS (
+    SELECT b.book_id
+    FROM book b
+    WHERE b.genre = :genre
+    ORDER BY b.publication_date DESC, b.title
+    LIMIT :limit
+)
 SELECT
     b.book_id,
     b.title,
@@ -78,14 +138,13 @@ SELECT
     b.genre,
     COALESCE(p.name, 'Невідомий видавець') AS publisher_name,
     STRING_AGG(DISTINCT a.first_name || ' ' || a.last_name, ', ') AS authors
-FROM book b
+FROM page pg
+JOIN book b ON b.book_id = pg.book_id
 LEFT JOIN publisher p ON b.publisher_id = p.publisher_id
 LEFT JOIN book_author ba ON b.book_id = ba.book_id
 LEFT JOIN author a ON ba.author_id = a.author_id
-WHERE b.genre = :genre
-GROUP BY b.book_id, b.title, b.price, b.cover_image_path, b.stock_quantity, b.genre, p.name
-ORDER BY b.publication_date DESC, b.title
-LIMIT :limit;
+GROUP BY b.book_id, p.name
+ORDER BY b.publication_date DESC, b.title;
 
 -- name: GetSearchSuggestions
 SELECT 'book' AS type, book_id AS id, title AS display_text, cover_image_path AS image_path, price
@@ -98,7 +157,31 @@ WHERE LOWER(first_name || ' ' || last_name) LIKE LOWER(:prefix) || '%'
 ORDER BY display_text
 LIMIT :total_limit;
 
--- name: GetSimilarBooksByGenre
+-- name: GetSuggestionSource
+-- Джерело SuggestionIndex (автодоповнення в пам'яті): усі книги й автори з популярністю
+-- (продані примірники). after_book_id/after_author_id > 0 - лише новіші рядки для дозавантаження.
+WITH sold AS (
+    SELECT book_id, SUM(quantity) AS quantity
+    FROM order_item
+    GROUP BY book_id
+)
+SELECT 'book' AS type, b.book_id AS id, b.title AS display_text, b.cover_image_path AS image_path, b.price,
+       COALESCE(s.quantity, 0) AS popularity
+FROM book b
+LEFT JOIN sold s ON s.book_id = b.book_id
+WHERE b.book_id > :after_book_id
+UNION ALL
+SELECT 'author' AS type, a.author_id AS id, a.first_name || ' ' || a.last_name AS display_text, a.image_path,
+       0.0 AS price, COALESCE(SUM(s.quantity), 0) AS popularity
+FROM author a
+LEFT JOIN book_author ba ON ba.author_id = a.author_id
+LEFT JOIN sold s ON s.book_id = ba.book_id
+WHERE a.author_id > :after_author_id
+GROUP BY a.author_id, a.first_name, a.last_name, a.image_path;
+
+-- name: GetBookFilterSource
+-- Знімок каталогу для BookFilterManager (фільтрація панелі в пам'яті): усі книги в порядку
+-- відображення сторінки "Книги" - (title, book_id).
 SELECT
     b.book_id,
     b.title,
@@ -106,11 +189,66 @@ SELECT
     b.cover_image_path,
     b.stock_quantity,
     b.genre,
+    b.language,
     STRING_AGG(DISTINCT a.first_name || ' ' || a.last_name, ', ') AS authors
 FROM book b
 LEFT JOIN book_author ba ON b.book_id = ba.book_id
 LEFT JOIN author a ON ba.author_id = a.author_id
-WHERE b.genre = :genre AND b.book_id != :currentBookId
-GROUP BY b.book_id, b.title, b.price, b.cover_image_path, b.stock_quantity, b.genre
-ORDER BY RANDOM()
-LIMIT :limit;
+GROUP BY b.book_id
+ORDER BY b.title, b.book_id;
+
+-- name: GetBookFacetCountsBase
+-- Фасети панелі фільтрів за один прохід по book: кількість книг для кожного жанру, мови,
+-- цінового інтервалу та в наявності. Кожна вимірність рахується з усіма умовами, крім власної.
+-- /*GENRE*/, /*LANGUAGE*/, /*PRICE*/, /*STOCK*/ підставляються в коді (TRUE - умови немає).
+-- facet_set = GROUPING(genre, language, price_bucket): 3 - жанри, 5 - мови, 6 - ціни, 7 - підсумок.
+WITH f AS (
+    SELECT
+        NULLIF(b.genre, '') AS genre,
+        NULLIF(b.language, '') AS language,
+        CASE WHEN b.price IS NOT NULL
+             THEN LEAST(FLOOR(b.price / CAST(:bucket_width AS NUMERIC)), CAST(:last_bucket AS INT))::INT
+        END AS price_bucket,
+        b.stock_quantity > 0 AS in_stock,
+        COALESCE(/*GENRE*/, FALSE) AS genre_ok,
+        COALESCE(/*LANGUAGE*/, FALSE) AS language_ok,
+        COALESCE(/*PRICE*/, FALSE) AS price_ok,
+        COALESCE(/*STOCK*/, FALSE) AS stock_ok
+    FROM book b
+)
+SELECT
+    GROUPING(genre, language, price_bucket) AS facet_set,
+    genre,
+    language,
+    price_bucket,
+    COUNT(*) FILTER (WHERE language_ok AND price_ok AND stock_ok) AS genre_count,
+    COUNT(*) FILTER (WHERE genre_ok AND price_ok AND stock_ok) AS language_count,
+    COUNT(*) FILTER (WHERE genre_ok AND language_ok AND stock_ok) AS price_count,
+    COUNT(*) FILTER (WHERE genre_ok AND language_ok AND price_ok AND in_stock) AS in_stock_count,
+    COUNT(*) FILTER (WHERE genre_ok AND language_ok AND price_ok AND stock_ok) AS total_count
+FROM f
+GROUP BY GROUPING SETS ((genre), (language), (price_bucket), ())
+ORDER BY facet_set, genre, language, price_bucket;
+
+-- name: GetSimilarBooksByGenre
+-- Випадкові книги жанру: вибірка id за idx_book_genre_newest, автори - лише для :limit рядків
+WITH picked AS (
+    SELECT b.book_id
+    FROM book b
+    WHERE b.genre = :genre AND b.book_id != :currentBookId
+    ORDER BY RANDOM()
+    LIMIT :limit
+)
+SELECT
+    b.book_id,
+    b.title,
+    b.price,
+    b.cover_image_path,
+    b.stock_quantity,
+    b.genre,
+    STRING_AGG(DISTINCT a.first_name || ' ' || a.last_name, ', ') AS authors
+FROM picked pk
+JOIN book b ON b.book_id = pk.book_id
+LEFT JOIN book_author ba ON b.book_id = ba.book_id
+LEFT JOIN author a ON ba.author_id = a.author_id
+GROUP BY b.book_id;
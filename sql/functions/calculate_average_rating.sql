@@ -1,3 +1,7 @@
+-- name: DropCalculateAverageRatingFunction
+DROP FUNCTION IF EXISTS calculate_average_book_rating(INT);
+
+-- name: CreateCalculateAverageRatingFunction
 CREATE OR REPLACE FUNCTION calculate_average_book_rating(book_id_param INT)
 RETURNS NUMERIC AS $$
 DECLARE
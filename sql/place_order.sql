@@ -0,0 +1,84 @@
+-- name: DropPlaceOrderFunction
+DROP FUNCTION IF EXISTS place_order(INT, TEXT, VARCHAR, INT[], INT[], VARCHAR);
+
+-- name: CreatePlaceOrderFunction
+-- Оформлення замовлення за один виклик: блокування, перевірка залишків, списання,
+-- вставка позицій (UNNEST) та початковий статус. Помилка перевірки скасовує все.
+CREATE OR REPLACE FUNCTION place_order(
+    p_customer_id INT,
+    p_shipping_address TEXT,
+    p_payment_method VARCHAR,
+    p_book_ids INT[],
+    p_quantities INT[],
+    p_initial_status VARCHAR,
+    OUT out_order_id INT,
+    OUT out_total_amount NUMERIC
+)
+AS
+$$
+DECLARE
+    v_book_ids INT[];
+    v_quantities INT[];
+    v_bad_book_id INT;
+BEGIN
+    IF p_book_ids IS NULL OR p_quantities IS NULL
+       OR cardinality(p_book_ids) = 0
+       OR cardinality(p_book_ids) <> cardinality(p_quantities) THEN
+        RAISE EXCEPTION 'place_order: empty or mismatched item arrays' USING ERRCODE = '22023';
+    END IF;
+
+    -- Зводимо повтори однієї книги та впорядковуємо за book_id
+    SELECT array_agg(r.book_id ORDER BY r.book_id), array_agg(r.quantity ORDER BY r.book_id)
+    INTO v_book_ids, v_quantities
+    FROM (
+        SELECT i.book_id, SUM(i.quantity)::INT AS quantity
+        FROM unnest(p_book_ids, p_quantities) AS i(book_id, quantity)
+        GROUP BY i.book_id
+    ) r;
+
+    IF EXISTS (SELECT 1 FROM unnest(v_quantities) AS q(quantity) WHERE q.quantity IS NULL OR q.quantity <= 0) THEN
+        RAISE EXCEPTION 'place_order: quantities must be positive' USING ERRCODE = '22023';
+    END IF;
+
+    -- Блокуємо рядки книг у порядку book_id, щоб паралельні покупці не потрапляли у взаємоблокування
+    PERFORM 1 FROM book WHERE book_id = ANY(v_book_ids) ORDER BY book_id FOR UPDATE;
+
+    SELECT r.book_id INTO v_bad_book_id
+    FROM unnest(v_book_ids, v_quantities) AS r(book_id, quantity)
+    LEFT JOIN book b ON b.book_id = r.book_id
+    WHERE b.book_id IS NULL OR b.stock_quantity < r.quantity
+    LIMIT 1;
+    IF FOUND THEN
+        RAISE EXCEPTION 'place_order: book % not found or out of stock', v_bad_book_id USING ERRCODE = 'P0001';
+    END IF;
+
+    INSERT INTO "order" (customer_id, order_date, total_amount, shipping_address, payment_method)
+    VALUES (p_customer_id, CURRENT_TIMESTAMP, 0.0, p_shipping_address, p_payment_method)
+    RETURNING order_id INTO out_order_id;
+
+    UPDATE book b
+    SET stock_quantity = b.stock_quantity - r.quantity
+    FROM unnest(v_book_ids, v_quantities) AS r(book_id, quantity)
+    WHERE b.book_id = r.book_id;
+
+    WITH inserted AS (
+        INSERT INTO order_item (order_id, book_id, quantity, price_per_unit)
+        SELECT out_order_id, r.book_id, r.quantity, COALESCE(b.price, 0)
+        FROM unnest(v_book_ids, v_quantities) AS r(book_id, quantity)
+        JOIN book b ON b.book_id = r.book_id
+        RETURNING order_item.quantity, order_item.price_per_unit
+    )
+    SELECT COALESCE(SUM(inserted.quantity * inserted.price_per_unit), 0) INTO out_total_amount FROM inserted;
+
+    UPDATE "order" SET total_amount = out_total_amount WHERE order_id = out_order_id;
+
+    INSERT INTO order_status (order_id, status, status_date)
+    VALUES (out_order_id, p_initial_status, CURRENT_TIMESTAMP);
+END;
+$$
+LANGUAGE plpgsql;
+
+-- name: PlaceOrder
+SELECT out_order_id, out_total_amount
+FROM place_order(:customer_id, :shipping_address, :payment_method,
+                 CAST(:book_ids AS INT[]), CAST(:quantities AS INT[]), :status);
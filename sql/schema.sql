@@ -56,6 +56,7 @@ CREATE TABLE book (
     page_count INTEGER CHECK (page_count > 0),
     cover_image_path VARCHAR(512),
     genre VARCHAR(100),
+    search_document TSVECTOR, -- Підтримується тригером trg_book_search_document (search.sql)
     CONSTRAINT fk_publisher FOREIGN KEY (publisher_id) REFERENCES publisher(publisher_id) ON DELETE SET NULL
 );
 
@@ -112,3 +113,36 @@ CREATE TABLE cart_item (
     CONSTRAINT fk_customer_cart FOREIGN KEY (customer_id) REFERENCES customer(customer_id) ON DELETE CASCADE,
     CONSTRAINT fk_book_cart FOREIGN KEY (book_id) REFERENCES book(book_id) ON DELETE CASCADE
 );
+
+-- name: CreateSecondaryIndexes
+-- Індекси шляхів доступу запитів sql/*.sql; первинні ключі та UNIQUE створюються разом із таблицями.
+-- Плани перевіряє bookstore_bench --explain-check. DropSecondaryIndexes видаляє той самий набір.
+-- Порядок книг на сторінці "Книги" (GetBooksPageBase, GetAllBooksForDisplay): ті самі вирази,
+-- що й ключі сортування в коді, тож keyset-сторінка - це короткий відрізок індексу
+CREATE INDEX idx_book_title_id ON book (title, book_id);
+CREATE INDEX idx_book_price_key_id ON book ((COALESCE(price, 0)), book_id);
+CREATE INDEX idx_book_newest_id ON book ((COALESCE(publication_date, DATE '0001-01-01')) DESC, book_id DESC);
+-- Новинки жанру (GetBooksByGenre) читаються з індексу вже впорядкованими; також фільтр за жанром
+CREATE INDEX idx_book_genre_newest ON book (genre, publication_date DESC, title);
+-- Фільтри панелі за мовою та діапазоном цін
+CREATE INDEX idx_book_language ON book (language);
+CREATE INDEX idx_book_price ON book (price);
+-- Книги автора (GetAuthorBooksForDisplay): покривний, таблиця book_author не читається
+CREATE INDEX idx_book_author_author_book ON book_author (author_id, book_id);
+-- Замовлення клієнта, новіші першими (GetCustomerOrderHeadersByCustomerId)
+CREATE INDEX idx_order_customer_date ON "order" (customer_id, order_date DESC);
+-- Позиції замовлення (GetOrderItemsByOrderId): покривний
+CREATE INDEX idx_order_item_order ON order_item (order_id) INCLUDE (book_id, quantity, price_per_unit);
+-- Продажі книги (популярність у GetSuggestionSource) і перевірка ON DELETE RESTRICT з book
+CREATE INDEX idx_order_item_book ON order_item (book_id) INCLUDE (quantity);
+-- Історія статусів замовлення (GetOrderStatusesByOrderId): покривний
+CREATE INDEX idx_order_status_order_date ON order_status (order_id, status_date) INCLUDE (status, tracking_number);
+-- Коментарі книги, новіші першими (GetBookCommentsByBookId); CheckUserCommentExists і середній
+-- рейтинг (calculate_average_book_rating) обходяться лише індексом
+CREATE INDEX idx_comment_book_date ON comment (book_id, comment_date DESC) INCLUDE (customer_id, rating);
+
+-- name: DropSecondaryIndexes
+-- Для масового завантаження: COPY без індексів і одна побудова після нього швидші
+DROP INDEX IF EXISTS idx_book_title_id, idx_book_price_key_id, idx_book_newest_id, idx_book_genre_newest,
+    idx_book_language, idx_book_price, idx_book_author_author_book, idx_order_customer_date,
+    idx_order_item_order, idx_order_item_book, idx_order_status_order_date, idx_comment_book_date;
@@ -0,0 +1,184 @@
+-- name: DropBookSearchFunctions
+-- CASCADE прибирає і тригери, що викликають ці функції
+DROP FUNCTION IF EXISTS book_search_on_book_change() CASCADE;
+DROP FUNCTION IF EXISTS book_search_on_book_author_change() CASCADE;
+DROP FUNCTION IF EXISTS book_search_on_author_change() CASCADE;
+DROP FUNCTION IF EXISTS refresh_book_search_documents(INT[]);
+DROP FUNCTION IF EXISTS book_search_document(TEXT, TEXT, TEXT, TEXT);
+DROP FUNCTION IF EXISTS search_suggestions_fuzzy(TEXT, INT);
+DROP FUNCTION IF EXISTS book_author_names(INT);
+
+-- name: DropBookSearchConfiguration
+DROP TEXT SEARCH CONFIGURATION IF EXISTS bookstore_search;
+
+-- name: CreateBookSearchConfiguration
+-- Українського стемера в стандартному PostgreSQL немає: слова з кирилицею (word, hword_part)
+-- лише зводяться до нижнього регістру словником simple, латиниця стемиться english_stem.
+-- Якщо на сервері встановлено hunspell-словник української, його можна додати до mapping для word.
+CREATE TEXT SEARCH CONFIGURATION bookstore_search (COPY = simple);
+ALTER TEXT SEARCH CONFIGURATION bookstore_search
+    ALTER MAPPING FOR asciiword, asciihword, hword_asciipart WITH english_stem;
+
+-- name: CreateBookSearchFunctions
+CREATE OR REPLACE FUNCTION book_author_names(p_book_id INT)
+RETURNS TEXT AS $$
+    SELECT STRING_AGG(a.first_name || ' ' || a.last_name, ', ' ORDER BY a.last_name, a.first_name)
+    FROM book_author ba
+    JOIN author a ON a.author_id = ba.author_id
+    WHERE ba.book_id = p_book_id;
+$$ LANGUAGE sql STABLE;
+
+-- Вага: назва A, автори B, жанр C, опис D (ts_rank_cd враховує ваги)
+CREATE OR REPLACE FUNCTION book_search_document(p_title TEXT, p_description TEXT, p_genre TEXT, p_authors TEXT)
+RETURNS TSVECTOR AS $$
+    SELECT setweight(to_tsvector('bookstore_search', COALESCE(p_title, '')), 'A')
+        || setweight(to_tsvector('bookstore_search', COALESCE(p_authors, '')), 'B')
+        || setweight(to_tsvector('bookstore_search', COALESCE(p_genre, '')), 'C')
+        || setweight(to_tsvector('bookstore_search', COALESCE(p_description, '')), 'D');
+$$ LANGUAGE sql IMMUTABLE;
+
+CREATE OR REPLACE FUNCTION refresh_book_search_documents(p_book_ids INT[])
+RETURNS VOID AS $$
+    UPDATE book b
+    SET search_document = book_search_document(b.title, b.description, b.genre, book_author_names(b.book_id))
+    WHERE b.book_id = ANY(p_book_ids);
+$$ LANGUAGE sql;
+
+CREATE OR REPLACE FUNCTION book_search_on_book_change()
+RETURNS TRIGGER AS $$
+BEGIN
+    NEW.search_document := book_search_document(NEW.title, NEW.description, NEW.genre, book_author_names(NEW.book_id));
+    RETURN NEW;
+END;
+$$ LANGUAGE plpgsql;
+
+-- Тригери рівня інструкції з таблицями переходу: COPY чи пакетний INSERT у book_author
+-- оновлює кожну книгу один раз, а не на кожен рядок
+CREATE OR REPLACE FUNCTION book_search_on_book_author_change()
+RETURNS TRIGGER AS $$
+BEGIN
+    IF TG_OP = 'INSERT' THEN
+        PERFORM refresh_book_search_documents(ARRAY(SELECT DISTINCT book_id FROM new_rows));
+    ELSIF TG_OP = 'DELETE' THEN
+        PERFORM refresh_book_search_documents(ARRAY(SELECT DISTINCT book_id FROM old_rows));
+    ELSE
+        PERFORM refresh_book_search_documents(ARRAY(SELECT book_id FROM old_rows UNION SELECT book_id FROM new_rows));
+    END IF;
+    RETURN NULL;
+END;
+$$ LANGUAGE plpgsql;
+
+-- Таблиці переходу несумісні зі списком стовпців у тригері, тож зміну імені перевіряємо тут
+CREATE OR REPLACE FUNCTION book_search_on_author_change()
+RETURNS TRIGGER AS $$
+BEGIN
+    PERFORM refresh_book_search_documents(ARRAY(
+        SELECT DISTINCT ba.book_id
+        FROM new_rows n
+        JOIN old_rows o ON o.author_id = n.author_id
+        JOIN book_author ba ON ba.author_id = n.author_id
+        WHERE (n.first_name, n.last_name) IS DISTINCT FROM (o.first_name, o.last_name)));
+    RETURN NULL;
+END;
+$$ LANGUAGE plpgsql;
+
+-- name: CreateBookSearchTriggers
+CREATE TRIGGER trg_book_search_document
+BEFORE INSERT OR UPDATE OF title, description, genre ON book
+FOR EACH ROW EXECUTE FUNCTION book_search_on_book_change();
+
+CREATE TRIGGER trg_book_author_search_insert
+AFTER INSERT ON book_author REFERENCING NEW TABLE AS new_rows
+FOR EACH STATEMENT EXECUTE FUNCTION book_search_on_book_author_change();
+
+CREATE TRIGGER trg_book_author_search_delete
+AFTER DELETE ON book_author REFERENCING OLD TABLE AS old_rows
+FOR EACH STATEMENT EXECUTE FUNCTION book_search_on_book_author_change();
+
+CREATE TRIGGER trg_book_author_search_update
+AFTER UPDATE ON book_author REFERENCING OLD TABLE AS old_rows NEW TABLE AS new_rows
+FOR EACH STATEMENT EXECUTE FUNCTION book_search_on_book_author_change();
+
+CREATE TRIGGER trg_author_search_update
+AFTER UPDATE ON author REFERENCING OLD TABLE AS old_rows NEW TABLE AS new_rows
+FOR EACH STATEMENT EXECUTE FUNCTION book_search_on_author_change();
+
+-- name: CreateBookSearchIndex
+CREATE INDEX idx_book_search_document ON book USING GIN (search_document);
+
+-- name: SearchBooks
+-- Ранжування рахується для всіх збігів (за GIN-індексом), ts_headline - лише для рядків сторінки.
+-- Збіги в title_headline і snippet позначені керівними символами U+0001...U+0002 замість типових <b>...</b>:
+-- у тексті книги їх не буває, тож клієнт відрізняє позначки від тегів, набраних у самій назві чи описі.
+-- websearch_to_tsquery приймає звичайний ввід: слова, "фрази", -виключення, or.
+WITH q AS (
+    SELECT websearch_to_tsquery('bookstore_search', :query) AS query,
+           format('StartSel="%s", StopSel="%s"', chr(1), chr(2)) AS selectors
+),
+ranked AS (
+    SELECT b.book_id,
+           ts_rank_cd(b.search_document, q.query) AS rank,
+           COUNT(*) OVER () AS total_count
+    FROM book b, q
+    WHERE b.search_document @@ q.query
+    ORDER BY rank DESC, b.book_id
+    LIMIT :limit OFFSET :offset
+)
+SELECT
+    b.book_id,
+    b.title,
+    b.price,
+    b.cover_image_path,
+    b.stock_quantity,
+    b.genre,
+    book_author_names(b.book_id) AS authors,
+    r.rank,
+    r.total_count,
+    ts_headline('bookstore_search', b.title, q.query,
+                'HighlightAll=true, ' || q.selectors) AS title_headline,
+    ts_headline('bookstore_search', COALESCE(b.description, ''), q.query,
+                'MaxFragments=2, MaxWords=25, MinWords=10, ' || q.selectors) AS snippet
+FROM ranked r
+JOIN book b ON b.book_id = r.book_id
+CROSS JOIN q
+ORDER BY r.rank DESC, b.book_id;
+
+-- name: CreateTrigramExtension
+-- pg_trgm - довірене розширення (PostgreSQL 13+), власник бази може встановити його сам
+CREATE EXTENSION IF NOT EXISTS pg_trgm;
+
+-- name: CreateSuggestionTrigramIndexes
+-- Вирази збігаються з GetSearchSuggestions, тож LIKE 'префікс%' теж іде через ці індекси
+CREATE INDEX idx_book_title_trgm ON book USING GIN (LOWER(title) gin_trgm_ops);
+CREATE INDEX idx_author_full_name_trgm ON author USING GIN (LOWER(first_name || ' ' || last_name) gin_trgm_ops);
+
+-- name: CreateFuzzySuggestionFunction
+-- Кандидати "можливо, ви мали на увазі" для введення з помилками: word_similarity порівнює запит
+-- з найближчим фрагментом назви, тож "shevchnko" знаходить "Тарас Shevchenko" без повного імені.
+-- Поріг задано в SET функції: оператор <% бере його з налаштувань і лише тоді використовує індекс.
+CREATE OR REPLACE FUNCTION search_suggestions_fuzzy(p_query TEXT, p_limit INT)
+RETURNS TABLE (type TEXT, id INT, display_text TEXT, image_path TEXT, price NUMERIC, score REAL) AS $$
+    SELECT * FROM (
+        (SELECT 'book'::TEXT AS type, b.book_id AS id, b.title::TEXT AS display_text,
+                b.cover_image_path::TEXT AS image_path, b.price,
+                word_similarity(LOWER(p_query), LOWER(b.title)) AS score
+         FROM book b
+         WHERE LOWER(p_query) <% LOWER(b.title)
+         ORDER BY score DESC, b.book_id
+         LIMIT p_limit)
+        UNION ALL
+        (SELECT 'author'::TEXT, a.author_id, (a.first_name || ' ' || a.last_name)::TEXT, a.image_path::TEXT, 0.0,
+                word_similarity(LOWER(p_query), LOWER(a.first_name || ' ' || a.last_name)) AS score
+         FROM author a
+         WHERE LOWER(p_query) <% LOWER(a.first_name || ' ' || a.last_name)
+         ORDER BY score DESC, a.author_id
+         LIMIT p_limit)
+    ) candidates
+    ORDER BY score DESC, display_text
+    LIMIT p_limit;
+$$ LANGUAGE sql STABLE
+SET pg_trgm.word_similarity_threshold = 0.4;
+
+-- name: GetFuzzySearchSuggestions
+SELECT type, id, display_text, image_path, price, score
+FROM search_suggestions_fuzzy(:query, :total_limit);
@@ -0,0 +1,52 @@
+-- name: DropTableVersionFunction
+-- CASCADE прибирає і тригери версій на таблицях
+DROP FUNCTION IF EXISTS bump_table_version() CASCADE;
+
+-- name: DropTableVersionSequences
+-- Послідовності версій не належать таблицям, тож DROP TABLE їх не прибирає.
+-- table_version - таблиця версій зі старіших схем
+DO $$
+DECLARE
+    s TEXT;
+BEGIN
+    FOR s IN SELECT sequencename FROM pg_sequences
+             WHERE schemaname = current_schema() AND sequencename LIKE 'table\_version\_%' LOOP
+        EXECUTE format('DROP SEQUENCE %I', s);
+    END LOOP;
+END;
+$$;
+DROP TABLE IF EXISTS table_version CASCADE;
+
+-- name: CreateTableVersionFunction
+-- Лічильник змін таблиці - послідовність table_version_<таблиця> (аргумент тригера).
+-- nextval не блокує рядків і не чекає інших транзакцій, тож паралельні оформлення замовлень
+-- (place_order змінює book.stock_quantity) і шматки COPY не шикуються в чергу за одним рядком.
+-- Нове значення видно одразу, ще до COMMIT, а відкат його не повертає: кеш клієнта може
+-- зайвий раз скинути записи або перечитати дані до коміту - такий запис живе не довше за TTL.
+CREATE OR REPLACE FUNCTION bump_table_version()
+RETURNS TRIGGER AS $$
+BEGIN
+    PERFORM nextval(TG_ARGV[0]::regclass);
+    RETURN NULL;
+END;
+$$ LANGUAGE plpgsql;
+
+-- name: CreateTableVersionTriggers
+-- Тригер рівня інструкції: одне підвищення версії на INSERT/UPDATE/DELETE, а не на кожен рядок
+DO $$
+DECLARE
+    t TEXT;
+BEGIN
+    FOREACH t IN ARRAY ARRAY['book', 'author', 'book_author', 'publisher', 'comment'] LOOP
+        EXECUTE format('CREATE SEQUENCE IF NOT EXISTS %I', 'table_version_' || t);
+        EXECUTE format('CREATE TRIGGER trg_%s_version AFTER INSERT OR UPDATE OR DELETE OR TRUNCATE ON %I '
+                       'FOR EACH STATEMENT EXECUTE FUNCTION bump_table_version(%L)', t, t, 'table_version_' || t);
+    END LOOP;
+END;
+$$;
+
+-- name: GetTableVersions
+-- last_value - NULL, доки nextval ще не викликався
+SELECT substr(sequencename, length('table_version_') + 1) AS table_name, COALESCE(last_value, 0) AS version
+FROM pg_sequences
+WHERE schemaname = current_schema() AND sequencename LIKE 'table\_version\_%';
@@ -0,0 +1,279 @@
+// sqlregistrygen: компілює блоки "-- name: X" з sql/*.sql у заголовок sqlregistry.h
+// (enum SqlQueryId, constexpr-таблиця текстів і позиції параметрів для кожного запиту).
+// Запускається з CMake під час збирання; не залежить від Qt.
+//
+//   sqlregistrygen <вихідний .h> <файл.sql>...
+//
+// Правила розбору ті самі, що були в DatabaseManager::parseSqlFile: рядки обрізаються,
+// порожні рядки та рядки-коментарі "--" відкидаються. Повторне ім'я запиту - помилка.
+
+#include <algorithm>
+#include <cctype>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct QueryDef {
+    std::string name;
+    std::string file;
+    std::string text;                    // як у файлі, з іменованими параметрами :name
+    std::string positional;              // :name -> $n (однакові імена - однаковий номер)
+    std::vector<std::string> parameters; // parameters[n - 1] - ім'я для $n
+};
+
+std::string trimmed(const std::string &s)
+{
+    const auto begin = std::find_if_not(s.begin(), s.end(), [](unsigned char c) { return std::isspace(c); });
+    const auto end = std::find_if_not(s.rbegin(), s.rend(), [](unsigned char c) { return std::isspace(c); }).base();
+    return begin < end ? std::string(begin, end) : std::string();
+}
+
+std::string baseName(const std::string &path)
+{
+    const auto slash = path.find_last_of("/\\");
+    return slash == std::string::npos ? path : path.substr(slash + 1);
+}
+
+bool isIdentStart(char c) { return std::isalpha(static_cast<unsigned char>(c)) || c == '_'; }
+bool isIdentChar(char c) { return std::isalnum(static_cast<unsigned char>(c)) || c == '_'; }
+
+// Переписує :name на $n, пропускаючи рядки '...', ідентифікатори "...", тіла $tag$...$tag$,
+// коментарі, приведення типів "::" та присвоєння PL/pgSQL ":=".
+void rewritePlaceholders(QueryDef &query)
+{
+    const std::string &in = query.text;
+    std::string out;
+    out.reserve(in.size());
+    std::map<std::string, int> positions;
+
+    size_t i = 0;
+    while (i < in.size()) {
+        const char c = in[i];
+        const char next = i + 1 < in.size() ? in[i + 1] : '\0';
+
+        if (c == '\'' || c == '"') {
+            size_t end = i + 1;
+            while (end < in.size()) {
+                if (in[end] == c) {
+                    if (end + 1 < in.size() && in[end + 1] == c) { end += 2; continue; }
+                    break;
+                }
+                ++end;
+            }
+            end = std::min(end + 1, in.size());
+            out.append(in, i, end - i);
+            i = end;
+        } else if (c == '-' && next == '-') {
+            const size_t end = std::min(in.find('\n', i), in.size());
+            out.append(in, i, end - i);
+            i = end;
+        } else if (c == '/' && next == '*') {
+            const size_t close = in.find("*/", i + 2);
+            const size_t end = close == std::string::npos ? in.size() : close + 2;
+            out.append(in, i, end - i);
+            i = end;
+        } else if (c == '$' && (next == '$' || isIdentStart(next))) {
+            size_t tagEnd = i + 1;
+            while (tagEnd < in.size() && isIdentChar(in[tagEnd])) ++tagEnd;
+            if (tagEnd < in.size() && in[tagEnd] == '$') {
+                const std::string tag = in.substr(i, tagEnd - i + 1);
+                const size_t close = in.find(tag, tagEnd + 1);
+                const size_t end = close == std::string::npos ? in.size() : close + tag.size();
+                out.append(in, i, end - i);
+                i = end;
+            } else {
+                out += c;
+                ++i;
+            }
+        } else if (c == ':' && (next == ':' || next == '=')) {
+            out.append(in, i, 2);
+            i += 2;
+        } else if (c == ':' && isIdentStart(next)) {
+            size_t end = i + 1;
+            while (end < in.size() && isIdentChar(in[end])) ++end;
+            const std::string name = in.substr(i + 1, end - i - 1);
+            auto it = positions.find(name);
+            if (it == positions.end()) {
+                query.parameters.push_back(name);
+                it = positions.emplace(name, static_cast<int>(query.parameters.size())).first;
+            }
+            out += '$' + std::to_string(it->second);
+            i = end;
+        } else {
+            out += c;
+            ++i;
+        }
+    }
+    query.positional = out;
+}
+
+bool parseFile(const std::string &path, std::vector<QueryDef> &queries)
+{
+    std::ifstream file(path);
+    if (!file) {
+        std::cerr << "sqlregistrygen: cannot open " << path << '\n';
+        return false;
+    }
+
+    QueryDef current;
+    auto flush = [&]() {
+        current.text = trimmed(current.text);
+        if (!current.name.empty() && !current.text.empty()) {
+            queries.push_back(current);
+        }
+        current = QueryDef();
+        current.file = baseName(path);
+    };
+    current.file = baseName(path);
+
+    std::string raw;
+    int lineNumber = 0;
+    while (std::getline(file, raw)) {
+        ++lineNumber;
+        const std::string line = trimmed(raw);
+        if (line.rfind("-- name:", 0) == 0) {
+            flush();
+            current.name = trimmed(line.substr(8));
+            if (current.name.empty() || !isIdentStart(current.name[0])
+                || !std::all_of(current.name.begin(), current.name.end(), isIdentChar)) {
+                std::cerr << path << ':' << lineNumber << ": invalid query name '" << current.name << "'\n";
+                return false;
+            }
+        } else if (!current.name.empty() && line.rfind("--", 0) != 0 && !line.empty()) {
+            current.text += line + "\n";
+        }
+    }
+    flush();
+    return true;
+}
+
+// Імена параметрів стають енумераторами; ключові слова C++ отримують суфікс "_"
+std::string cppIdentifier(const std::string &name)
+{
+    static const std::set<std::string> keywords = {
+        "auto", "bool", "break", "case", "catch", "char", "class", "const", "continue", "default",
+        "delete", "do", "double", "else", "enum", "explicit", "export", "extern", "false", "float",
+        "for", "friend", "goto", "if", "inline", "int", "long", "mutable", "namespace", "new",
+        "operator", "private", "protected", "public", "register", "return", "short", "signed",
+        "sizeof", "static", "struct", "switch", "template", "this", "throw", "true", "try",
+        "typedef", "typename", "union", "unsigned", "using", "virtual", "void", "volatile", "while"};
+    return keywords.count(name) ? name + "_" : name;
+}
+
+bool rawLiteral(const std::string &text, std::string &literal)
+{
+    if (text.find(")sql\"") != std::string::npos) {
+        return false;
+    }
+    literal = "R\"sql(" + text + ")sql\"";
+    return true;
+}
+
+std::string generateHeader(const std::vector<QueryDef> &queries)
+{
+    std::ostringstream h;
+    h << "// Згенеровано tools/sqlregistrygen із sql/*.sql під час збирання. Не редагувати:\n"
+         "// запити змінюються у .sql файлах, неправильне ім'я запиту чи параметра - помилка компіляції.\n"
+         "#ifndef SQLREGISTRY_H\n"
+         "#define SQLREGISTRY_H\n\n";
+
+    h << "enum class SqlQueryId : int {\n";
+    for (const QueryDef &q : queries) {
+        h << "    " << q.name << ",\n";
+    }
+    h << "};\n\n";
+    h << "inline constexpr int SqlQueryCount = " << queries.size() << ";\n\n";
+
+    h << "struct SqlQueryDef {\n"
+         "    const char *name;\n"
+         "    const char *file;\n"
+         "    const char *text;          // текст із файлу (іменовані параметри :name)\n"
+         "    const char *positional;    // той самий текст із параметрами $1..$n\n"
+         "    int parameterCount;\n"
+         "};\n\n";
+
+    h << "inline constexpr SqlQueryDef SqlQueryTable[SqlQueryCount] = {\n";
+    for (const QueryDef &q : queries) {
+        std::string text, positional;
+        rawLiteral(q.text, text);
+        rawLiteral(q.positional, positional);
+        h << "    { \"" << q.name << "\", \"" << q.file << "\",\n"
+          << "      " << text << ",\n"
+          << "      " << positional << ",\n"
+          << "      " << q.parameters.size() << " },\n";
+    }
+    h << "};\n\n";
+
+    h << "constexpr const SqlQueryDef &sqlQueryDef(SqlQueryId id)\n"
+         "{\n"
+         "    return SqlQueryTable[static_cast<int>(id)];\n"
+         "}\n\n";
+
+    h << "// Індекси для QSqlQuery::bindValue(int, ...) у запитах, підготовлених із positional:\n"
+         "// SqlParam::<Запит>::<параметр> відповідає $(індекс + 1)\n"
+         "namespace SqlParam {\n";
+    for (const QueryDef &q : queries) {
+        if (q.parameters.empty()) continue;
+        h << "namespace " << q.name << " { enum : int { ";
+        for (size_t i = 0; i < q.parameters.size(); ++i) {
+            h << (i ? ", " : "") << cppIdentifier(q.parameters[i]) << " = " << i;
+        }
+        h << " }; }\n";
+    }
+    h << "} // namespace SqlParam\n\n";
+
+    h << "#endif // SQLREGISTRY_H\n";
+    return h.str();
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    if (argc < 3) {
+        std::cerr << "usage: sqlregistrygen <output.h> <file.sql>...\n";
+        return 2;
+    }
+
+    std::vector<std::string> inputs(argv + 2, argv + argc);
+    // Порядок запитів не залежить від порядку аргументів (glob у CMake його не гарантує)
+    std::sort(inputs.begin(), inputs.end(), [](const std::string &a, const std::string &b) {
+        return baseName(a) < baseName(b);
+    });
+
+    std::vector<QueryDef> queries;
+    for (const std::string &path : inputs) {
+        if (!parseFile(path, queries)) return 1;
+    }
+
+    std::map<std::string, std::string> seen;
+    for (QueryDef &q : queries) {
+        const auto inserted = seen.emplace(q.name, q.file);
+        if (!inserted.second) {
+            std::cerr << "sqlregistrygen: query '" << q.name << "' is defined in both "
+                      << inserted.first->second << " and " << q.file << '\n';
+            return 1;
+        }
+        rewritePlaceholders(q);
+        std::string unused;
+        if (!rawLiteral(q.text, unused)) {
+            std::cerr << "sqlregistrygen: query '" << q.name << "' contains )sql\" and cannot be embedded\n";
+            return 1;
+        }
+    }
+
+    const std::string header = generateHeader(queries);
+
+    std::ofstream out(argv[1], std::ios::binary | std::ios::trunc);
+    if (!out || !(out << header)) {
+        std::cerr << "sqlregistrygen: cannot write " << argv[1] << '\n';
+        return 1;
+    }
+    return 0;
+}
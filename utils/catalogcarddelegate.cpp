@@ -0,0 +1,250 @@
+#include "catalogcarddelegate.h"
+#include "cataloggridmodel.h"
+#include <QAbstractItemView>
+#include <QCursor>
+#include <QMouseEvent>
+#include <QPointer>
+#include <QStringList>
+#include <QTextLayout>
+
+namespace {
+
+constexpr int Padding = 10;
+constexpr int CoverHeight = 240;
+constexpr int PhotoSize = 150;
+constexpr int ButtonHeight = 32;
+constexpr int CornerRadius = 8;
+
+// Ті самі параметри, що й у createBookCardWidget - мініатюри спільні в кеші ImageService
+const ThumbnailSpec BookCoverSpec{QSize(180, CoverHeight)};
+const ThumbnailSpec AuthorPhotoSpec{QSize(PhotoSize, PhotoSize), Qt::KeepAspectRatioByExpanding, ImageShape::Circle};
+
+QFont cardFont(const QFont &base, int pointSize, bool bold)
+{
+    QFont font = base;
+    font.setPointSize(pointSize);
+    font.setBold(bold);
+    return font;
+}
+
+} // namespace
+
+CatalogCardDelegate::CatalogCardDelegate(QObject *parent)
+    : QStyledItemDelegate(parent)
+{
+}
+
+void CatalogCardDelegate::setImageService(ImageService *imageService)
+{
+    m_imageService = imageService;
+}
+
+QRect CatalogCardDelegate::contentRect(const QRect &cardRect)
+{
+    return cardRect.adjusted(Padding, Padding, -Padding, -Padding);
+}
+
+QRect CatalogCardDelegate::buttonRect(const QRect &cardRect)
+{
+    const QRect content = contentRect(cardRect);
+    return QRect(content.left(), content.bottom() - ButtonHeight + 1, content.width(), ButtonHeight);
+}
+
+QSize CatalogCardDelegate::sizeHint(const QStyleOptionViewItem &option, const QModelIndex &index) const
+{
+    Q_UNUSED(option);
+    const bool isAuthor = index.data(CatalogRoles::KindRole).toInt() == CatalogGridModel::Authors;
+    return QSize(CardWidth, isAuthor ? AuthorCardHeight : BookCardHeight);
+}
+
+void CatalogCardDelegate::paint(QPainter *painter, const QStyleOptionViewItem &option, const QModelIndex &index) const
+{
+    painter->save();
+    painter->setRenderHint(QPainter::Antialiasing);
+
+    // Рамка картки; під курсором - акцентний колір замість сірого
+    const bool hovered = option.state & QStyle::State_MouseOver;
+    painter->setPen(QPen(hovered ? QColor("#0078d4") : QColor("#dee2e6"), 1));
+    painter->setBrush(Qt::white);
+    painter->drawRoundedRect(QRectF(option.rect).adjusted(0.5, 0.5, -0.5, -0.5), CornerRadius, CornerRadius);
+
+    if (index.data(CatalogRoles::KindRole).toInt() == CatalogGridModel::Authors) {
+        paintAuthorCard(painter, option, index);
+    } else {
+        paintBookCard(painter, option, index);
+    }
+
+    painter->restore();
+}
+
+void CatalogCardDelegate::paintBookCard(QPainter *painter, const QStyleOptionViewItem &option, const QModelIndex &index) const
+{
+    const QRect content = contentRect(option.rect);
+    const QRect coverRect(content.left(), content.top(), content.width(), CoverHeight);
+    paintImage(painter, option, index, coverRect, BookCoverSpec, tr("Немає\nобкладинки"));
+
+    int y = coverRect.bottom() + 1 + 8;
+    painter->setFont(cardFont(option.font, 11, true));
+    painter->setPen(QColor("#212529"));
+    y += drawWrappedText(painter, QRect(content.left(), y, content.width(), 0),
+                         index.data(CatalogRoles::TitleRole).toString(), 2) + 4;
+
+    painter->setFont(cardFont(option.font, 9, false));
+    painter->setPen(QColor("#555555"));
+    y += drawWrappedText(painter, QRect(content.left(), y, content.width(), 0),
+                         index.data(CatalogRoles::SubtitleRole).toString(), 1) + 4;
+
+    painter->setFont(cardFont(option.font, 10, true));
+    painter->setPen(QColor("#007bff"));
+    drawWrappedText(painter, QRect(content.left(), y, content.width(), 0),
+                    QString::number(index.data(CatalogRoles::PriceRole).toDouble(), 'f', 2) + tr(" грн"), 1);
+
+    paintButton(painter, option, tr("🛒 Додати"), QColor("#28a745"), QColor("#218838"));
+}
+
+void CatalogCardDelegate::paintAuthorCard(QPainter *painter, const QStyleOptionViewItem &option, const QModelIndex &index) const
+{
+    const QRect content = contentRect(option.rect);
+    const QRect photoRect(content.center().x() - PhotoSize / 2, content.top(), PhotoSize, PhotoSize);
+    paintImage(painter, option, index, photoRect, AuthorPhotoSpec, tr("👤"));
+
+    int y = photoRect.bottom() + 1 + 8;
+    painter->setFont(cardFont(option.font, 11, true));
+    painter->setPen(QColor("#212529"));
+    y += drawWrappedText(painter, QRect(content.left(), y, content.width(), 0),
+                         index.data(CatalogRoles::TitleRole).toString(), 2) + 4;
+
+    const QString nationality = index.data(CatalogRoles::SubtitleRole).toString();
+    if (!nationality.isEmpty()) {
+        painter->setFont(cardFont(option.font, 9, false));
+        painter->setPen(QColor("#777777"));
+        drawWrappedText(painter, QRect(content.left(), y, content.width(), 0), nationality, 1);
+    }
+
+    paintButton(painter, option, tr("Переглянути книги"), QColor("#0078d4"), QColor("#106ebe"));
+}
+
+// paint() не читає диск і не масштабує: лише готова мініатюра з кешу
+void CatalogCardDelegate::paintImage(QPainter *painter, const QStyleOptionViewItem &option, const QModelIndex &index,
+                                     const QRect &rect, const ThumbnailSpec &spec, const QString &placeholder) const
+{
+    const QString imagePath = index.data(CatalogRoles::ImagePathRole).toString();
+    QPixmap pixmap;
+    bool known = true;
+    if (m_imageService) {
+        known = m_imageService->cachedThumbnail(imagePath, spec, &pixmap);
+        if (!known) {
+            QPointer<QWidget> view = const_cast<QWidget *>(option.widget);
+            QPersistentModelIndex persistentIndex(index);
+            auto *context = const_cast<CatalogCardDelegate *>(this);
+            m_imageService->thumbnail(imagePath, spec).then(context, [view, persistentIndex](const QPixmap &) {
+                if (auto *itemView = qobject_cast<QAbstractItemView *>(view.data())) {
+                    if (persistentIndex.isValid()) {
+                        itemView->update(persistentIndex);
+                    }
+                }
+            });
+        }
+    }
+
+    if (!pixmap.isNull()) {
+        const QSize logicalSize = pixmap.deviceIndependentSize().toSize();
+        painter->drawPixmap(rect.left() + (rect.width() - logicalSize.width()) / 2,
+                            rect.top() + (rect.height() - logicalSize.height()) / 2,
+                            pixmap);
+        return;
+    }
+
+    painter->setPen(Qt::NoPen);
+    painter->setBrush(QColor("#e0e0e0"));
+    if (spec.shape == ImageShape::Circle) {
+        painter->drawEllipse(rect);
+    } else {
+        painter->drawRoundedRect(rect, 4, 4);
+    }
+    // Текст-заглушка - лише коли точно відомо, що зображення немає (а не поки воно декодується)
+    if (known) {
+        painter->setPen(QColor("#555555"));
+        painter->setFont(cardFont(option.font, spec.shape == ImageShape::Circle ? 60 : 9, false));
+        painter->drawText(rect, Qt::AlignCenter, placeholder);
+    }
+}
+
+void CatalogCardDelegate::paintButton(QPainter *painter, const QStyleOptionViewItem &option, const QString &text,
+                                      const QColor &color, const QColor &hoverColor) const
+{
+    const QRect rect = buttonRect(option.rect);
+    bool hovered = false;
+    if (option.state & QStyle::State_MouseOver) {
+        if (auto *view = qobject_cast<const QAbstractItemView *>(option.widget)) {
+            hovered = rect.contains(view->viewport()->mapFromGlobal(QCursor::pos()));
+        }
+    }
+
+    painter->setPen(Qt::NoPen);
+    painter->setBrush(hovered ? hoverColor : color);
+    painter->drawRoundedRect(rect, CornerRadius, CornerRadius);
+    painter->setPen(Qt::white);
+    painter->setFont(cardFont(option.font, 9, false));
+    painter->drawText(rect, Qt::AlignCenter, text);
+}
+
+// Переносить текст по словах у межах rect.width(), не більше maxLines рядків (останній
+// обрізається трикрапкою). Повертає висоту намальованого тексту.
+int CatalogCardDelegate::drawWrappedText(QPainter *painter, const QRect &rect, const QString &text, int maxLines)
+{
+    if (text.isEmpty()) {
+        return 0;
+    }
+    const QFontMetrics metrics(painter->font());
+    QTextLayout layout(text, painter->font());
+    QTextOption textOption;
+    textOption.setWrapMode(QTextOption::WrapAtWordBoundaryOrAnywhere);
+    layout.setTextOption(textOption);
+
+    QStringList lines;
+    layout.beginLayout();
+    for (int i = 0; i < maxLines; ++i) {
+        QTextLine line = layout.createLine();
+        if (!line.isValid()) {
+            break;
+        }
+        line.setLineWidth(rect.width());
+        const int end = line.textStart() + line.textLength();
+        if (i == maxLines - 1 && end < text.size()) {
+            lines << metrics.elidedText(text.mid(line.textStart()).simplified(), Qt::ElideRight, rect.width());
+        } else {
+            lines << text.mid(line.textStart(), line.textLength()).trimmed();
+        }
+    }
+    layout.endLayout();
+
+    int y = rect.top();
+    for (const QString &line : std::as_const(lines)) {
+        painter->drawText(QRect(rect.left(), y, rect.width(), metrics.height()), Qt::AlignHCenter | Qt::AlignVCenter, line);
+        y += metrics.lineSpacing();
+    }
+    return lines.size() * metrics.lineSpacing();
+}
+
+bool CatalogCardDelegate::editorEvent(QEvent *event, QAbstractItemModel *model, const QStyleOptionViewItem &option,
+                                      const QModelIndex &index)
+{
+    if (event->type() == QEvent::MouseButtonPress || event->type() == QEvent::MouseButtonRelease
+        || event->type() == QEvent::MouseButtonDblClick) {
+        auto *mouseEvent = static_cast<QMouseEvent *>(event);
+        if (mouseEvent->button() == Qt::LeftButton && buttonRect(option.rect).contains(mouseEvent->position().toPoint())) {
+            // Клік по кнопці не повинен відкривати сторінку деталей: подію поглинаємо
+            if (event->type() == QEvent::MouseButtonRelease) {
+                const int id = index.data(CatalogRoles::IdRole).toInt();
+                if (index.data(CatalogRoles::KindRole).toInt() == CatalogGridModel::Authors) {
+                    emit authorBooksRequested(id);
+                } else {
+                    emit addToCartRequested(id);
+                }
+            }
+            return true;
+        }
+    }
+    return QStyledItemDelegate::editorEvent(event, model, option, index);
+}
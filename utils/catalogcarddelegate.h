@@ -0,0 +1,55 @@
+#ifndef CATALOGCARDDELEGATE_H
+#define CATALOGCARDDELEGATE_H
+
+#include <QStyledItemDelegate>
+#include <QPainter>
+#include <QStyleOptionViewItem>
+#include <QModelIndex>
+#include <QSize>
+#include "imageservice.h"
+
+// Малює картки книг і авторів для CatalogGridView (ролі CatalogRoles) - вигляд як у
+// колишніх QFrame-карток: обкладинка/фото, назва, автори або національність, ціна і кнопка.
+// Кнопка - лише намальований прямокутник: клік по ній перехоплює editorEvent і надсилає
+// сигнал, клік по решті картки обробляє view (сигнал clicked).
+class CatalogCardDelegate : public QStyledItemDelegate
+{
+    Q_OBJECT
+
+public:
+    static constexpr int CardWidth = 200;
+    static constexpr int BookCardHeight = 390;
+    static constexpr int AuthorCardHeight = 290;
+
+    explicit CatalogCardDelegate(QObject *parent = nullptr);
+
+    // Обкладинки й фото беруться з кешу ImageService; поки їх немає - сірий placeholder,
+    // а картка перемальовується, коли декодування завершиться
+    void setImageService(ImageService *imageService);
+
+    void paint(QPainter *painter, const QStyleOptionViewItem &option, const QModelIndex &index) const override;
+    QSize sizeHint(const QStyleOptionViewItem &option, const QModelIndex &index) const override;
+
+signals:
+    void addToCartRequested(int bookId);
+    void authorBooksRequested(int authorId);
+
+protected:
+    bool editorEvent(QEvent *event, QAbstractItemModel *model, const QStyleOptionViewItem &option,
+                     const QModelIndex &index) override;
+
+private:
+    void paintBookCard(QPainter *painter, const QStyleOptionViewItem &option, const QModelIndex &index) const;
+    void paintAuthorCard(QPainter *painter, const QStyleOptionViewItem &option, const QModelIndex &index) const;
+    void paintImage(QPainter *painter, const QStyleOptionViewItem &option, const QModelIndex &index,
+                    const QRect &rect, const ThumbnailSpec &spec, const QString &placeholder) const;
+    void paintButton(QPainter *painter, const QStyleOptionViewItem &option, const QString &text,
+                     const QColor &color, const QColor &hoverColor) const;
+    static int drawWrappedText(QPainter *painter, const QRect &rect, const QString &text, int maxLines);
+    static QRect contentRect(const QRect &cardRect);
+    static QRect buttonRect(const QRect &cardRect);
+
+    ImageService *m_imageService = nullptr;
+};
+
+#endif // CATALOGCARDDELEGATE_H
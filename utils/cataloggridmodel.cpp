@@ -0,0 +1,136 @@
+#include "cataloggridmodel.h"
+
+CatalogGridModel::CatalogGridModel(Kind kind, QObject *parent)
+    : QAbstractListModel(parent)
+    , m_kind(kind)
+{
+}
+
+int CatalogGridModel::rowCount(const QModelIndex &parent) const
+{
+    if (parent.isValid()) {
+        return 0;
+    }
+    return m_kind == Books ? m_books.size() : m_authors.size();
+}
+
+QVariant CatalogGridModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() < 0 || index.row() >= rowCount()) {
+        return QVariant();
+    }
+    if (role == CatalogRoles::KindRole) {
+        return int(m_kind);
+    }
+    return m_kind == Books ? bookData(m_books.at(index.row()), role)
+                           : authorData(m_authors.at(index.row()), role);
+}
+
+QVariant CatalogGridModel::bookData(const BookDisplayInfo &book, int role) const
+{
+    switch (role) {
+    case CatalogRoles::TitleRole:
+        return book.title;
+    case CatalogRoles::IdRole:
+        return book.bookId;
+    case CatalogRoles::SubtitleRole:
+        return book.authors.isEmpty() ? tr("Невідомий автор") : book.authors;
+    case CatalogRoles::ImagePathRole:
+        return book.coverImagePath;
+    case CatalogRoles::PriceRole:
+        return book.price;
+    case Qt::ToolTipRole:
+        return tr("%1\n%2").arg(book.title, book.authors);
+    default:
+        return QVariant();
+    }
+}
+
+QVariant CatalogGridModel::authorData(const AuthorDisplayInfo &author, int role) const
+{
+    switch (role) {
+    case CatalogRoles::TitleRole:
+        return author.firstName + " " + author.lastName;
+    case CatalogRoles::IdRole:
+        return author.authorId;
+    case CatalogRoles::SubtitleRole:
+        return author.nationality;
+    case CatalogRoles::ImagePathRole:
+        return author.imagePath;
+    default:
+        return QVariant();
+    }
+}
+
+void CatalogGridModel::setBooks(const QList<BookDisplayInfo> &books)
+{
+    beginResetModel();
+    m_books = books;
+    endResetModel();
+}
+
+void CatalogGridModel::appendBooks(const QList<BookDisplayInfo> &books)
+{
+    if (books.isEmpty()) {
+        return;
+    }
+    beginInsertRows(QModelIndex(), m_books.size(), m_books.size() + books.size() - 1);
+    m_books.append(books);
+    endInsertRows();
+}
+
+void CatalogGridModel::prependBooks(const QList<BookDisplayInfo> &books)
+{
+    if (books.isEmpty()) {
+        return;
+    }
+    beginInsertRows(QModelIndex(), 0, books.size() - 1);
+    m_books = books + m_books;
+    endInsertRows();
+}
+
+void CatalogGridModel::removeFirstRows(int count)
+{
+    count = qMin(count, rowCount());
+    if (count <= 0) {
+        return;
+    }
+    beginRemoveRows(QModelIndex(), 0, count - 1);
+    if (m_kind == Books) {
+        m_books.remove(0, count);
+    } else {
+        m_authors.remove(0, count);
+    }
+    endRemoveRows();
+}
+
+void CatalogGridModel::removeLastRows(int count)
+{
+    const int rows = rowCount();
+    count = qMin(count, rows);
+    if (count <= 0) {
+        return;
+    }
+    beginRemoveRows(QModelIndex(), rows - count, rows - 1);
+    if (m_kind == Books) {
+        m_books.remove(rows - count, count);
+    } else {
+        m_authors.remove(rows - count, count);
+    }
+    endRemoveRows();
+}
+
+void CatalogGridModel::setAuthors(const QList<AuthorDisplayInfo> &authors)
+{
+    beginResetModel();
+    m_authors = authors;
+    endResetModel();
+}
+
+void CatalogGridModel::clear()
+{
+    beginResetModel();
+    m_books.clear();
+    m_authors.clear();
+    endResetModel();
+}
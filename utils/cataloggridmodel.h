@@ -0,0 +1,59 @@
+#ifndef CATALOGGRIDMODEL_H
+#define CATALOGGRIDMODEL_H
+
+#include <QAbstractListModel>
+#include <QList>
+#include "datatypes.h"
+
+namespace CatalogRoles {
+    const int KindRole = Qt::UserRole + 1;        // CatalogGridModel::Kind
+    const int IdRole = Qt::UserRole + 2;          // bookId / authorId
+    const int SubtitleRole = Qt::UserRole + 3;    // Автори книги / національність автора
+    const int ImagePathRole = Qt::UserRole + 4;
+    const int PriceRole = Qt::UserRole + 5;
+    const int TitleRole = Qt::DisplayRole;        // Назва книги / ім'я автора
+}
+
+// Модель сітки каталогу (сторінки "Книги" та "Автори") для CatalogGridView і CatalogCardDelegate.
+// Зберігає лише структури з БД; картки малює делегат, тож вартість - рядки, а не віджети.
+class CatalogGridModel : public QAbstractListModel
+{
+    Q_OBJECT
+
+public:
+    enum Kind {
+        Books,
+        Authors
+    };
+    Q_ENUM(Kind)
+
+    explicit CatalogGridModel(Kind kind, QObject *parent = nullptr);
+
+    Kind kind() const { return m_kind; }
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+
+    void setBooks(const QList<BookDisplayInfo> &books);
+    // Посторінкове завантаження: рядки додаються/прибираються з країв без скидання моделі,
+    // тож уже показані картки не перебудовуються
+    void appendBooks(const QList<BookDisplayInfo> &books);
+    void prependBooks(const QList<BookDisplayInfo> &books);
+    void removeFirstRows(int count);
+    void removeLastRows(int count);
+    void setAuthors(const QList<AuthorDisplayInfo> &authors);
+    void clear();
+
+    const QList<BookDisplayInfo> &books() const { return m_books; }
+    const QList<AuthorDisplayInfo> &authors() const { return m_authors; }
+
+private:
+    QVariant bookData(const BookDisplayInfo &book, int role) const;
+    QVariant authorData(const AuthorDisplayInfo &author, int role) const;
+
+    Kind m_kind;
+    QList<BookDisplayInfo> m_books;
+    QList<AuthorDisplayInfo> m_authors;
+};
+
+#endif // CATALOGGRIDMODEL_H
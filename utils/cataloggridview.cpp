@@ -0,0 +1,150 @@
+#include "cataloggridview.h"
+#include <QMouseEvent>
+#include <QResizeEvent>
+#include <QPainter>
+#include <QScrollBar>
+
+CatalogGridView::CatalogGridView(QWidget *parent)
+    : QListView(parent)
+{
+    setViewMode(QListView::ListMode);
+    setFlow(QListView::LeftToRight);
+    setWrapping(true);
+    // Adjust перерозкладає з затримкою 100 мс після кожного кроку; розкладку за розміром
+    // робимо самі (resizeEvent), рівно раз за кадр
+    setResizeMode(QListView::Fixed);
+    setMovement(QListView::Static);
+    setUniformItemSizes(true);   // Розкладка без sizeHint() для кожного рядка
+    setSpacing(12);
+    setSelectionMode(QAbstractItemView::NoSelection);
+    setEditTriggers(QAbstractItemView::NoEditTriggers);
+    setHorizontalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
+    setVerticalScrollMode(QAbstractItemView::ScrollPerPixel);
+    verticalScrollBar()->setSingleStep(24);
+    setFrameShape(QFrame::NoFrame);
+    setMouseTracking(true);
+    viewport()->setAttribute(Qt::WA_Hover);
+
+    m_relayoutTimer.setSingleShot(true);
+    m_relayoutTimer.setInterval(RelayoutIntervalMs);
+    connect(&m_relayoutTimer, &QTimer::timeout, this, &CatalogGridView::relayout);
+
+    connect(verticalScrollBar(), &QScrollBar::valueChanged, this, &CatalogGridView::checkScrollEdges);
+    connect(verticalScrollBar(), &QScrollBar::rangeChanged, this, &CatalogGridView::checkScrollEdges);
+}
+
+void CatalogGridView::resizeEvent(QResizeEvent *event)
+{
+    QListView::resizeEvent(event);
+    // Не перезапускаємо активний таймер: під час перетягування розкладка оновлюється
+    // з частотою кадрів, а не лише після того, як користувач відпустить край вікна
+    if (event->size().width() != event->oldSize().width() && !m_relayoutTimer.isActive()) {
+        m_relayoutTimer.start();
+    }
+}
+
+void CatalogGridView::relayout()
+{
+    // Верхня видима картка лишається вгорі, хоч кількість колонок і змінилася
+    const QModelIndex anchor = firstVisibleIndex();
+    doItemsLayout();
+    if (anchor.isValid()) {
+        scrollTo(anchor, QAbstractItemView::PositionAtTop);
+    }
+}
+
+QModelIndex CatalogGridView::firstVisibleIndex() const
+{
+    // Перша колонка; крок менший за проміжок між рядами карток, тож ряд не пропустимо
+    const int step = qMax(1, spacing());
+    for (int y = 0; y < viewport()->height(); y += step) {
+        const QModelIndex index = indexAt(QPoint(spacing() + 1, y));
+        if (index.isValid()) {
+            return index;
+        }
+    }
+    return QModelIndex();
+}
+
+void CatalogGridView::preserveScrollPosition(int rowShift, const std::function<void()> &change)
+{
+    executeDelayedItemsLayout();
+    const QModelIndex anchor = firstVisibleIndex();
+    const int anchorRow = anchor.isValid() ? anchor.row() : -1;
+    const int anchorTop = anchor.isValid() ? visualRect(anchor).top() : 0;
+
+    change();
+
+    if (anchorRow < 0 || !model()) {
+        return;
+    }
+    const QModelIndex moved = model()->index(anchorRow + rowShift, 0, rootIndex());
+    if (!moved.isValid()) {
+        return;
+    }
+    executeDelayedItemsLayout();
+    QScrollBar *bar = verticalScrollBar();
+    bar->setValue(bar->value() + visualRect(moved).top() - anchorTop);
+}
+
+void CatalogGridView::checkScrollEdges()
+{
+    if (!model() || model()->rowCount(rootIndex()) == 0) {
+        return;
+    }
+    const QScrollBar *bar = verticalScrollBar();
+    const int distance = viewport()->height() * PrefetchScreens;
+    if (bar->value() - bar->minimum() <= distance) {
+        emit nearStartReached();
+    }
+    if (bar->maximum() - bar->value() <= distance) {
+        emit nearEndReached();
+    }
+}
+
+void CatalogGridView::setPlaceholderText(const QString &text)
+{
+    m_placeholderText = text;
+    viewport()->update();
+}
+
+void CatalogGridView::paintEvent(QPaintEvent *event)
+{
+    QListView::paintEvent(event);
+
+    if (m_placeholderText.isEmpty() || (model() && model()->rowCount(rootIndex()) > 0)) {
+        return;
+    }
+    QPainter painter(viewport());
+    painter.setPen(QColor("#777777"));
+    painter.drawText(viewport()->rect().adjusted(20, 20, -20, -20), Qt::AlignHCenter | Qt::AlignTop | Qt::TextWordWrap,
+                     m_placeholderText);
+}
+
+void CatalogGridView::mouseMoveEvent(QMouseEvent *event)
+{
+    QListView::mouseMoveEvent(event);
+
+    const QModelIndex index = indexAt(event->position().toPoint());
+    if (index != m_hoveredIndex) {
+        if (m_hoveredIndex.isValid()) {
+            update(m_hoveredIndex);
+        }
+        m_hoveredIndex = index;
+        viewport()->setCursor(index.isValid() ? Qt::PointingHandCursor : Qt::ArrowCursor);
+    }
+    // Кнопка всередині картки підсвічується за позицією курсора - перемальовуємо лише цю картку
+    if (index.isValid()) {
+        update(index);
+    }
+}
+
+void CatalogGridView::leaveEvent(QEvent *event)
+{
+    QListView::leaveEvent(event);
+    if (m_hoveredIndex.isValid()) {
+        update(m_hoveredIndex);
+    }
+    m_hoveredIndex = QPersistentModelIndex();
+    viewport()->unsetCursor();
+}
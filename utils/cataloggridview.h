@@ -0,0 +1,58 @@
+#ifndef CATALOGGRIDVIEW_H
+#define CATALOGGRIDVIEW_H
+
+#include <QListView>
+#include <QString>
+#include <QTimer>
+#include <functional>
+
+// Сітка карток каталогу: QListView, що переносить рядки за шириною (LeftToRight + wrapping)
+// з однаковим розміром елементів, тож розкладка не залежить від кількості рядків моделі,
+// а малюються лише видимі картки. Ширина вікна змінює лише кількість колонок - без
+// повторного завантаження даних: під час перетягування краю вікна перерозкладка
+// виконується не частіше за RelayoutIntervalMs, і картка вгорі лишається на місці.
+// Також: текст-заглушка для порожньої моделі, перемальовування картки під курсором
+// (делегат підсвічує кнопку всередині картки) і сигнали наближення до країв прокрутки
+// для посторінкового довантаження.
+class CatalogGridView : public QListView
+{
+    Q_OBJECT
+
+public:
+    static constexpr int RelayoutIntervalMs = 16;   // ~60 кадрів/с
+    static constexpr int PrefetchScreens = 2;       // "Біля краю" - ближче за стільки висот viewport
+
+    explicit CatalogGridView(QWidget *parent = nullptr);
+
+    void setPlaceholderText(const QString &text);
+    QString placeholderText() const { return m_placeholderText; }
+
+    // Виконує change() (вставку чи видалення рядків моделі) так, щоб картка, видима вгорі,
+    // лишилася на тому самому місці екрана. rowShift - на скільки зсунеться її номер рядка.
+    void preserveScrollPosition(int rowShift, const std::function<void()> &change);
+
+public slots:
+    // Надсилає nearStartReached / nearEndReached, якщо прокрутка біля відповідного краю
+    // (зокрема коли вміст ще не заповнює viewport)
+    void checkScrollEdges();
+
+signals:
+    void nearStartReached();
+    void nearEndReached();
+
+protected:
+    void resizeEvent(QResizeEvent *event) override;
+    void paintEvent(QPaintEvent *event) override;
+    void mouseMoveEvent(QMouseEvent *event) override;
+    void leaveEvent(QEvent *event) override;
+
+private:
+    void relayout();
+    QModelIndex firstVisibleIndex() const;
+
+    QString m_placeholderText;
+    QTimer m_relayoutTimer;
+    QPersistentModelIndex m_hoveredIndex;
+};
+
+#endif // CATALOGGRIDVIEW_H
@@ -0,0 +1,718 @@
+#include "datagenerator.h"
+#include "logging.h"
+#include "database.h"
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QSet>
+#include <QSqlDriver>
+#include <QSqlError>
+#include <QSqlQuery>
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <functional>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#ifdef BOOKSTORE_HAVE_LIBPQ
+#include <libpq-fe.h>
+#endif
+
+namespace {
+
+// Теги таблиць для виведення незалежних seed кожного шматка
+enum TableTag : quint64 {
+    TagPublisher = 1, TagAuthor, TagCustomer, TagBook, TagBookAuthor, TagOrder, TagComment, TagCart, TagPrice
+};
+
+quint64 mix(quint64 value)
+{
+    value += 0x9E3779B97F4A7C15ULL;
+    value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    value = (value ^ (value >> 27)) * 0x94D049BB133111EBULL;
+    return value ^ (value >> 31);
+}
+
+// Розподіли std:: залежать від реалізації бібліотеки, тому перетворення робимо самі
+double uniform01(std::mt19937_64 &rng)
+{
+    return static_cast<double>(rng() >> 11) * (1.0 / 9007199254740992.0);
+}
+
+int uniformInt(std::mt19937_64 &rng, int from, int to)
+{
+    return from + static_cast<int>(rng() % static_cast<quint64>(to - from + 1));
+}
+
+// Zipf на [1, n] через таблицю кумулятивних ймовірностей (8 байт на значення)
+class ZipfDistribution
+{
+public:
+    ZipfDistribution(int n, double skew)
+    {
+        m_cdf.resize(static_cast<size_t>(qMax(1, n)));
+        double sum = 0.0;
+        for (size_t i = 0; i < m_cdf.size(); ++i) {
+            sum += 1.0 / std::pow(static_cast<double>(i + 1), skew);
+            m_cdf[i] = sum;
+        }
+        for (double &value : m_cdf) {
+            value /= sum;
+        }
+    }
+
+    int operator()(std::mt19937_64 &rng) const
+    {
+        const double u = uniform01(rng);
+        const auto it = std::lower_bound(m_cdf.begin(), m_cdf.end(), u);
+        return 1 + static_cast<int>(qMin<size_t>(it - m_cdf.begin(), m_cdf.size() - 1));
+    }
+
+    int size() const { return static_cast<int>(m_cdf.size()); }
+
+private:
+    std::vector<double> m_cdf;
+};
+
+// Zipf за рангом плюс перестановка рангів в ID, щоб популярні записи не були першими ID
+class PopularityPicker
+{
+public:
+    PopularityPicker(int n, double skew)
+        : m_zipf(n, skew), m_n(qMax(1, n))
+    {
+        m_stride = 2654435761ULL % static_cast<quint64>(m_n);
+        while (m_stride == 0 || std::gcd(m_stride, static_cast<quint64>(m_n)) != 1) {
+            ++m_stride;
+        }
+    }
+
+    int operator()(std::mt19937_64 &rng) const
+    {
+        const quint64 rank = static_cast<quint64>(m_zipf(rng) - 1);
+        return 1 + static_cast<int>((rank * m_stride) % static_cast<quint64>(m_n));
+    }
+
+private:
+    ZipfDistribution m_zipf;
+    int m_n;
+    quint64 m_stride = 1;
+};
+
+const QStringList &firstNames()
+{
+    static const QStringList names = {"Олександр", "Андрій", "Сергій", "Володимир", "Дмитро", "Максим", "Іван", "Артем",
+                                      "Денис", "Віктор", "Олена", "Наталія", "Тетяна", "Юлія", "Ірина", "Анна",
+                                      "Оксана", "Марія", "Світлана", "Катерина"};
+    return names;
+}
+
+const QStringList &lastNames()
+{
+    static const QStringList names = {"Мельник", "Шевченко", "Коваленко", "Бондаренко", "Бойко", "Ткаченко",
+                                      "Кравченко", "Ковальчук", "Коваль", "Олійник", "Шевчук", "Поліщук", "Лисенко",
+                                      "Бондар", "Мороз", "Марченко", "Ткачук", "Павленко", "Савченко", "Руденко"};
+    return names;
+}
+
+const QStringList &titleAdjectives()
+{
+    static const QStringList words = {"Таємний", "Останній", "Забутий", "Темний", "Зоряний", "Тихий", "Великий",
+                                      "Загублений", "Срібний", "Холодний", "Вічний", "Дикий", "Новий", "Старий",
+                                      "Північний", "Кам'яний", "Скляний", "Нічний", "Перший", "Далекий"};
+    return words;
+}
+
+const QStringList &titleNouns()
+{
+    static const QStringList words = {"сад", "місто", "ліс", "берег", "шлях", "острів", "вітер", "дім", "світ", "час",
+                                      "годинник", "океан", "лабіринт", "маяк", "архів", "код", "двір", "міст",
+                                      "кордон", "спадок", "сон", "рецепт", "детектив", "мандрівник", "алгоритм"};
+    return words;
+}
+
+const QStringList &cities()
+{
+    static const QStringList names = {"Київ", "Харків", "Одеса", "Дніпро", "Львів", "Запоріжжя", "Вінниця",
+                                      "Полтава", "Чернігів", "Ужгород"};
+    return names;
+}
+
+const QStringList &orderStatusFlow()
+{
+    static const QStringList statuses = {"Очікує підтвердження", "В обробці", "Надіслано", "Доставлено"};
+    return statuses;
+}
+
+template <typename T>
+const T &pickFrom(const QList<T> &values, std::mt19937_64 &rng)
+{
+    return values.at(uniformInt(rng, 0, values.size() - 1));
+}
+
+QString dateText(const QDate &date)
+{
+    return date.toString(Qt::ISODate);
+}
+
+QString timestampText(const QDateTime &dateTime)
+{
+    return dateTime.toUTC().toString("yyyy-MM-dd HH:mm:ss") + "+00";
+}
+
+// Куди пишуться рядки однієї таблиці. Порожній (null) QString означає NULL.
+class RowSink
+{
+public:
+    virtual ~RowSink() = default;
+    virtual bool begin(const QString &table, const QStringList &columns) = 0;
+    virtual bool addRow(const QStringList &fields) = 0;
+    virtual bool end() = 0;
+    qint64 rows() const { return m_rows; }
+
+protected:
+    qint64 m_rows = 0;
+};
+
+#ifdef BOOKSTORE_HAVE_LIBPQ
+// COPY ... FROM STDIN у текстовому форматі через libpq того самого з'єднання, що й QSqlDatabase
+class CopySink : public RowSink
+{
+public:
+    explicit CopySink(PGconn *connection) : m_connection(connection) {}
+
+    bool begin(const QString &table, const QStringList &columns) override
+    {
+        m_table = table;
+        m_buffer.clear();
+        const QByteArray sql = QString("COPY %1 (%2) FROM STDIN").arg(table, columns.join(", ")).toUtf8();
+        PGresult *result = PQexec(m_connection, sql.constData());
+        const bool ok = PQresultStatus(result) == PGRES_COPY_IN;
+        if (!ok) {
+            qCCritical(lcDbSeed) << "DataGenerator: COPY" << table << "не розпочато:" << PQerrorMessage(m_connection);
+        }
+        PQclear(result);
+        return ok;
+    }
+
+    bool addRow(const QStringList &fields) override
+    {
+        for (int i = 0; i < fields.size(); ++i) {
+            if (i > 0) m_buffer += '\t';
+            appendEscaped(fields.at(i));
+        }
+        m_buffer += '\n';
+        ++m_rows;
+        return m_buffer.size() < FlushBytes || flush();
+    }
+
+    bool end() override
+    {
+        bool ok = flush();
+        if (PQputCopyEnd(m_connection, ok ? nullptr : "DataGenerator: перервано") != 1) {
+            ok = false;
+        }
+        while (PGresult *result = PQgetResult(m_connection)) {
+            if (PQresultStatus(result) != PGRES_COMMAND_OK) {
+                qCCritical(lcDbSeed) << "DataGenerator: COPY" << m_table << "завершився з помилкою:" << PQresultErrorMessage(result);
+                ok = false;
+            }
+            PQclear(result);
+        }
+        return ok;
+    }
+
+private:
+    static constexpr int FlushBytes = 1 << 20;
+
+    void appendEscaped(const QString &field)
+    {
+        if (field.isNull()) {
+            m_buffer += "\\N";
+            return;
+        }
+        const QByteArray utf8 = field.toUtf8();
+        for (char c : utf8) {
+            switch (c) {
+            case '\\': m_buffer += "\\\\"; break;
+            case '\t': m_buffer += "\\t"; break;
+            case '\n': m_buffer += "\\n"; break;
+            case '\r': m_buffer += "\\r"; break;
+            default: m_buffer += c;
+            }
+        }
+    }
+
+    bool flush()
+    {
+        if (m_buffer.isEmpty()) {
+            return true;
+        }
+        const bool ok = PQputCopyData(m_connection, m_buffer.constData(), m_buffer.size()) == 1;
+        if (!ok) {
+            qCCritical(lcDbSeed) << "DataGenerator: помилка передачі даних COPY" << m_table << ":" << PQerrorMessage(m_connection);
+        }
+        m_buffer.clear();
+        return ok;
+    }
+
+    PGconn *m_connection;
+    QString m_table;
+    QByteArray m_buffer;
+};
+#endif
+
+// Запасний шлях без libpq: багаторядкові INSERT з літералами (PostgreSQL сам приводить типи)
+class InsertSink : public RowSink
+{
+public:
+    explicit InsertSink(const QSqlDatabase &db) : m_query(db) {}
+
+    bool begin(const QString &table, const QStringList &columns) override
+    {
+        m_prefix = QString("INSERT INTO %1 (%2) VALUES ").arg(table, columns.join(", "));
+        m_values.clear();
+        m_pending = 0;
+        return true;
+    }
+
+    bool addRow(const QStringList &fields) override
+    {
+        QStringList literals;
+        literals.reserve(fields.size());
+        for (const QString &field : fields) {
+            literals << (field.isNull() ? QStringLiteral("NULL") : "'" + QString(field).replace("'", "''") + "'");
+        }
+        if (m_pending > 0) m_values += ',';
+        m_values += '(' + literals.join(',') + ')';
+        ++m_rows;
+        return ++m_pending < BatchRows || flush();
+    }
+
+    bool end() override
+    {
+        return flush();
+    }
+
+private:
+    static constexpr int BatchRows = 1000;
+
+    bool flush()
+    {
+        if (m_pending == 0) {
+            return true;
+        }
+        const bool ok = m_query.exec(m_prefix + m_values);
+        if (!ok) {
+            qCCritical(lcDbSeed) << "DataGenerator: помилка пакетного INSERT:" << m_query.lastError().text();
+        }
+        m_values.clear();
+        m_pending = 0;
+        return ok;
+    }
+
+    QSqlQuery m_query;
+    QString m_prefix;
+    QString m_values;
+    int m_pending = 0;
+};
+
+// Спільний незмінний контекст генерації; читається з усіх потоків
+struct GeneratorContext {
+    DataGeneratorConfig config;
+    QString passwordHash;
+    std::unique_ptr<PopularityPicker> books;
+    std::unique_ptr<PopularityPicker> authors;
+    std::unique_ptr<PopularityPicker> customers;
+    std::unique_ptr<PopularityPicker> publishers;
+    std::unique_ptr<ZipfDistribution> genres;
+    std::unique_ptr<ZipfDistribution> languages;
+    std::unique_ptr<ZipfDistribution> orderSize;
+    QDate today;
+
+    std::mt19937_64 chunkRng(TableTag tag, int chunk) const
+    {
+        return std::mt19937_64(mix(config.seed ^ mix((static_cast<quint64>(tag) << 32) | static_cast<quint32>(chunk))));
+    }
+
+    // Ціна залежить лише від seed і ID, тож позиції замовлень знають її без запиту до book
+    QString bookPrice(int bookId) const
+    {
+        const quint64 bits = mix(config.seed ^ mix((static_cast<quint64>(TagPrice) << 32) | static_cast<quint32>(bookId)));
+        const qint64 cents = 4900 + static_cast<qint64>(bits % 95100);
+        return QString::number(cents / 100) + '.' + QString::number(cents % 100).rightJustified(2, '0');
+    }
+};
+
+using ChunkFn = std::function<bool(const GeneratorContext &, RowSink &, std::mt19937_64 &, int from, int to)>;
+
+bool writePublishers(const GeneratorContext &, RowSink &sink, std::mt19937_64 &rng, int from, int to)
+{
+    if (!sink.begin("publisher", {"publisher_id", "name", "contact_info"})) return false;
+    for (int id = from; id <= to; ++id) {
+        if (!sink.addRow({QString::number(id), QString("Видавництво №%1").arg(id),
+                          QString("%1, publisher%2@example.com").arg(pickFrom(cities(), rng)).arg(id)})) return false;
+    }
+    return sink.end();
+}
+
+bool writeAuthors(const GeneratorContext &, RowSink &sink, std::mt19937_64 &rng, int from, int to)
+{
+    if (!sink.begin("author", {"author_id", "first_name", "last_name", "birth_date", "nationality", "image_path", "biography"})) return false;
+    static const QStringList nationalities = {"Україна", "Україна", "Україна", "Велика Британія", "США", "Франція", "Німеччина", "Польща"};
+    for (int id = from; id <= to; ++id) {
+        const QString firstName = pickFrom(firstNames(), rng);
+        const QString lastName = pickFrom(lastNames(), rng);
+        const QDate birthDate = QDate(1900, 1, 1).addDays(uniformInt(rng, 0, 36500));
+        if (!sink.addRow({QString::number(id), firstName, lastName, dateText(birthDate), pickFrom(nationalities, rng), QString(),
+                          QString("%1 %2 - автор; рік народження %3.").arg(firstName, lastName).arg(birthDate.year())})) return false;
+    }
+    return sink.end();
+}
+
+bool writeCustomers(const GeneratorContext &context, RowSink &sink, std::mt19937_64 &rng, int from, int to)
+{
+    if (!sink.begin("customer", {"customer_id", "first_name", "last_name", "email", "phone", "address", "password_hash",
+                                 "loyalty_program", "join_date", "loyalty_points"})) return false;
+    for (int id = from; id <= to; ++id) {
+        const bool loyalty = uniform01(rng) < 0.3;
+        if (!sink.addRow({QString::number(id), pickFrom(firstNames(), rng), pickFrom(lastNames(), rng),
+                          syntheticCustomerEmail(id), QString("+380%1").arg(uniformInt(rng, 0, 999999999), 9, 10, QChar('0')),
+                          QString("%1, вул. Синтетична, %2").arg(pickFrom(cities(), rng)).arg(uniformInt(rng, 1, 200)),
+                          context.passwordHash, loyalty ? "true" : "false",
+                          dateText(context.today.addDays(-uniformInt(rng, 0, 3650))),
+                          QString::number(loyalty ? uniformInt(rng, 0, 2000) : 0)})) return false;
+    }
+    return sink.end();
+}
+
+bool writeBooks(const GeneratorContext &context, RowSink &sink, std::mt19937_64 &rng, int from, int to)
+{
+    if (!sink.begin("book", {"book_id", "title", "isbn", "publication_date", "publisher_id", "price", "stock_quantity",
+                             "description", "language", "page_count", "cover_image_path", "genre"})) return false;
+    const QStringList genres = syntheticGenres();
+    const QStringList languages = syntheticLanguages();
+    for (int id = from; id <= to; ++id) {
+        QString title = pickFrom(titleAdjectives(), rng) + ' ' + pickFrom(titleNouns(), rng);
+        if (uniform01(rng) < 0.3) {
+            title += QString(". Том %1").arg(uniformInt(rng, 1, 5));
+        }
+        const QString genre = genres.at(qMin((*context.genres)(rng), int(genres.size())) - 1);
+        // Приблизно 5% книг немає в наявності
+        const int stock = uniform01(rng) < 0.05 ? 0 : uniformInt(rng, 1, 500);
+        if (!sink.addRow({QString::number(id), title, QString("978%1").arg(id, 10, 10, QChar('0')),
+                          dateText(QDate(1950, 1, 1).addDays(uniformInt(rng, 0, 27000))),
+                          QString::number((*context.publishers)(rng)), context.bookPrice(id), QString::number(stock),
+                          QString("%1. Книга жанру \"%2\".").arg(title, genre),
+                          languages.at(qMin((*context.languages)(rng), int(languages.size())) - 1),
+                          QString::number(uniformInt(rng, 60, 900)), QString(), genre})) return false;
+    }
+    return sink.end();
+}
+
+bool writeBookAuthors(const GeneratorContext &context, RowSink &sink, std::mt19937_64 &rng, int from, int to)
+{
+    if (!sink.begin("book_author", {"book_id", "author_id", "role"})) return false;
+    for (int id = from; id <= to; ++id) {
+        const int author = (*context.authors)(rng);
+        if (!sink.addRow({QString::number(id), QString::number(author), "Автор"})) return false;
+        if (uniform01(rng) < 0.2) {
+            const int coAuthor = (*context.authors)(rng);
+            if (coAuthor != author && !sink.addRow({QString::number(id), QString::number(coAuthor), "Співавтор"})) return false;
+        }
+    }
+    return sink.end();
+}
+
+// Замовлення разом із позиціями та статусами: одне з'єднання веде лише один COPY,
+// тож позиції й статуси накопичуються і пишуться після заголовків
+bool writeOrders(const GeneratorContext &context, RowSink &sink, std::mt19937_64 &rng, int from, int to)
+{
+    static const QStringList paymentMethods = {"Карткою онлайн", "Готівкою при отриманні", "Переказ на рахунок"};
+    const QDateTime now = QDateTime(context.today, QTime(12, 0), Qt::UTC);
+
+    QList<QStringList> items;
+    QList<QStringList> statuses;
+    if (!sink.begin("\"order\"", {"order_id", "customer_id", "order_date", "total_amount", "shipping_address", "payment_method"})) return false;
+    for (int id = from; id <= to; ++id) {
+        const QDateTime orderDate = now.addSecs(-static_cast<qint64>(uniform01(rng) * 5 * 365 * 86400));
+        const int itemCount = qMin((*context.orderSize)(rng), context.config.books);
+
+        QSet<int> bookIds;
+        qint64 totalCents = 0;
+        while (bookIds.size() < itemCount) {
+            const int bookId = (*context.books)(rng);
+            if (bookIds.contains(bookId)) continue;
+            bookIds.insert(bookId);
+            const int quantity = uniform01(rng) < 0.8 ? 1 : uniformInt(rng, 2, 4);
+            const QString price = context.bookPrice(bookId);
+            totalCents += qRound64(price.toDouble() * 100) * quantity;
+            items.append({QString::number(id), QString::number(bookId), QString::number(quantity), price});
+        }
+
+        // Статуси йдуть по порядку; давніші замовлення встигли просунутися далі
+        const int ageDays = static_cast<int>(orderDate.daysTo(now));
+        const int stage = qMin(int(orderStatusFlow().size()), 1 + ageDays / 3 + (uniform01(rng) < 0.5 ? 0 : 1));
+        for (int s = 0; s < stage; ++s) {
+            const QString status = orderStatusFlow().at(s);
+            statuses.append({QString::number(id), status, timestampText(orderDate.addDays(s)),
+                             status == "Надіслано" ? QString("TRK%1").arg(id, 9, 10, QChar('0')) : QString()});
+        }
+
+        if (!sink.addRow({QString::number(id), QString::number((*context.customers)(rng)), timestampText(orderDate),
+                          QString::number(totalCents / 100) + '.' + QString::number(totalCents % 100).rightJustified(2, '0'),
+                          QString("%1, вул. Доставки, %2").arg(pickFrom(cities(), rng)).arg(uniformInt(rng, 1, 200)),
+                          pickFrom(paymentMethods, rng)})) return false;
+    }
+    if (!sink.end()) return false;
+
+    if (!sink.begin("order_item", {"order_id", "book_id", "quantity", "price_per_unit"})) return false;
+    for (const QStringList &row : std::as_const(items)) {
+        if (!sink.addRow(row)) return false;
+    }
+    if (!sink.end()) return false;
+
+    if (!sink.begin("order_status", {"order_id", "status", "status_date", "tracking_number"})) return false;
+    for (const QStringList &row : std::as_const(statuses)) {
+        if (!sink.addRow(row)) return false;
+    }
+    return sink.end();
+}
+
+bool writeComments(const GeneratorContext &context, RowSink &sink, std::mt19937_64 &rng, int from, int to)
+{
+    static const QStringList phrases = {"Чудова книга, рекомендую!", "Читається на одному диханні.",
+                                        "Очікував більшого.", "Гарний переклад і якісне видання.",
+                                        "Сюжет затягнутий, але фінал вартий того.", "Перечитуватиму ще не раз."};
+    if (!sink.begin("comment", {"book_id", "customer_id", "comment_text", "comment_date", "rating"})) return false;
+    const QDateTime now = QDateTime(context.today, QTime(12, 0), Qt::UTC);
+    for (int id = from; id <= to; ++id) {
+        // Оцінки зміщені до високих, як у реальних відгуках
+        const double r = uniform01(rng);
+        const int rating = r < 0.45 ? 5 : r < 0.75 ? 4 : r < 0.88 ? 3 : r < 0.95 ? 2 : 1;
+        if (!sink.addRow({QString::number((*context.books)(rng)), QString::number(uniformInt(rng, 1, context.config.customers)),
+                          pickFrom(phrases, rng), timestampText(now.addSecs(-static_cast<qint64>(uniform01(rng) * 3 * 365 * 86400))),
+                          QString::number(rating)})) return false;
+    }
+    return sink.end();
+}
+
+bool writeCartItems(const GeneratorContext &context, RowSink &sink, std::mt19937_64 &rng, int from, int to)
+{
+    if (!sink.begin("cart_item", {"customer_id", "book_id", "quantity"})) return false;
+    for (int customerId = from; customerId <= to; ++customerId) {
+        if (uniform01(rng) >= context.config.cartCustomerShare) continue;
+        const int itemCount = qMin((*context.orderSize)(rng), context.config.books);
+        QSet<int> bookIds;
+        while (bookIds.size() < itemCount) {
+            const int bookId = (*context.books)(rng);
+            if (bookIds.contains(bookId)) continue;
+            bookIds.insert(bookId);
+            if (!sink.addRow({QString::number(customerId), QString::number(bookId), QString::number(uniformInt(rng, 1, 3))})) return false;
+        }
+    }
+    return sink.end();
+}
+
+struct Task {
+    QString label;
+    TableTag tag;
+    int chunk;
+    int from;
+    int to;
+    ChunkFn fn;
+};
+
+void appendChunks(QList<Task> &tasks, const QString &label, TableTag tag, int count, int chunkRows, const ChunkFn &fn)
+{
+    chunkRows = qMax(1, chunkRows);
+    for (int from = 1, chunk = 0; from <= count; from += chunkRows, ++chunk) {
+        tasks.append({label, tag, chunk, from, qMin(count, from + chunkRows - 1), fn});
+    }
+}
+
+} // namespace
+
+DataGeneratorConfig DataGeneratorConfig::forBooks(int books)
+{
+    DataGeneratorConfig config;
+    config.books = qMax(1, books);
+    config.publishers = qMax(10, config.books / 100);
+    config.authors = qMax(50, config.books / 20);
+    config.customers = qMax(100, config.books / 10);
+    config.orders = qMax(100, config.books / 2);
+    config.comments = config.books;
+    return config;
+}
+
+QString syntheticCustomerEmail(int customerId)
+{
+    return QString("customer%1@example.com").arg(customerId);
+}
+
+QStringList syntheticGenres()
+{
+    // Порядок задає популярність (Zipf за рангом)
+    return {"Роман", "Детектив", "Фентезі", "Наукова фантастика", "Дитяча література", "Історія", "Психологія",
+            "Бізнес", "Пригоди", "Біографія", "Поезія", "Жахи"};
+}
+
+QStringList syntheticLanguages()
+{
+    return {"Українська", "Англійська", "Польська", "Німецька", "Французька"};
+}
+
+bool generateSyntheticData(DatabaseManager *dbManager, const DataGeneratorConfig &config, DataGeneratorReport *report)
+{
+    if (!dbManager || !dbManager->isConnected()) {
+        qCCritical(lcDbSeed) << "DataGenerator: немає з'єднання з БД.";
+        return false;
+    }
+    if (config.recreateSchema && !dbManager->createSchemaTables()) {
+        qCCritical(lcDbSeed) << "DataGenerator: не вдалося перестворити схему.";
+        return false;
+    }
+    // Порожні таблиці: COPY без вторинних індексів, а побудова один раз після завантаження
+    if (config.recreateSchema && !dbManager->dropSecondaryIndexes()) {
+        qCWarning(lcDbSeed) << "DataGenerator: вторинні індекси не видалено, завантаження буде повільнішим.";
+    }
+
+    QElapsedTimer total;
+    total.start();
+
+    GeneratorContext context;
+    context.config = config;
+    context.passwordHash = QString::fromLatin1(
+        QCryptographicHash::hash(config.customerPassword.toUtf8(), QCryptographicHash::Sha256).toHex());
+    context.books = std::make_unique<PopularityPicker>(config.books, config.popularitySkew);
+    context.authors = std::make_unique<PopularityPicker>(config.authors, config.popularitySkew);
+    context.customers = std::make_unique<PopularityPicker>(config.customers, config.popularitySkew);
+    context.publishers = std::make_unique<PopularityPicker>(config.publishers, config.popularitySkew);
+    context.genres = std::make_unique<ZipfDistribution>(syntheticGenres().size(), 0.8);
+    context.languages = std::make_unique<ZipfDistribution>(syntheticLanguages().size(), 1.5);
+    context.orderSize = std::make_unique<ZipfDistribution>(qMax(1, config.maxItemsPerOrder), config.orderSizeSkew);
+    // Дата "сьогодні" з seed, а не з годинника: інакше дані відрізнялися б між запусками
+    context.today = QDate(2024, 1, 1).addDays(static_cast<qint64>(config.seed % 365));
+
+    // Фази за зовнішніми ключами; усередині фази шматки вантажаться паралельно
+    QList<QList<Task>> phases(3);
+    appendChunks(phases[0], "publisher", TagPublisher, config.publishers, config.chunkRows, writePublishers);
+    appendChunks(phases[0], "author", TagAuthor, config.authors, config.chunkRows, writeAuthors);
+    appendChunks(phases[0], "customer", TagCustomer, config.customers, config.chunkRows, writeCustomers);
+    appendChunks(phases[1], "book", TagBook, config.books, config.chunkRows, writeBooks);
+    appendChunks(phases[2], "book_author", TagBookAuthor, config.books, config.chunkRows, writeBookAuthors);
+    appendChunks(phases[2], "order", TagOrder, config.orders, config.chunkRows, writeOrders);
+    appendChunks(phases[2], "comment", TagComment, config.comments, config.chunkRows, writeComments);
+    appendChunks(phases[2], "cart_item", TagCart, config.customers, config.chunkRows, writeCartItems);
+
+    // Шматки вантажуться на робочих потоках DatabaseManager (runAsync): кожен потік тримає одне
+    // з'єднання пулу, тож власний пул потоків генератора не займає з'єднань поза ним.
+    // Одночасно працює не більше config.connections "доріжок", що беруть шматки по черзі.
+    const int lanes = qMax(1, config.connections);
+    std::atomic<qint64> rowCount{0};
+    std::atomic<bool> failed{false};
+    std::atomic<bool> insertFallback{false};
+
+    for (const QList<Task> &phase : std::as_const(phases)) {
+        std::atomic<int> nextTask{0};
+        QList<QFuture<void>> futures;
+        for (int lane = 0; lane < qMin(lanes, phase.size()); ++lane) {
+            futures.append(dbManager->runAsync([&]() {
+                QSqlDatabase db = dbManager->workerConnection();
+                if (!db.isOpen()) {
+                    qCCritical(lcDbSeed) << "DataGenerator: немає з'єднання пулу для завантаження.";
+                    failed = true;
+                    return;
+                }
+
+                std::unique_ptr<RowSink> sink;
+#ifdef BOOKSTORE_HAVE_LIBPQ
+                const QVariant handle = db.driver()->handle();
+                if (qstrcmp(handle.typeName(), "PGconn*") == 0) {
+                    sink = std::make_unique<CopySink>(*static_cast<PGconn *const *>(handle.constData()));
+                }
+#endif
+                if (!sink) {
+                    sink = std::make_unique<InsertSink>(db);
+                    insertFallback = true;
+                }
+
+                for (int index = nextTask++; index < phase.size() && !failed.load(); index = nextTask++) {
+                    const Task &task = phase.at(index);
+                    if (!db.transaction()) {
+                        failed = true;
+                        return;
+                    }
+                    // LOCAL: діє до кінця транзакції шматка, тож з'єднання повертається в пул
+                    // із звичайним синхронним комітом
+                    QSqlQuery setup(db);
+                    if (!setup.exec("SET LOCAL synchronous_commit = off")) {
+                        qCCritical(lcDbSeed) << "DataGenerator: не вдалося вимкнути synchronous_commit:" << setup.lastError().text();
+                        db.rollback();
+                        failed = true;
+                        return;
+                    }
+                    const qint64 rowsBefore = sink->rows();
+                    std::mt19937_64 rng = context.chunkRng(task.tag, task.chunk);
+                    if (!task.fn(context, *sink, rng, task.from, task.to) || !db.commit()) {
+                        qCCritical(lcDbSeed) << "DataGenerator: шматок" << task.label << task.from << "-" << task.to << "не завантажено.";
+                        db.rollback();
+                        failed = true;
+                        return;
+                    }
+                    rowCount += sink->rows() - rowsBefore;
+                    qCDebug(lcDbSeed) << "DataGenerator:" << task.label << task.from << "-" << task.to << "завантажено.";
+                }
+            }));
+        }
+        for (QFuture<void> &future : futures) {
+            future.waitForFinished();
+        }
+        if (failed.load()) {
+            qCCritical(lcDbSeed) << "DataGenerator: завантаження перервано, дані неповні.";
+            return false;
+        }
+    }
+
+    // Явні ID не зсувають послідовності SERIAL - вирівнюємо, щоб нові рядки не конфліктували
+    QSqlQuery query(dbManager->database());
+    const QList<QPair<QString, int>> sequences = {
+        {"publisher", config.publishers}, {"author", config.authors}, {"customer", config.customers},
+        {"book", config.books}, {"\"order\"", config.orders}};
+    static const QStringList idColumns = {"publisher_id", "author_id", "customer_id", "book_id", "order_id"};
+    for (int i = 0; i < sequences.size(); ++i) {
+        if (sequences[i].second <= 0) continue;
+        const QString sql = QString("SELECT setval(pg_get_serial_sequence('%1', '%2'), %3)")
+                                .arg(sequences[i].first, idColumns.at(i)).arg(sequences[i].second);
+        if (!query.exec(sql)) {
+            qCWarning(lcDbSeed) << "DataGenerator: не вдалося оновити послідовність" << sequences[i].first << ":" << query.lastError().text();
+        }
+    }
+    if (config.recreateSchema) {
+        QElapsedTimer indexTimer;
+        indexTimer.start();
+        if (!dbManager->createSecondaryIndexes()) {
+            qCCritical(lcDbSeed) << "DataGenerator: не вдалося побудувати вторинні індекси.";
+            return false;
+        }
+        qCInfo(lcDbSeed) << "DataGenerator: вторинні індекси побудовано за" << indexTimer.elapsed() << "мс";
+    }
+    if (!query.exec("ANALYZE")) {
+        qCWarning(lcDbSeed) << "DataGenerator: ANALYZE не виконано:" << query.lastError().text();
+    }
+    dbManager->queryResultCache().clear();
+
+    const bool usedCopy = !insertFallback.load();
+    if (report) {
+        report->rows = rowCount.load();
+        report->elapsedMs = total.elapsed();
+        report->usedCopy = usedCopy;
+    }
+    qCInfo(lcDbSeed) << "DataGenerator: завантажено" << rowCount.load() << "рядків за" << total.elapsed() << "мс"
+                     << (usedCopy ? "(COPY)" : "(INSERT)") << ", з'єднань:" << config.connections;
+    return true;
+}
@@ -0,0 +1,52 @@
+#ifndef DATAGENERATOR_H
+#define DATAGENERATOR_H
+
+#include <QString>
+#include <QStringList>
+
+class DatabaseManager;
+
+// Параметри синтетичного набору даних. Однакові параметри (разом із seed) дають однакові дані
+// незалежно від кількості з'єднань: кожен шматок таблиці має власний генератор випадкових чисел.
+struct DataGeneratorConfig {
+    quint64 seed = 42;
+
+    int publishers = 100;
+    int authors = 5000;
+    int books = 100000;
+    int customers = 10000;
+    int orders = 50000;
+    int comments = 100000;
+    double cartCustomerShare = 0.1;   // Частка клієнтів із непорожнім кошиком
+
+    double popularitySkew = 1.1;      // Показник Zipf: популярність книг, авторів, активність клієнтів
+    double orderSizeSkew = 1.6;       // Показник Zipf для кількості позицій у замовленні
+    int maxItemsPerOrder = 10;
+
+    int connections = 4;              // Паралельних завантажень (з'єднань пулу)
+    int chunkRows = 20000;            // Рядків основної таблиці в одному завданні
+    bool recreateSchema = true;       // Викликати createSchemaTables() перед завантаженням
+    QString customerPassword = "password";
+
+    // Пропорції таблиць відносно кількості книг (як у bench: 1k, 100k, 1m)
+    static DataGeneratorConfig forBooks(int books);
+};
+
+struct DataGeneratorReport {
+    qint64 rows = 0;
+    qint64 elapsedMs = 0;
+    bool usedCopy = false;            // false - libpq недоступна, дані йшли пакетами INSERT
+};
+
+// Генерує і завантажує дані в усі таблиці схеми через COPY ... FROM STDIN (libpq), паралельно
+// на кількох з'єднаннях пулу DatabaseManager. Без libpq (BOOKSTORE_HAVE_LIBPQ) - багаторядковими INSERT.
+// Після завантаження вирівнює послідовності SERIAL і виконує ANALYZE.
+bool generateSyntheticData(DatabaseManager *dbManager, const DataGeneratorConfig &config,
+                           DataGeneratorReport *report = nullptr);
+
+// Значення, за якими можна звертатися до згенерованих даних
+QString syntheticCustomerEmail(int customerId);
+QStringList syntheticGenres();
+QStringList syntheticLanguages();
+
+#endif // DATAGENERATOR_H
@@ -0,0 +1,188 @@
+#include "imageservice.h"
+#include "thumbnaildiskcache.h"
+#include <QDateTime>
+#include <QFileInfo>
+#include <QGuiApplication>
+#include <QImageReader>
+#include <QPainter>
+#include <QPromise>
+#include <QStandardPaths>
+#include <QThread>
+#include <QtConcurrent/QtConcurrent>
+#include <QDebug>
+
+namespace {
+
+QFuture<QPixmap> readyFuture(const QPixmap &pixmap)
+{
+    QPromise<QPixmap> promise;
+    promise.start();
+    promise.addResult(pixmap);
+    promise.finish();
+    return promise.future();
+}
+
+} // namespace
+
+ImageService::ImageService(QObject *parent)
+    : QObject(parent)
+{
+    // Декодування впирається в диск і CPU; половини ядер досить, щоб не заважати запитам до БД
+    m_pool.setMaxThreadCount(qMax(2, QThread::idealThreadCount() / 2));
+    m_cache.setMaxCost(64 * 1024);  // 64 МіБ
+
+    const QString cacheDir = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+    if (!cacheDir.isEmpty()) {
+        auto diskCache = std::make_unique<ThumbnailDiskCache>(cacheDir + "/thumbnails.bin");
+        if (diskCache->isOpen()) {
+            m_diskCache = std::move(diskCache);
+        }
+    }
+}
+
+ImageService::~ImageService()
+{
+    // Потоки пулу користуються m_diskCache - спершу дочекатися їх
+    m_pool.clear();
+    m_pool.waitForDone();
+}
+
+void ImageService::setCacheLimit(qsizetype kilobytes)
+{
+    m_cache.setMaxCost(kilobytes);
+}
+
+void ImageService::clearCache()
+{
+    m_cache.clear();
+}
+
+QString ImageService::cacheKey(const QString &path, const ThumbnailSpec &spec, qreal devicePixelRatio) const
+{
+    return QString("%1|%2x%3|%4|%5|%6")
+        .arg(path)
+        .arg(spec.size.width()).arg(spec.size.height())
+        .arg(int(spec.aspectMode)).arg(int(spec.shape))
+        .arg(devicePixelRatio);
+}
+
+bool ImageService::cachedThumbnail(const QString &path, const ThumbnailSpec &spec, QPixmap *pixmap) const
+{
+    if (path.isEmpty()) {
+        *pixmap = QPixmap();
+        return true;
+    }
+    const QPixmap *cached = m_cache.object(cacheKey(path, spec, qApp->devicePixelRatio()));
+    if (!cached) {
+        return false;
+    }
+    *pixmap = *cached;
+    return true;
+}
+
+QFuture<QPixmap> ImageService::thumbnail(const QString &path, const ThumbnailSpec &spec)
+{
+    QPixmap cached;
+    if (cachedThumbnail(path, spec, &cached)) {
+        return readyFuture(cached);
+    }
+
+    const qreal devicePixelRatio = qApp->devicePixelRatio();
+    const QString key = cacheKey(path, spec, devicePixelRatio);
+    const auto pending = m_pending.constFind(key);
+    if (pending != m_pending.constEnd()) {
+        return pending.value();
+    }
+
+    ThumbnailDiskCache *diskCache = m_diskCache.get();
+    QFuture<QPixmap> future = QtConcurrent::run(&m_pool, [diskCache, key, path, spec, devicePixelRatio]() {
+        return loadThumbnail(diskCache, key, path, spec, devicePixelRatio);
+    }).then(this, [this, key, devicePixelRatio](const QImage &image) {
+        // QPixmap можна створювати лише в потоці GUI; це лише копіювання, без масштабування
+        QPixmap pixmap = QPixmap::fromImage(image);
+        pixmap.setDevicePixelRatio(devicePixelRatio);
+        const qsizetype kilobytes = qMax<qsizetype>(1, qsizetype(image.sizeInBytes() / 1024));
+        m_cache.insert(key, new QPixmap(pixmap), kilobytes);
+        m_pending.remove(key);
+        return pixmap;
+    });
+    m_pending.insert(key, future);
+    return future;
+}
+
+// Виконується на m_pool: спершу дисковий кеш, інакше декодування і запис у нього.
+// mtime у ключі робить застарілі записи недосяжними - їх згодом витисне LRU.
+QImage ImageService::loadThumbnail(ThumbnailDiskCache *diskCache, const QString &key,
+                                   const QString &path, const ThumbnailSpec &spec, qreal devicePixelRatio)
+{
+    QString diskKey;
+    // Ресурси (":/...") вбудовані в програму і декодуються швидко - на диск їх не пишемо
+    if (diskCache && !path.startsWith(':')) {
+        const QDateTime modified = QFileInfo(path).lastModified();
+        if (modified.isValid()) {
+            diskKey = key + '|' + QString::number(modified.toMSecsSinceEpoch());
+            QImage cached = diskCache->find(diskKey);
+            if (!cached.isNull()) {
+                return cached;
+            }
+        }
+    }
+
+    QImage image = decode(path, spec, devicePixelRatio);
+    if (!diskKey.isEmpty() && !image.isNull()) {
+        diskCache->insert(diskKey, image);
+    }
+    return image;
+}
+
+// Виконується на m_pool: читання, масштабування під час декодування та обрізання за формою
+QImage ImageService::decode(const QString &path, const ThumbnailSpec &spec, qreal devicePixelRatio)
+{
+    QImageReader reader(path);
+    reader.setAutoTransform(true);
+
+    const QSize target = spec.size.isValid() ? spec.size * devicePixelRatio : QSize();
+    QSize sourceSize = reader.size();
+    if (reader.transformation() & QImageIOHandler::TransformationRotate90) {
+        sourceSize.transpose();
+    }
+    if (target.isValid() && sourceSize.isValid()) {
+        reader.setScaledSize(sourceSize.scaled(target, spec.aspectMode));
+    }
+
+    QImage image = reader.read();
+    if (image.isNull()) {
+        qWarning() << "ImageService: не вдалося прочитати" << path << "-" << reader.errorString();
+        return QImage();
+    }
+
+    if (target.isValid()) {
+        // Формати без підтримки setScaledSize (або невідомий розмір джерела) масштабуємо тут, у фоні
+        const QSize fitted = image.size().scaled(target, spec.aspectMode);
+        if (fitted != image.size()) {
+            image = image.scaled(fitted, Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+        }
+        if (spec.aspectMode == Qt::KeepAspectRatioByExpanding && image.size() != target) {
+            image = image.copy(QRect(QPoint((image.width() - target.width()) / 2, (image.height() - target.height()) / 2),
+                                     target));
+        }
+    }
+
+    if (spec.shape != ImageShape::Plain) {
+        QImage shaped(image.size(), QImage::Format_ARGB32_Premultiplied);
+        shaped.fill(Qt::transparent);
+        QPainter painter(&shaped);
+        painter.setRenderHint(QPainter::Antialiasing);
+        painter.setPen(Qt::NoPen);
+        painter.setBrush(QBrush(image));
+        if (spec.shape == ImageShape::Circle) {
+            painter.drawEllipse(shaped.rect());
+        } else {
+            const qreal radius = RoundedCornerRadius * devicePixelRatio;
+            painter.drawRoundedRect(shaped.rect(), radius, radius);
+        }
+        painter.end();
+        image = shaped;
+    }
+    return image;
+}
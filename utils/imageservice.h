@@ -0,0 +1,84 @@
+#ifndef IMAGESERVICE_H
+#define IMAGESERVICE_H
+
+#include <QObject>
+#include <QFuture>
+#include <QCache>
+#include <QHash>
+#include <QImage>
+#include <QPixmap>
+#include <QSize>
+#include <QString>
+#include <QThreadPool>
+#include <memory>
+
+class ThumbnailDiskCache;
+
+// Форма мініатюри: обрізання виконується разом із декодуванням, а не на кожне відображення
+enum class ImageShape {
+    Plain,
+    Circle,         // Фото авторів
+    RoundedRect     // Банери (радіус ImageService::RoundedCornerRadius)
+};
+
+// Що саме потрібно від зображення: розмір (у логічних пікселях), масштабування і форма.
+// Недійсний size - зображення без масштабування.
+struct ThumbnailSpec {
+    QSize size;
+    Qt::AspectRatioMode aspectMode = Qt::KeepAspectRatio;
+    ImageShape shape = ImageShape::Plain;
+};
+
+// Спільне асинхронне декодування зображень (обкладинки, фото, банери, пропозиції пошуку).
+// Файл читається на власному пулі потоків через QImageReader::setScaledSize - великі обкладинки
+// не декодуються в повному розмірі - і готова мініатюра лягає в кеш за (шлях, розмір, форма).
+// Повторний запит того самого ключа, поки він декодується, отримує той самий QFuture.
+// Відсутні й пошкоджені файли теж кешуються (як null), щоб не читати диск знову.
+// Між запусками мініатюри зберігаються в ThumbnailDiskCache (ключ включає mtime джерела),
+// тож повторне відкриття каталогу не декодує обкладинки знову.
+// Використовувати лише в потоці GUI.
+class ImageService : public QObject
+{
+    Q_OBJECT
+
+public:
+    static constexpr int RoundedCornerRadius = 18;
+
+    explicit ImageService(QObject *parent = nullptr);
+    ~ImageService();
+
+    // Null QPixmap, якщо файлу немає або його не вдалося прочитати
+    QFuture<QPixmap> thumbnail(const QString &path, const ThumbnailSpec &spec);
+
+    // true, якщо результат для ключа вже відомий (pixmap може бути null - файлу немає)
+    bool cachedThumbnail(const QString &path, const ThumbnailSpec &spec, QPixmap *pixmap) const;
+
+    // Викликає onReady одразу, якщо мініатюра в кеші, інакше - після декодування,
+    // якщо context ще існує
+    template <typename Fn>
+    void requestThumbnail(QObject *context, const QString &path, const ThumbnailSpec &spec, Fn onReady)
+    {
+        QPixmap pixmap;
+        if (cachedThumbnail(path, spec, &pixmap)) {
+            onReady(pixmap);
+            return;
+        }
+        thumbnail(path, spec).then(context, std::move(onReady));
+    }
+
+    void setCacheLimit(qsizetype kilobytes);
+    void clearCache();
+
+private:
+    QString cacheKey(const QString &path, const ThumbnailSpec &spec, qreal devicePixelRatio) const;
+    static QImage decode(const QString &path, const ThumbnailSpec &spec, qreal devicePixelRatio);
+    static QImage loadThumbnail(ThumbnailDiskCache *diskCache, const QString &key,
+                                const QString &path, const ThumbnailSpec &spec, qreal devicePixelRatio);
+
+    std::unique_ptr<ThumbnailDiskCache> m_diskCache;  // Null, якщо файл кешу недоступний
+    QThreadPool m_pool;
+    QCache<QString, QPixmap> m_cache;               // Вартість - кілобайти
+    QHash<QString, QFuture<QPixmap>> m_pending;
+};
+
+#endif // IMAGESERVICE_H
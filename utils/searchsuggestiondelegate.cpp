@@ -1,10 +1,18 @@
 #include "searchsuggestiondelegate.h"
+#include "imageservice.h"
+#include <QAbstractItemView>
+#include <QPointer>
 
 SearchSuggestionDelegate::SearchSuggestionDelegate(QObject *parent)
     : QStyledItemDelegate(parent)
 {
 }
 
+void SearchSuggestionDelegate::setImageService(ImageService *imageService)
+{
+    m_imageService = imageService;
+}
+
 void SearchSuggestionDelegate::paint(QPainter *painter, const QStyleOptionViewItem &option, const QModelIndex &index) const
 {
     painter->save();
@@ -19,13 +27,26 @@ void SearchSuggestionDelegate::paint(QPainter *painter, const QStyleOptionViewIt
                     m_imageSize,
                     m_imageSize);
 
-    QPixmap pixmap(imagePath);
+    // paint() не читає диск і не масштабує: лише готова мініатюра з кешу
+    QPixmap pixmap;
+    const ThumbnailSpec spec{imageRect.size()};
+    if (m_imageService && !m_imageService->cachedThumbnail(imagePath, spec, &pixmap)) {
+        QPointer<QWidget> view = const_cast<QWidget *>(option.widget);
+        auto *context = const_cast<SearchSuggestionDelegate *>(this);
+        m_imageService->thumbnail(imagePath, spec).then(context, [view](const QPixmap &) {
+            if (auto *itemView = qobject_cast<QAbstractItemView *>(view.data())) {
+                itemView->viewport()->update();
+            } else if (view) {
+                view->update();
+            }
+        });
+    }
     if (pixmap.isNull()) {
         painter->fillRect(imageRect, Qt::lightGray);
     } else {
-        pixmap = pixmap.scaled(imageRect.size(), Qt::KeepAspectRatio, Qt::SmoothTransformation);
-        painter->drawPixmap(imageRect.left() + (m_imageSize - pixmap.width()) / 2,
-                           imageRect.top() + (m_imageSize - pixmap.height()) / 2,
+        const QSize logicalSize = pixmap.deviceIndependentSize().toSize();
+        painter->drawPixmap(imageRect.left() + (m_imageSize - logicalSize.width()) / 2,
+                           imageRect.top() + (m_imageSize - logicalSize.height()) / 2,
                            pixmap);
     }
 
@@ -49,7 +70,14 @@ void SearchSuggestionDelegate::paint(QPainter *painter, const QStyleOptionViewIt
         painter->setPen(Qt::black);
     }
 
-    QFontMetrics fm(option.font);
+    // Нечіткі кандидати - курсивом, щоб було видно, що це не точний збіг
+    QFont textFont = option.font;
+    if (index.data(SearchSuggestionRoles::FuzzyMatchRole).toBool()) {
+        textFont.setItalic(true);
+        painter->setFont(textFont);
+    }
+
+    QFontMetrics fm(textFont);
     QString elidedText = fm.elidedText(displayText, Qt::ElideRight, textRect.width());
 
     painter->drawText(textRect, Qt::AlignVCenter | Qt::AlignLeft, elidedText);
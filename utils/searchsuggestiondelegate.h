@@ -11,11 +11,14 @@
 #include <QDebug>
 #include "datatypes.h"
 
+class ImageService;
+
 namespace SearchSuggestionRoles {
     const int TypeRole = Qt::UserRole + 1;
     const int IdRole = Qt::UserRole + 2;
     const int ImagePathRole = Qt::UserRole + 3;
     const int PriceRole = Qt::UserRole + 4;
+    const int FuzzyMatchRole = Qt::UserRole + 5;   // bool: кандидат нечіткого пошуку
     const int DisplayTextRole = Qt::DisplayRole;
 }
 
@@ -26,10 +29,15 @@ class SearchSuggestionDelegate : public QStyledItemDelegate
 public:
     explicit SearchSuggestionDelegate(QObject *parent = nullptr);
 
+    // Мініатюри беруться з кешу ImageService; поки їх немає - сірий placeholder, а view
+    // перемальовується, коли декодування завершиться
+    void setImageService(ImageService *imageService);
+
     void paint(QPainter *painter, const QStyleOptionViewItem &option, const QModelIndex &index) const override;
     QSize sizeHint(const QStyleOptionViewItem &option, const QModelIndex &index) const override;
 
 private:
+    ImageService *m_imageService = nullptr;
     int m_imageSize = 40;
     int m_padding = 5;
 };
@@ -0,0 +1,127 @@
+#include "searchsuggestionlistmodel.h"
+#include "searchsuggestiondelegate.h"
+
+SearchSuggestionListModel::SearchSuggestionListModel(QObject *parent)
+    : QAbstractListModel(parent)
+{
+}
+
+int SearchSuggestionListModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : m_suggestions.size();
+}
+
+QVariant SearchSuggestionListModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() < 0 || index.row() >= m_suggestions.size()) {
+        return QVariant();
+    }
+    const SearchSuggestionInfo &suggestion = m_suggestions.at(index.row());
+    switch (role) {
+    case SearchSuggestionRoles::DisplayTextRole:
+    case Qt::EditRole:  // QCompleter підставляє в поле текст completionRole (типово EditRole)
+        return suggestion.displayText;
+    case SearchSuggestionRoles::TypeRole:
+        return QVariant::fromValue(suggestion.type);
+    case SearchSuggestionRoles::IdRole:
+        return suggestion.id;
+    case SearchSuggestionRoles::ImagePathRole:
+        return suggestion.imagePath;
+    case SearchSuggestionRoles::PriceRole:
+        return suggestion.price;
+    case SearchSuggestionRoles::FuzzyMatchRole:
+        return suggestion.fuzzyMatch;
+    case Qt::ToolTipRole:
+        return toolTip(suggestion);
+    default:
+        return QVariant();
+    }
+}
+
+QString SearchSuggestionListModel::toolTip(const SearchSuggestionInfo &suggestion) const
+{
+    QString text = QString("Тип: %1\nID: %2%3")
+                       .arg(suggestion.type == SearchSuggestionInfo::Book ? tr("Книга") : tr("Автор"))
+                       .arg(suggestion.id)
+                       .arg(suggestion.type == SearchSuggestionInfo::Book ? QString("\nЦіна: %1 грн").arg(suggestion.price, 0, 'f', 2) : QString());
+    if (suggestion.fuzzyMatch) {
+        text = tr("Можливо, ви мали на увазі: %1").arg(suggestion.displayText) + "\n" + text;
+    }
+    return text;
+}
+
+bool SearchSuggestionListModel::sameItem(const SearchSuggestionInfo &a, const SearchSuggestionInfo &b)
+{
+    return a.type == b.type && a.id == b.id;
+}
+
+bool SearchSuggestionListModel::sameData(const SearchSuggestionInfo &a, const SearchSuggestionInfo &b)
+{
+    return a.displayText == b.displayText && a.imagePath == b.imagePath
+           && a.price == b.price && a.fuzzyMatch == b.fuzzyMatch;
+}
+
+int SearchSuggestionListModel::indexOf(const QList<SearchSuggestionInfo> &list, const SearchSuggestionInfo &item, int from)
+{
+    for (int i = from; i < list.size(); ++i) {
+        if (sameItem(list.at(i), item)) return i;
+    }
+    return -1;
+}
+
+void SearchSuggestionListModel::setSuggestions(const QList<SearchSuggestionInfo> &suggestions)
+{
+    // 1. Видаляємо рядки, яких немає в новому списку (суцільними діапазонами, знизу вгору)
+    for (int row = m_suggestions.size() - 1; row >= 0; --row) {
+        if (indexOf(suggestions, m_suggestions.at(row)) >= 0) continue;
+        const int last = row;
+        while (row > 0 && indexOf(suggestions, m_suggestions.at(row - 1)) < 0) {
+            --row;
+        }
+        beginRemoveRows(QModelIndex(), row, last);
+        m_suggestions.remove(row, last - row + 1);
+        endRemoveRows();
+    }
+
+    // 2. Проходимо новий список: наявні рядки переміщуємо на місце, нові вставляємо
+    for (int i = 0; i < suggestions.size(); ++i) {
+        const SearchSuggestionInfo &suggestion = suggestions.at(i);
+        if (i < m_suggestions.size() && sameItem(m_suggestions.at(i), suggestion)) {
+            if (!sameData(m_suggestions.at(i), suggestion)) {
+                m_suggestions[i] = suggestion;
+                emit dataChanged(index(i), index(i));
+            }
+            continue;
+        }
+
+        const int from = indexOf(m_suggestions, suggestion, i + 1);
+        if (from >= 0) {
+            beginMoveRows(QModelIndex(), from, from, QModelIndex(), i);
+            m_suggestions.move(from, i);
+            endMoveRows();
+            if (!sameData(m_suggestions.at(i), suggestion)) {
+                m_suggestions[i] = suggestion;
+                emit dataChanged(index(i), index(i));
+            }
+        } else {
+            beginInsertRows(QModelIndex(), i, i);
+            m_suggestions.insert(i, suggestion);
+            endInsertRows();
+        }
+    }
+
+    // Повтори (тип, id) у новому списку лишають зайві рядки в кінці
+    if (m_suggestions.size() > suggestions.size()) {
+        beginRemoveRows(QModelIndex(), suggestions.size(), m_suggestions.size() - 1);
+        m_suggestions.remove(suggestions.size(), m_suggestions.size() - suggestions.size());
+        endRemoveRows();
+    }
+}
+
+void SearchSuggestionListModel::clear()
+{
+    if (m_suggestions.isEmpty()) return;
+    beginResetModel();
+    m_suggestions.clear();
+    endResetModel();
+}
@@ -0,0 +1,35 @@
+#ifndef SEARCHSUGGESTIONLISTMODEL_H
+#define SEARCHSUGGESTIONLISTMODEL_H
+
+#include <QAbstractListModel>
+#include <QList>
+#include "datatypes.h"
+
+// Модель пропозицій автодоповнення для QCompleter і SearchSuggestionDelegate (ролі SearchSuggestionRoles).
+// setSuggestions() застосовує новий список мінімальним набором змін - видалення, переміщення,
+// вставки та dataChanged за ідентичністю (тип, id) - тож popup не перебудовується повністю
+// на кожне натискання клавіші і зберігає виділений рядок, якщо той лишився в списку.
+class SearchSuggestionListModel : public QAbstractListModel
+{
+    Q_OBJECT
+
+public:
+    explicit SearchSuggestionListModel(QObject *parent = nullptr);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+
+    void setSuggestions(const QList<SearchSuggestionInfo> &suggestions);
+    void clear();
+    const QList<SearchSuggestionInfo> &suggestions() const { return m_suggestions; }
+
+private:
+    static bool sameItem(const SearchSuggestionInfo &a, const SearchSuggestionInfo &b);
+    static bool sameData(const SearchSuggestionInfo &a, const SearchSuggestionInfo &b);
+    static int indexOf(const QList<SearchSuggestionInfo> &list, const SearchSuggestionInfo &item, int from = 0);
+    QString toolTip(const SearchSuggestionInfo &suggestion) const;
+
+    QList<SearchSuggestionInfo> m_suggestions;
+};
+
+#endif // SEARCHSUGGESTIONLISTMODEL_H
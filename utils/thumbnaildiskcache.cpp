@@ -0,0 +1,324 @@
+#include "thumbnaildiskcache.h"
+#include <QDir>
+#include <QFileInfo>
+#include <QList>
+#include <QDebug>
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+constexpr char Magic[8] = {'B', 'K', 'T', 'H', 'U', 'M', 'B', '1'};
+constexpr quint32 FormatVersion = 1;
+constexpr quint32 SlotCount = 16384;     // Степінь двійки
+constexpr quint8 SlotEmpty = 0;
+constexpr quint8 SlotUsed = 1;
+constexpr quint8 SlotDeleted = 2;
+constexpr qint64 Alignment = 16;
+constexpr qint64 BlobHeaderSize = 8;     // quint32 довжина ключа, quint32 bytesPerLine
+
+qint64 aligned(qint64 value)
+{
+    return (value + Alignment - 1) & ~(Alignment - 1);
+}
+
+// FNV-1a: стабільний між запусками і версіями Qt (на відміну від qHash із сідом)
+quint64 hashKey(const QByteArray &key)
+{
+    quint64 hash = 0xcbf29ce484222325ULL;
+    for (char c : key) {
+        hash ^= static_cast<uchar>(c);
+        hash *= 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+} // namespace
+
+struct ThumbnailDiskCache::Header {
+    char magic[8];
+    quint32 version;
+    quint32 slotCount;
+    quint64 capacity;        // Розмір файлу
+    quint64 dataOffset;      // Початок області даних
+    quint64 dataEnd;         // Перший вільний байт області даних
+    quint64 liveBytes;       // Байтів у живих записах
+    quint32 clock;           // Лічильник звернень для LRU
+    quint32 dirty;           // 1, поки файл відкрито
+    quint32 occupiedSlots;   // Зайняті та видалені слоти (для коефіцієнта заповнення)
+    quint32 usedSlots;
+};
+
+struct ThumbnailDiskCache::Slot {
+    quint64 hash;
+    quint64 offset;
+    quint32 size;
+    quint32 lastUsed;
+    quint16 width;
+    quint16 height;
+    quint8 format;           // QImage::Format
+    quint8 state;
+    quint16 reserved;
+};
+
+ThumbnailDiskCache::ThumbnailDiskCache(const QString &filePath, qint64 capacity)
+    : m_filePath(filePath)
+{
+    if (!open(capacity)) {
+        m_data = nullptr;
+        m_file.close();
+        qWarning() << "ThumbnailDiskCache: кеш мініатюр на диску вимкнено:" << m_filePath;
+    }
+}
+
+ThumbnailDiskCache::~ThumbnailDiskCache()
+{
+    QMutexLocker locker(&m_mutex);
+    if (m_data) {
+        header()->dirty = 0;
+        m_file.unmap(m_data);
+        m_data = nullptr;
+    }
+    m_file.close();
+}
+
+bool ThumbnailDiskCache::open(qint64 capacity)
+{
+    static_assert(sizeof(Slot) == 32, "Slot layout is part of the file format");
+    const qint64 dataOffset = aligned(sizeof(Header)) + qint64(SlotCount) * qint64(sizeof(Slot));
+    capacity = qMax(capacity, dataOffset + 4 * 1024 * 1024);
+
+    QDir().mkpath(QFileInfo(m_filePath).absolutePath());
+    m_lock = std::make_unique<QLockFile>(m_filePath + ".lock");
+    if (!m_lock->tryLock(0)) {
+        qWarning() << "ThumbnailDiskCache: файл використовує інший екземпляр програми";
+        return false;
+    }
+
+    m_file.setFileName(m_filePath);
+    if (!m_file.open(QIODevice::ReadWrite)) {
+        qWarning() << "ThumbnailDiskCache: не вдалося відкрити" << m_filePath << m_file.errorString();
+        return false;
+    }
+    const bool sizeMatches = m_file.size() == capacity;
+    if (!sizeMatches && !m_file.resize(capacity)) {
+        qWarning() << "ThumbnailDiskCache: не вдалося змінити розмір файлу" << m_file.errorString();
+        return false;
+    }
+    m_data = m_file.map(0, capacity);
+    if (!m_data) {
+        qWarning() << "ThumbnailDiskCache: не вдалося відобразити файл у пам'ять" << m_file.errorString();
+        return false;
+    }
+
+    const Header *h = header();
+    const bool valid = sizeMatches
+                       && std::memcmp(h->magic, Magic, sizeof(Magic)) == 0
+                       && h->version == FormatVersion
+                       && h->slotCount == SlotCount
+                       && h->capacity == quint64(capacity)
+                       && h->dataOffset == quint64(dataOffset)
+                       && h->dataEnd >= h->dataOffset && h->dataEnd <= h->capacity
+                       && h->dirty == 0;
+    if (!valid) {
+        initialize(capacity);
+    }
+    header()->dirty = 1;
+    return true;
+}
+
+// Порожній кеш: заголовок і таблиця слотів з нуля (область даних не чіпаємо)
+void ThumbnailDiskCache::initialize(qint64 capacity)
+{
+    const qint64 dataOffset = aligned(sizeof(Header)) + qint64(SlotCount) * qint64(sizeof(Slot));
+    std::memset(m_data, 0, size_t(dataOffset));
+    Header *h = header();
+    std::memcpy(h->magic, Magic, sizeof(Magic));
+    h->version = FormatVersion;
+    h->slotCount = SlotCount;
+    h->capacity = quint64(capacity);
+    h->dataOffset = quint64(dataOffset);
+    h->dataEnd = quint64(dataOffset);
+}
+
+ThumbnailDiskCache::Header *ThumbnailDiskCache::header() const
+{
+    return reinterpret_cast<Header *>(m_data);
+}
+
+ThumbnailDiskCache::Slot *ThumbnailDiskCache::slots() const
+{
+    return reinterpret_cast<Slot *>(m_data + aligned(sizeof(Header)));
+}
+
+bool ThumbnailDiskCache::keyMatches(const Slot &slot, const QByteArray &key) const
+{
+    quint32 keyLength = 0;
+    std::memcpy(&keyLength, m_data + slot.offset, sizeof(keyLength));
+    return keyLength == quint32(key.size())
+           && std::memcmp(m_data + slot.offset + BlobHeaderSize, key.constData(), size_t(key.size())) == 0;
+}
+
+int ThumbnailDiskCache::findSlot(quint64 hash, const QByteArray &key) const
+{
+    const Slot *table = slots();
+    quint32 index = quint32(hash) & (SlotCount - 1);
+    for (quint32 probe = 0; probe < SlotCount; ++probe, index = (index + 1) & (SlotCount - 1)) {
+        const Slot &slot = table[index];
+        if (slot.state == SlotEmpty) {
+            return -1;
+        }
+        if (slot.state == SlotUsed && slot.hash == hash && keyMatches(slot, key)) {
+            return int(index);
+        }
+    }
+    return -1;
+}
+
+void ThumbnailDiskCache::placeSlot(const Slot &slot)
+{
+    Slot *table = slots();
+    quint32 index = quint32(slot.hash) & (SlotCount - 1);
+    while (table[index].state == SlotUsed) {
+        index = (index + 1) & (SlotCount - 1);
+    }
+    if (table[index].state == SlotEmpty) {
+        ++header()->occupiedSlots;
+    }
+    table[index] = slot;
+    ++header()->usedSlots;
+}
+
+QImage ThumbnailDiskCache::find(const QString &key)
+{
+    if (!m_data) {
+        return QImage();
+    }
+    const QByteArray keyBytes = key.toUtf8();
+    const quint64 hash = hashKey(keyBytes);
+
+    QMutexLocker locker(&m_mutex);
+    const int index = findSlot(hash, keyBytes);
+    if (index < 0) {
+        return QImage();
+    }
+    Slot &slot = slots()[index];
+    slot.lastUsed = ++header()->clock;
+
+    quint32 bytesPerLine = 0;
+    std::memcpy(&bytesPerLine, m_data + slot.offset + 4, sizeof(bytesPerLine));
+    const uchar *pixels = m_data + slot.offset + aligned(BlobHeaderSize + keyBytes.size());
+    // Копія: відображення може зсунутися при ущільненні
+    return QImage(pixels, slot.width, slot.height, int(bytesPerLine), QImage::Format(slot.format)).copy();
+}
+
+void ThumbnailDiskCache::insert(const QString &key, const QImage &image)
+{
+    if (!m_data || image.isNull() || image.width() > 0xFFFF || image.height() > 0xFFFF) {
+        return;
+    }
+    QImage pixels = image;
+    if (pixels.format() != QImage::Format_RGB32 && pixels.format() != QImage::Format_ARGB32
+        && pixels.format() != QImage::Format_ARGB32_Premultiplied) {
+        pixels = pixels.convertToFormat(QImage::Format_ARGB32_Premultiplied);
+    }
+    const QByteArray keyBytes = key.toUtf8();
+    const quint64 hash = hashKey(keyBytes);
+    const qint64 pixelStart = aligned(BlobHeaderSize + keyBytes.size());
+    const qint64 needed = aligned(pixelStart + pixels.sizeInBytes());
+
+    QMutexLocker locker(&m_mutex);
+    Header *h = header();
+    if (needed > qint64(h->capacity - h->dataOffset) / 4) {
+        return;
+    }
+
+    const int existing = findSlot(hash, keyBytes);
+    if (existing >= 0) {
+        Slot &slot = slots()[existing];
+        slot.state = SlotDeleted;
+        h->liveBytes -= slot.size;
+        --h->usedSlots;
+    }
+
+    if (h->dataEnd + quint64(needed) > h->capacity || h->occupiedSlots + 1 > SlotCount * 3 / 4) {
+        evict(needed);
+    }
+
+    const quint64 offset = h->dataEnd;
+    const quint32 keyLength = quint32(keyBytes.size());
+    const quint32 bytesPerLine = quint32(pixels.bytesPerLine());
+    std::memcpy(m_data + offset, &keyLength, sizeof(keyLength));
+    std::memcpy(m_data + offset + 4, &bytesPerLine, sizeof(bytesPerLine));
+    std::memcpy(m_data + offset + BlobHeaderSize, keyBytes.constData(), size_t(keyBytes.size()));
+    std::memcpy(m_data + offset + pixelStart, pixels.constBits(), size_t(pixels.sizeInBytes()));
+
+    Slot slot = {};
+    slot.hash = hash;
+    slot.offset = offset;
+    slot.size = quint32(needed);
+    slot.lastUsed = ++h->clock;
+    slot.width = quint16(pixels.width());
+    slot.height = quint16(pixels.height());
+    slot.format = quint8(pixels.format());
+    slot.state = SlotUsed;
+    placeSlot(slot);
+    h->dataEnd += quint64(needed);
+    h->liveBytes += quint64(needed);
+}
+
+// Вилучає найдавніше використані записи, доки не звільниться половина місця і слотів,
+// потім зсуває живі записи до початку області даних і перебудовує таблицю (без видалених слотів)
+void ThumbnailDiskCache::evict(qint64 neededBytes)
+{
+    Header *h = header();
+    Slot *table = slots();
+    const quint64 dataCapacity = h->capacity - h->dataOffset;
+
+    QList<Slot> survivors;
+    survivors.reserve(int(h->usedSlots));
+    for (quint32 i = 0; i < SlotCount; ++i) {
+        if (table[i].state == SlotUsed) {
+            survivors.append(table[i]);
+        }
+    }
+    std::sort(survivors.begin(), survivors.end(), [](const Slot &a, const Slot &b) { return a.lastUsed < b.lastUsed; });
+
+    quint64 live = h->liveBytes;
+    int evicted = 0;
+    while (evicted < survivors.size()
+           && (live + quint64(neededBytes) > dataCapacity / 2 || quint32(survivors.size() - evicted) + 1 > SlotCount / 2)) {
+        live -= survivors.at(evicted).size;
+        ++evicted;
+    }
+    survivors.erase(survivors.begin(), survivors.begin() + evicted);
+    std::sort(survivors.begin(), survivors.end(), [](const Slot &a, const Slot &b) { return a.offset < b.offset; });
+
+    std::memset(table, 0, size_t(SlotCount) * sizeof(Slot));
+    h->occupiedSlots = 0;
+    h->usedSlots = 0;
+    quint64 writeOffset = h->dataOffset;
+    for (Slot slot : survivors) {
+        if (slot.offset != writeOffset) {
+            std::memmove(m_data + writeOffset, m_data + slot.offset, slot.size);
+            slot.offset = writeOffset;
+        }
+        writeOffset += slot.size;
+        placeSlot(slot);
+    }
+    h->dataEnd = writeOffset;
+    h->liveBytes = live;
+    qInfo() << "ThumbnailDiskCache: вилучено" << evicted << "мініатюр, лишилося" << survivors.size();
+}
+
+int ThumbnailDiskCache::entryCount() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_data ? int(header()->usedSlots) : 0;
+}
+
+qint64 ThumbnailDiskCache::liveBytes() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_data ? qint64(header()->liveBytes) : 0;
+}
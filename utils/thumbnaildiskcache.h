@@ -0,0 +1,62 @@
+#ifndef THUMBNAILDISKCACHE_H
+#define THUMBNAILDISKCACHE_H
+
+#include <QFile>
+#include <QImage>
+#include <QLockFile>
+#include <QMutex>
+#include <QString>
+#include <memory>
+
+// Постійний кеш мініатюр між запусками: один файл, відображений у пам'ять (QFile::map).
+//
+// Файл: заголовок, хеш-таблиця слотів (відкрита адресація) і область даних. Запис - ключ
+// і пікселі мініатюри без стиснення (RGB32/ARGB32), тож читання - це копіювання з відображення
+// без декодування. Нові записи додаються в кінець області даних; коли місця чи слотів
+// бракує, найдавніше використані (LRU) вилучаються, а решта ущільнюється.
+//
+// Ключ будує виклик (ImageService): шлях до джерела, його mtime і параметри мініатюри.
+// Якщо програма завершилася, не закривши кеш (прапорець dirty), або формат не збігся,
+// файл перестворюється. Другий екземпляр програми кеш не відкриває (QLockFile).
+// Методи потокобезпечні: викликаються з потоків декодування ImageService.
+class ThumbnailDiskCache
+{
+public:
+    static constexpr qint64 DefaultCapacity = 256LL * 1024 * 1024;
+
+    explicit ThumbnailDiskCache(const QString &filePath, qint64 capacity = DefaultCapacity);
+    ~ThumbnailDiskCache();
+
+    ThumbnailDiskCache(const ThumbnailDiskCache &) = delete;
+    ThumbnailDiskCache &operator=(const ThumbnailDiskCache &) = delete;
+
+    bool isOpen() const { return m_data != nullptr; }
+
+    // Null QImage, якщо ключа немає
+    QImage find(const QString &key);
+    void insert(const QString &key, const QImage &image);
+
+    int entryCount() const;
+    qint64 liveBytes() const;
+
+private:
+    struct Header;
+    struct Slot;
+
+    bool open(qint64 capacity);
+    void initialize(qint64 capacity);
+    Header *header() const;
+    Slot *slots() const;
+    int findSlot(quint64 hash, const QByteArray &key) const;
+    bool keyMatches(const Slot &slot, const QByteArray &key) const;
+    void placeSlot(const Slot &slot);
+    void evict(qint64 neededBytes);
+
+    QString m_filePath;
+    QFile m_file;
+    std::unique_ptr<QLockFile> m_lock;
+    uchar *m_data = nullptr;
+    mutable QMutex m_mutex;
+};
+
+#endif // THUMBNAILDISKCACHE_H
@@ -41,12 +41,51 @@
 #include <QDoubleSpinBox>
 #include <QCheckBox>
 #include <QListWidgetItem>
+#include <QHash>
+#include <QSet>
+#include <QSignalBlocker>
 #include <QParallelAnimationGroup>
 #include "RangeSlider.h"
 #include <QFrame>
 #include <QVBoxLayout>
 #include <QGridLayout>
 
+namespace {
+// Пункти списку фільтра: значення в Qt::UserRole, у тексті - ще й кількість книг.
+// Порожній список заповнюється; нуль і не позначено - пункт вимкнено (вибір нічого не дасть).
+void applyListFacets(QListWidget *list, const QList<FacetValueCount> &counts)
+{
+    QHash<QString, int> countByValue;
+    for (const FacetValueCount &facet : counts) {
+        countByValue.insert(facet.value, facet.count);
+    }
+
+    const QSignalBlocker blocker(list);
+    QSet<QString> shown;
+    for (int i = 0; i < list->count(); ++i) {
+        QListWidgetItem *item = list->item(i);
+        const QString value = item->data(Qt::UserRole).toString();
+        const int count = countByValue.value(value, 0);
+        shown.insert(value);
+        item->setText(QString("%1 (%2)").arg(value).arg(count));
+        const bool enabled = count > 0 || item->checkState() == Qt::Checked;
+        item->setFlags(enabled ? item->flags() | Qt::ItemIsEnabled : item->flags() & ~Qt::ItemIsEnabled);
+    }
+    for (const FacetValueCount &facet : counts) {
+        if (shown.contains(facet.value)) {
+            continue;
+        }
+        QListWidgetItem *item = new QListWidgetItem(QString("%1 (%2)").arg(facet.value).arg(facet.count), list);
+        item->setData(Qt::UserRole, facet.value);
+        item->setFlags(item->flags() | Qt::ItemIsUserCheckable);
+        item->setCheckState(Qt::Unchecked);
+        if (facet.count == 0) {
+            item->setFlags(item->flags() & ~Qt::ItemIsEnabled);
+        }
+    }
+}
+}
+
 MainWindow::MainWindow(DatabaseManager *dbManager, int customerId, QWidget *parent)
     : QMainWindow(parent)
     , ui(new Ui::MainWindow)
@@ -54,6 +93,8 @@ MainWindow::MainWindow(DatabaseManager *dbManager, int customerId, QWidget *pare
     , m_currentCustomerId(customerId)
 {
     ui->setupUi(this);
+    m_imageService = new ImageService(this);
+    setupCatalogViews();
 
     if (ui->cartButton) {
         ui->cartButton->setIcon(QIcon("D:/projects/DB_Kurs/QtAPP/untitled/icons/cart.png"));
@@ -259,9 +300,7 @@ MainWindow::MainWindow(DatabaseManager *dbManager, int customerId, QWidget *pare
     }
 
 
-    if (!ui->authorsContainerLayout) {
-        qCritical() << "authorsContainerLayout is null!";
-    } else {
+    {
         QList<AuthorDisplayInfo> authors = m_dbManager->getAllAuthorsForDisplay();
         displayAuthors(authors);
         if (!authors.isEmpty()) {
@@ -274,6 +313,7 @@ MainWindow::MainWindow(DatabaseManager *dbManager, int customerId, QWidget *pare
     setProfileEditingEnabled(false);
 
     setupSearchCompleter();
+    setupSearchResultsPage();
 
     setupAutoBanner();
 
@@ -283,29 +323,21 @@ MainWindow::MainWindow(DatabaseManager *dbManager, int customerId, QWidget *pare
 
     m_filterApplyTimer = new QTimer(this);
     m_filterApplyTimer->setSingleShot(true);
-    m_filterApplyTimer->setInterval(750);
+    m_filterApplyTimer->setInterval(FilterApplyIntervalMs);
     connect(m_filterApplyTimer, &QTimer::timeout, this, &MainWindow::applyFiltersWithDelay);
 
-
-    loadCartFromDatabase();
-
-    QScrollArea* booksScrollArea = ui->booksPage->findChild<QScrollArea*>();
-    if (booksScrollArea) {
-        booksScrollArea->setHorizontalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
-        booksScrollArea->setWidgetResizable(true);
-        qInfo() << "Books page ScrollArea horizontal scrollbar disabled.";
-    } else {
-        qWarning() << "Could not find QScrollArea on the books page!";
+    // Поки знімок не готовий, фільтри йдуть у БД, і пауза у введенні довша
+    m_bookFilterManager = new BookFilterManager(m_dbManager, this);
+    connect(m_bookFilterManager, &BookFilterManager::snapshotReady, this, [this]() {
+        m_filterApplyTimer->setInterval(FilterApplyIntervalInMemoryMs);
+        refreshFilterFacets();
+    });
+    if (m_dbManager && m_dbManager->isConnected()) {
+        m_bookFilterManager->reload();
     }
 
-    QScrollArea* authorsScrollArea = ui->authorsPage->findChild<QScrollArea*>();
-    if (authorsScrollArea) {
-        authorsScrollArea->setHorizontalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
-        authorsScrollArea->setWidgetResizable(true);
-        qInfo() << "Authors page ScrollArea horizontal scrollbar disabled.";
-    } else {
-        qWarning() << "Could not find QScrollArea on the authors page!";
-    }
+
+    loadCartFromDatabase();
 
     m_orderDetailsPanel = ui->orderDetailsPanel;
     if (m_orderDetailsPanel) {
@@ -469,23 +501,42 @@ bool MainWindow::eventFilter(QObject *watched, QEvent *event)
             }
         }
     }
-    else if (qobject_cast<QFrame*>(watched) && watched->property("authorId").isValid()) {
-        if (event->type() == QEvent::MouseButtonPress) {
-            QMouseEvent *mouseEvent = static_cast<QMouseEvent*>(event);
-            if (mouseEvent->button() == Qt::LeftButton) {
-                int authorId = watched->property("authorId").toInt();
-                qInfo() << "Author card clicked, authorId:" << authorId;
-                showAuthorDetails(authorId);
-                return true;
-            }
-        }
-    }
 
 
     return QMainWindow::eventFilter(watched, event);
 }
 
 
+// Сторінки "Книги" та "Автори": моделі й делегат для віртуалізованих сіток.
+// Клік по картці - деталі, клік по намальованій кнопці - сигнал делегата.
+void MainWindow::setupCatalogViews()
+{
+    m_booksModel = new CatalogGridModel(CatalogGridModel::Books, this);
+    m_authorsModel = new CatalogGridModel(CatalogGridModel::Authors, this);
+    m_catalogCardDelegate = new CatalogCardDelegate(this);
+    m_catalogCardDelegate->setImageService(m_imageService);
+
+    ui->booksGridView->setModel(m_booksModel);
+    ui->booksGridView->setItemDelegate(m_catalogCardDelegate);
+    ui->authorsGridView->setModel(m_authorsModel);
+    ui->authorsGridView->setItemDelegate(m_catalogCardDelegate);
+
+    connect(ui->booksGridView, &QAbstractItemView::clicked, this, [this](const QModelIndex &index) {
+        const int bookId = index.data(CatalogRoles::IdRole).toInt();
+        qInfo() << "Book card clicked, bookId:" << bookId;
+        showBookDetails(bookId);
+    });
+    connect(ui->authorsGridView, &QAbstractItemView::clicked, this, [this](const QModelIndex &index) {
+        const int authorId = index.data(CatalogRoles::IdRole).toInt();
+        qInfo() << "Author card clicked, authorId:" << authorId;
+        showAuthorDetails(authorId);
+    });
+    connect(ui->booksGridView, &CatalogGridView::nearEndReached, this, &MainWindow::loadNextBooksPage);
+    connect(ui->booksGridView, &CatalogGridView::nearStartReached, this, &MainWindow::loadPreviousBooksPage);
+    connect(m_catalogCardDelegate, &CatalogCardDelegate::addToCartRequested, this, &MainWindow::on_addToCartButtonClicked);
+    connect(m_catalogCardDelegate, &CatalogCardDelegate::authorBooksRequested, this, &MainWindow::showAuthorDetails);
+}
+
 void MainWindow::setupFilterPanel()
 {
     if (!ui->filterPanel || !ui->filterButton) {
@@ -610,23 +661,13 @@ void MainWindow::setupFilterPanel()
 
 
     if (m_dbManager) {
-        QStringList genres = m_dbManager->getAllGenres();
+        // Списки жанрів і мов - з фасетів: один запит дає і значення, і кількість книг
+        m_inStockFilterText = m_inStockFilterCheckBox->text();
         m_genreFilterListWidget->clear();
-        for (const QString &genre : genres) {
-            QListWidgetItem *item = new QListWidgetItem(genre, m_genreFilterListWidget);
-            item->setFlags(item->flags() | Qt::ItemIsUserCheckable);
-            item->setCheckState(Qt::Unchecked);
-        }
-        m_genreFilterListWidget->setSelectionMode(QAbstractItemView::MultiSelection);
-
-        QStringList languages = m_dbManager->getAllLanguages();
         m_languageFilterListWidget->clear();
-        for (const QString &lang : languages) {
-             QListWidgetItem *item = new QListWidgetItem(lang, m_languageFilterListWidget);
-             item->setFlags(item->flags() | Qt::ItemIsUserCheckable);
-             item->setCheckState(Qt::Unchecked);
-        }
+        m_genreFilterListWidget->setSelectionMode(QAbstractItemView::MultiSelection);
         m_languageFilterListWidget->setSelectionMode(QAbstractItemView::MultiSelection);
+        applyFacetCounts(m_dbManager->getBookFacetCounts(BookFilterCriteria()));
 
         const int maxPriceValue = 1000;
         const int minPriceValue = 0;
@@ -673,6 +714,9 @@ void MainWindow::setupFilterPanel()
             background-color: #e9ecef;
             color: #000000;
         }
+        QListWidget::item:disabled {
+            color: #adb5bd;
+        }
         QListWidget::indicator:checked {
              image: url(D:/projects/DB_Kurs/QtAPP/untitled/icons//checkbox_checked.png);
         }
@@ -827,7 +871,7 @@ void MainWindow::applyFilters()
         for (int i = 0; i < m_genreFilterListWidget->count(); ++i) {
             QListWidgetItem *item = m_genreFilterListWidget->item(i);
             if (item && item->checkState() == Qt::Checked) {
-                m_currentFilterCriteria.genres << item->text();
+                m_currentFilterCriteria.genres << item->data(Qt::UserRole).toString();
             }
         }
     }
@@ -836,7 +880,7 @@ void MainWindow::applyFilters()
         for (int i = 0; i < m_languageFilterListWidget->count(); ++i) {
             QListWidgetItem *item = m_languageFilterListWidget->item(i);
             if (item && item->checkState() == Qt::Checked) {
-                m_currentFilterCriteria.languages << item->text();
+                m_currentFilterCriteria.languages << item->data(Qt::UserRole).toString();
             }
         }
     }
@@ -912,32 +956,190 @@ void MainWindow::resetFilters()
     }
 }
 
+// Каталог завантажується сторінками keyset (getFilteredBooksPageAsync): перша сторінка - одразу,
+// наступні - коли прокрутка наближається до кінця (CatalogGridView::nearEndReached).
+// Час до першого вмісту не залежить від кількості книг, що відповідають фільтрам.
+// Коли знімок BookFilterManager готовий, фільтри обчислюються в пам'яті, а сторінки -
+// зрізи результату (токен - зсув), тож прокрутка та вікно сторінок працюють так само.
 void MainWindow::loadAndDisplayFilteredBooks()
 {
+    ++m_booksRequestId;
+    m_booksPageLoading = false;
+    m_booksPageTokens = QStringList{QString()};
+    m_booksResidentPageSizes.clear();
+    m_booksFirstResidentPage = 0;
+    m_booksModel->clear();
+    m_booksFilterResult = BookFilterManager::Result();
+    refreshFilterFacets();
+
+    if (m_bookFilterManager && m_bookFilterManager->isReady()) {
+        m_booksFilterResult = m_bookFilterManager->filter(m_currentFilterCriteria);
+        qInfo() << "Filtered in memory:" << m_booksFilterResult.size() << "of" << m_bookFilterManager->bookCount() << "books.";
+        requestBooksPage(0);
+        return;
+    }
+
     if (!m_dbManager) {
         qWarning() << "Cannot load books: DatabaseManager is null.";
-        if (ui->booksContainerLayout) {
-            clearLayout(ui->booksContainerLayout);
-            QLabel *errorLabel = new QLabel(tr("Помилка: Немає доступу до бази даних."), ui->booksContainerWidget);
-            ui->booksContainerLayout->addWidget(errorLabel);
+        ui->booksGridView->setPlaceholderText(tr("Помилка: Немає доступу до бази даних."));
+        return;
+    }
+
+    qInfo() << "Loading books with current filters...";
+    ui->booksGridView->setPlaceholderText(tr("Завантаження книг..."));
+    requestBooksPage(0);
+}
+
+void MainWindow::requestBooksPage(int pageIndex)
+{
+    if (m_booksPageLoading || (!m_dbManager && !m_booksFilterResult.isValid()) || pageIndex < 0 || pageIndex >= m_booksPageTokens.size()) {
+        return;
+    }
+    m_booksPageLoading = true;
+    const int requestId = m_booksRequestId;
+    if (m_booksFilterResult.isValid()) {
+        const int offset = pageIndex * m_booksPageSize;
+        BookPage page;
+        page.books = m_booksFilterResult.books(offset, m_booksPageSize);
+        page.hasMore = offset + m_booksPageSize < m_booksFilterResult.size();
+        if (page.hasMore) {
+            page.nextPageToken = QString::number(offset + m_booksPageSize);
         }
+        // Через цикл подій, як і відповідь БД: onBooksPageLoaded не викликається з обробника прокрутки
+        QTimer::singleShot(0, this, [this, requestId, pageIndex, page]() {
+            if (requestId != m_booksRequestId) {
+                return;
+            }
+            m_booksPageLoading = false;
+            onBooksPageLoaded(pageIndex, page);
+        });
         return;
     }
-    if (!ui->booksContainerLayout || !ui->booksContainerWidget) {
-        qCritical() << "Cannot display books: booksContainerLayout or booksContainerWidget is null!";
+    m_dbManager->getFilteredBooksPageAsync(m_currentFilterCriteria, BookSortOrder::Title, m_booksPageSize,
+                                           m_booksPageTokens.at(pageIndex))
+        .then(this, [this, requestId, pageIndex](const BookPage &page) {
+            if (requestId != m_booksRequestId) {
+                return;  // Фільтри змінилися, поки сторінка завантажувалася
+            }
+            m_booksPageLoading = false;
+            onBooksPageLoaded(pageIndex, page);
+        });
+}
+
+void MainWindow::onBooksPageLoaded(int pageIndex, const BookPage &page)
+{
+    if (page.hasMore && m_booksPageTokens.size() == pageIndex + 1) {
+        m_booksPageTokens.append(page.nextPageToken);
+    }
+
+    const int lastResidentPage = m_booksFirstResidentPage + m_booksResidentPageSizes.size() - 1;
+    if (m_booksResidentPageSizes.isEmpty() || pageIndex == lastResidentPage + 1) {
+        if (m_booksResidentPageSizes.isEmpty()) {
+            m_booksFirstResidentPage = pageIndex;
+        }
+        m_booksModel->appendBooks(page.books);
+        m_booksResidentPageSizes.append(page.books.size());
+        // Вікно переповнене - витісняємо сторінки згори, утримуючи видиму картку на місці
+        while (m_booksModel->rowCount() > m_booksMaxResidentRows && m_booksResidentPageSizes.size() > 1) {
+            const int removed = m_booksResidentPageSizes.takeFirst();
+            ++m_booksFirstResidentPage;
+            ui->booksGridView->preserveScrollPosition(-removed, [this, removed]() {
+                m_booksModel->removeFirstRows(removed);
+            });
+        }
+    } else if (pageIndex == m_booksFirstResidentPage - 1) {
+        // Повернення до витісненої сторінки: її токен збережено, тож це той самий запит уперед
+        ui->booksGridView->preserveScrollPosition(page.books.size(), [this, &page]() {
+            m_booksModel->prependBooks(page.books);
+        });
+        m_booksResidentPageSizes.prepend(page.books.size());
+        m_booksFirstResidentPage = pageIndex;
+        while (m_booksModel->rowCount() > m_booksMaxResidentRows && m_booksResidentPageSizes.size() > 1) {
+            m_booksModel->removeLastRows(m_booksResidentPageSizes.takeLast());
+        }
+    } else {
+        qDebug() << "Books page" << pageIndex << "is no longer adjacent to the resident window, ignored.";
         return;
     }
 
-    qInfo() << "Loading books with current filters...";
-    QList<BookDisplayInfo> books = m_dbManager->getFilteredBooksForDisplay(m_currentFilterCriteria);
+    if (pageIndex == 0) {
+        ui->booksGridView->setPlaceholderText(tr("Не вдалося завантажити книги або їх немає в базі даних."));
+        if (!page.books.isEmpty()) {
+            ui->statusBar->showMessage(tr("Книги успішно завантажено."), 4000);
+        } else {
+            qInfo() << "No books found matching the current filters.";
+            ui->statusBar->showMessage(tr("Книг за вашим запитом не знайдено."), 4000);
+        }
+    }
 
-    displayBooks(books, ui->booksContainerLayout, ui->booksContainerWidget);
+    // Якщо сторінка не заповнила екран (або користувач уже біля краю) - одразу наступна.
+    // Відкладено, щоб view встиг розкласти нові рядки і оновити діапазон прокрутки.
+    QTimer::singleShot(0, ui->booksGridView, &CatalogGridView::checkScrollEdges);
+}
 
-    if (!books.isEmpty()) {
-         ui->statusBar->showMessage(tr("Книги успішно завантажено (%1 знайдено).").arg(books.size()), 4000);
-    } else {
-         qInfo() << "No books found matching the current filters.";
-         ui->statusBar->showMessage(tr("Книг за вашим запитом не знайдено."), 4000);
+void MainWindow::loadNextBooksPage()
+{
+    const int nextPage = m_booksFirstResidentPage + m_booksResidentPageSizes.size();
+    if (!m_booksResidentPageSizes.isEmpty() && nextPage < m_booksPageTokens.size()) {
+        requestBooksPage(nextPage);
+    }
+}
+
+void MainWindow::loadPreviousBooksPage()
+{
+    if (!m_booksResidentPageSizes.isEmpty() && m_booksFirstResidentPage > 0) {
+        requestBooksPage(m_booksFirstResidentPage - 1);
+    }
+}
+
+// Кількість книг біля кожного значення фільтра, щоб не обирати комбінацій без результату.
+// Зі знімком BookFilterManager - одразу в пам'яті, інакше одним запитом GetBookFacetCounts.
+void MainWindow::refreshFilterFacets()
+{
+    if (!m_genreFilterListWidget || !m_languageFilterListWidget || !m_inStockFilterCheckBox) {
+        return;
+    }
+    const int requestId = ++m_facetRequestId;
+    if (m_bookFilterManager && m_bookFilterManager->isReady()) {
+        applyFacetCounts(m_bookFilterManager->facets(m_currentFilterCriteria));
+        return;
+    }
+    if (!m_dbManager) {
+        return;
+    }
+    m_dbManager->getBookFacetCountsAsync(m_currentFilterCriteria).then(this, [this, requestId](const BookFacetCounts &facets) {
+        if (requestId != m_facetRequestId) {
+            return;  // Фільтри змінилися, поки рахувалися фасети
+        }
+        applyFacetCounts(facets);
+    });
+}
+
+void MainWindow::applyFacetCounts(const BookFacetCounts &facets)
+{
+    if (!facets.found) {
+        qWarning() << "Filter facet counts are unavailable.";
+        return;
+    }
+    if (m_genreFilterListWidget) {
+        applyListFacets(m_genreFilterListWidget, facets.genres);
+    }
+    if (m_languageFilterListWidget) {
+        applyListFacets(m_languageFilterListWidget, facets.languages);
+    }
+    if (m_inStockFilterCheckBox) {
+        const QSignalBlocker blocker(m_inStockFilterCheckBox);
+        m_inStockFilterCheckBox->setText(QString("%1 (%2)").arg(m_inStockFilterText).arg(facets.inStock));
+    }
+    if (m_priceRangeSlider) {
+        QStringList lines;
+        for (const PriceBucketCount &bucket : facets.priceBuckets) {
+            const QString range = bucket.maxPrice < 0
+                ? tr("від %1 грн").arg(bucket.minPrice)
+                : tr("%1–%2 грн").arg(bucket.minPrice).arg(bucket.maxPrice);
+            lines << tr("%1: %2 книг").arg(range).arg(bucket.count);
+        }
+        m_priceRangeSlider->setToolTip(lines.join('\n'));
     }
 }
 
@@ -981,33 +1183,23 @@ void MainWindow::updateBannerImages()
 
     for (int i = 0; i < bannerLabels.size(); ++i) {
         if (i < m_bannerImagePaths.size() && bannerLabels[i]) {
-            QPixmap bannerPixmap(m_bannerImagePaths[i]);
-            if (bannerPixmap.isNull()) {
-                qWarning() << "Failed to load banner image:" << m_bannerImagePaths[i];
-                bannerLabels[i]->setText(tr("Помилка завантаження банера %1").arg(i + 1));
-                bannerLabels[i]->setAlignment(Qt::AlignCenter);
-            } else {
-                QSize labelSize = bannerLabels[i]->size();
-                if (labelSize.isValid() && labelSize.width() > 0 && labelSize.height() > 0) {
-                    QPixmap scaledPixmap = bannerPixmap.scaled(labelSize, Qt::KeepAspectRatio, Qt::SmoothTransformation);
-
-                    QBitmap mask(scaledPixmap.size());
-                    mask.fill(Qt::color0);
-                    QPainter painter(&mask);
-                    painter.setRenderHint(QPainter::Antialiasing);
-                    painter.setBrush(Qt::color1);
-                    painter.drawRoundedRect(scaledPixmap.rect(), 18, 18);
-                    painter.end();
-
-                    scaledPixmap.setMask(mask);
-
-                    bannerLabels[i]->setPixmap(scaledPixmap);
+            QLabel *bannerLabel = bannerLabels[i];
+            const QString bannerPath = m_bannerImagePaths[i];
+            const QSize labelSize = bannerLabel->size();
+            // Поки розмір label невідомий - зображення без масштабування і заокруглення
+            ThumbnailSpec bannerSpec;
+            if (labelSize.isValid() && labelSize.width() > 0 && labelSize.height() > 0) {
+                bannerSpec = {labelSize, Qt::KeepAspectRatio, ImageShape::RoundedRect};
+            }
+            bannerLabel->setAlignment(Qt::AlignCenter);
+            loadLabelImage(bannerLabel, bannerPath, bannerSpec, [this, bannerLabel, bannerPath, i](const QPixmap &bannerPixmap) {
+                if (bannerPixmap.isNull()) {
+                    qWarning() << "Failed to load banner image:" << bannerPath;
+                    bannerLabel->setText(tr("Помилка завантаження банера %1").arg(i + 1));
                 } else {
-                    bannerLabels[i]->setPixmap(bannerPixmap);
-                    qDebug() << "Banner label" << i+1 << "size is invalid during update:" << labelSize << ". Setting original pixmap.";
+                    bannerLabel->setPixmap(bannerPixmap);
                 }
-                bannerLabels[i]->setAlignment(Qt::AlignCenter);
-            }
+            });
         } else if (bannerLabels[i]) {
              bannerLabels[i]->setText(tr("Банер %1").arg(i + 1));
              bannerLabels[i]->setAlignment(Qt::AlignCenter);
@@ -1018,6 +1210,11 @@ void MainWindow::updateBannerImages()
 
 void MainWindow::setupAutoBanner()
 {
+    m_bannerResizeTimer = new QTimer(this);
+    m_bannerResizeTimer->setSingleShot(true);
+    m_bannerResizeTimer->setInterval(CatalogGridView::RelayoutIntervalMs);
+    connect(m_bannerResizeTimer, &QTimer::timeout, this, &MainWindow::updateBannerImages);
+
     m_bannerImagePaths.clear();
     m_bannerImagePaths << ":/images/banner1.jpg"
                        << ":/images/banner2.jpg"
@@ -1065,17 +1262,10 @@ void MainWindow::resizeEvent(QResizeEvent *event)
 {
     QMainWindow::resizeEvent(event);
 
-    qDebug() << "Window resized to:" << event->size();
-
-    updateBannerImages();
-
-    if (ui->contentStackedWidget && ui->contentStackedWidget->currentWidget() == ui->booksPage) {
-        qDebug() << "Books page is active, triggering layout update via loadAndDisplayFilteredBooks().";
-        loadAndDisplayFilteredBooks();
-    }
-    else if (ui->contentStackedWidget && ui->contentStackedWidget->currentWidget() == ui->authorsPage) {
-        qDebug() << "Authors page is active, triggering layout update via loadAndDisplayAuthors().";
-        loadAndDisplayAuthors();
+    // Сітки каталогу перерозкладаються самі (CatalogGridView) з уже завантажених моделей -
+    // жодних запитів до БД. Банери масштабуються не частіше за раз на кадр.
+    if (m_bannerResizeTimer && !m_bannerResizeTimer->isActive()) {
+        m_bannerResizeTimer->start();
     }
 }
 
@@ -1120,22 +1310,18 @@ void MainWindow::populateAuthorDetailsPage(const AuthorDetailsInfo &details)
         return;
     }
 
-    QPixmap photoPixmap(details.imagePath);
-    if (photoPixmap.isNull() || details.imagePath.isEmpty()) {
-        ui->authorDetailPhotoLabel->setText(tr("👤"));
-        ui->authorDetailPhotoLabel->setStyleSheet("QLabel { background-color: #e0e0e0; color: #555; border-radius: 90px; font-size: 80pt; qproperty-alignment: AlignCenter; border: 1px solid #ccc; }");
-    } else {
-        QPixmap scaledPixmap = photoPixmap.scaled(ui->authorDetailPhotoLabel->size(), Qt::KeepAspectRatioByExpanding, Qt::SmoothTransformation);
-        QBitmap mask(scaledPixmap.size());
-        mask.fill(Qt::color0);
-        QPainter painter(&mask);
-        painter.setBrush(Qt::color1);
-        painter.drawEllipse(0, 0, scaledPixmap.width(), scaledPixmap.height());
-        painter.end();
-        scaledPixmap.setMask(mask);
-        ui->authorDetailPhotoLabel->setPixmap(scaledPixmap);
-        ui->authorDetailPhotoLabel->setStyleSheet("QLabel { border-radius: 90px; border: 1px solid #ccc; }");
-    }
+    QLabel *photoLabel = ui->authorDetailPhotoLabel;
+    photoLabel->clear();
+    photoLabel->setStyleSheet("QLabel { background-color: #e0e0e0; color: #555; border-radius: 90px; font-size: 80pt; qproperty-alignment: AlignCenter; border: 1px solid #ccc; }");
+    const ThumbnailSpec photoSpec{photoLabel->size(), Qt::KeepAspectRatioByExpanding, ImageShape::Circle};
+    loadLabelImage(photoLabel, details.imagePath, photoSpec, [this, photoLabel](const QPixmap &photoPixmap) {
+        if (photoPixmap.isNull()) {
+            photoLabel->setText(tr("👤"));
+        } else {
+            photoLabel->setPixmap(photoPixmap);
+            photoLabel->setStyleSheet("QLabel { border-radius: 90px; border: 1px solid #ccc; }");
+        }
+    });
 
     ui->authorDetailNameLabel->setText(details.firstName + " " + details.lastName);
 
@@ -1184,45 +1370,64 @@ void MainWindow::loadCartFromDatabase()
         return;
     }
 
-    int itemsLoaded = 0;
-    int itemsSkipped = 0;
-    for (auto it = dbCartItems.constBegin(); it != dbCartItems.constEnd(); ++it) {
-        int bookId = it.key();
-        int quantity = it.value();
-
-        BookDisplayInfo bookInfo = m_dbManager->getBookDisplayInfoById(bookId);
-        if (bookInfo.found) {
-            if (quantity > bookInfo.stockQuantity) {
-                qWarning() << "loadCartFromDatabase: Кількість товару (ID:" << bookId << ") в корзині (" << quantity
-                           << ") перевищує наявну на складі (" << bookInfo.stockQuantity << "). Встановлюємо кількість на" << bookInfo.stockQuantity;
-                quantity = bookInfo.stockQuantity;
-                if (quantity > 0) {
-                    m_dbManager->addOrUpdateCartItem(m_currentCustomerId, bookId, quantity);
+    // Інформація про всі книги корзини - одним пакетним запитом
+    const int customerId = m_currentCustomerId;
+    m_dbManager->loadBookDisplayInfos(dbCartItems.keys())
+        .then(this, [this, customerId, dbCartItems](const QMap<int, BookDisplayInfo> &books) {
+            if (customerId != m_currentCustomerId) {
+                return;
+            }
+            if (books.isEmpty()) {
+                // Порожня відповідь на непорожню корзину - швидше помилка запиту, ніж видалені книги
+                qWarning() << "loadCartFromDatabase: Не вдалося отримати інформацію про книги корзини. Корзину в БД не змінено.";
+                updateCartIcon();
+                return;
+            }
+
+            int itemsLoaded = 0;
+            int itemsSkipped = 0;
+            for (auto it = dbCartItems.constBegin(); it != dbCartItems.constEnd(); ++it) {
+                int bookId = it.key();
+                int quantity = it.value();
+                if (m_cartItems.contains(bookId)) {
+                    // Користувач уже змінив цю позицію, поки корзина завантажувалась
+                    continue;
+                }
+
+                BookDisplayInfo bookInfo = books.value(bookId);
+                if (bookInfo.found) {
+                    if (quantity > bookInfo.stockQuantity) {
+                        qWarning() << "loadCartFromDatabase: Кількість товару (ID:" << bookId << ") в корзині (" << quantity
+                                   << ") перевищує наявну на складі (" << bookInfo.stockQuantity << "). Встановлюємо кількість на" << bookInfo.stockQuantity;
+                        quantity = bookInfo.stockQuantity;
+                        if (quantity > 0) {
+                            m_dbManager->addOrUpdateCartItem(m_currentCustomerId, bookId, quantity);
+                        } else {
+                            m_dbManager->removeCartItem(m_currentCustomerId, bookId);
+                            itemsSkipped++;
+                            continue;
+                        }
+                    }
+
+                    CartItem newItem;
+                    newItem.book = bookInfo;
+                    newItem.quantity = quantity;
+                    m_cartItems.insert(bookId, newItem);
+                    itemsLoaded++;
                 } else {
+                    qWarning() << "loadCartFromDatabase: Не вдалося знайти інформацію для книги з ID" << bookId << ", яка є в корзині БД. Видаляємо з корзини БД.";
                     m_dbManager->removeCartItem(m_currentCustomerId, bookId);
                     itemsSkipped++;
-                    continue;
                 }
             }
 
-            CartItem newItem;
-            newItem.book = bookInfo;
-            newItem.quantity = quantity;
-            m_cartItems.insert(bookId, newItem);
-            itemsLoaded++;
-        } else {
-            qWarning() << "loadCartFromDatabase: Не вдалося знайти інформацію для книги з ID" << bookId << ", яка є в корзині БД. Видаляємо з корзини БД.";
-            m_dbManager->removeCartItem(m_currentCustomerId, bookId);
-            itemsSkipped++;
-        }
-    }
+            qInfo() << "Корзину завантажено з БД. Завантажено:" << itemsLoaded << ", Пропущено/Видалено:" << itemsSkipped;
 
-    qInfo() << "Корзину завантажено з БД. Завантажено:" << itemsLoaded << ", Пропущено/Видалено:" << itemsSkipped;
-
-    updateCartIcon();
-    if (ui->contentStackedWidget->currentWidget() == ui->cartPage) {
-        populateCartPage();
-    }
+            updateCartIcon();
+            if (ui->contentStackedWidget->currentWidget() == ui->cartPage) {
+                populateCartPage();
+            }
+        });
 }
 
 void MainWindow::applyGenreFilter(const QString &genreName)
@@ -1237,7 +1442,7 @@ void MainWindow::applyGenreFilter(const QString &genreName)
         bool genreFound = false;
         for (int i = 0; i < m_genreFilterListWidget->count(); ++i) {
             QListWidgetItem *item = m_genreFilterListWidget->item(i);
-            if (item && item->text() == genreName) {
+            if (item && item->data(Qt::UserRole).toString() == genreName) {
                 m_genreFilterListWidget->blockSignals(true);
                 item->setCheckState(Qt::Checked);
                 m_genreFilterListWidget->blockSignals(false);
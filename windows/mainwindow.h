@@ -14,7 +14,6 @@
 #include <QMap>
 #include <QLineEdit>
 #include <QCompleter>
-#include <QStandardItemModel>
 #include <QMouseEvent>
 #include <QMap>
 #include <QSpinBox>
@@ -25,7 +24,16 @@
 #include <QResizeEvent>
 #include <QMessageBox> // Додано для QMessageBox::Icon та QMessageBox::StandardButton
 #include "searchsuggestiondelegate.h"
+#include "searchsuggestionlistmodel.h"
+#include "cataloggridmodel.h"
+#include "catalogcarddelegate.h"
+#include "cataloggridview.h"
+#include "bookfiltermanager.h"
+#include "imageservice.h"
+#include "suggestionindex.h"
 #include "datatypes.h"
+#include <functional>
+#include <memory>
 #include "checkoutdialog.h"
 
 
@@ -35,7 +43,6 @@ class QListWidget;
 class RangeSlider;
 class QLabel;
 class QCheckBox;
-class QStandardItemModel;
 struct CustomerProfileInfo;
 struct BookDetailsInfo;
 class QLabel;
@@ -83,6 +90,7 @@ private slots:
     void hideOrderDetailsPanel();
     void showNextBanner();
     void onSearchSuggestionActivated(const QModelIndex &index);
+    void onGlobalSearchSubmitted();
     void showAuthorDetails(int authorId);
     void on_filterButton_clicked();
     void applyFilters();
@@ -102,15 +110,17 @@ private:
     void displayAuthors(const QList<AuthorDisplayInfo> &authors);
     void displayBooksInHorizontalLayout(const QList<BookDisplayInfo> &books, QHBoxLayout* layout);
     QWidget* createBookCardWidget(const BookDisplayInfo &bookInfo);
-    QWidget* createAuthorCardWidget(const AuthorDisplayInfo &authorInfo);
     QWidget* createCommentWidget(const CommentDisplayInfo &commentInfo);
     void populateProfilePanel(const CustomerProfileInfo &profileInfo);
 
     QWidget* createOrderWidget(const OrderDisplayInfo &orderInfo);
     void displayOrders(const QList<OrderDisplayInfo> &orders);
     void loadAndDisplayOrders();
+    void onOrdersLoaded(const QList<OrderDisplayInfo> &allOrders); // Відображення результату асинхронного завантаження
 
     void clearLayout(QLayout* layout);
+    void loadLabelImage(QLabel *label, const QString &path, const ThumbnailSpec &spec,
+                        const std::function<void(const QPixmap &)> &onReady);
 
     void setProfileEditingEnabled(bool enabled);
     void populateBookDetailsPage(const BookDetailsInfo &details);
@@ -125,15 +135,32 @@ private:
     void setupSidebarAnimation();
     void toggleSidebar(bool expand);
     void setupSearchCompleter();
+    void showSearchSuggestions(const QString &text, const QList<SearchSuggestionInfo> &suggestions);
+    void requestDatabaseSuggestions();
+    void cancelDatabaseSuggestions();
+    void loadSuggestionIndex();
+    void refreshSuggestionIndex();
+    void setupSearchResultsPage();
+    void runBookSearch(const QString &queryText, int offset);
+    void displaySearchResults(const BookSearchPage &page);
+    QWidget* createSearchResultWidget(const BookSearchResult &result);
     void setupAutoBanner();
     void updateBannerImages();
+    void setupCatalogViews();
     void setupFilterPanel();
     void loadAndDisplayFilteredBooks();
+    void refreshFilterFacets();
+    void applyFacetCounts(const BookFacetCounts &facets);
+    void requestBooksPage(int pageIndex);
+    void onBooksPageLoaded(int pageIndex, const BookPage &page);
+    void loadNextBooksPage();
+    void loadPreviousBooksPage();
     void loadAndDisplayAuthors();
     void loadCartFromDatabase();
 
     Ui::MainWindow *ui;
     DatabaseManager *m_dbManager;
+    ImageService *m_imageService = nullptr;   // Обкладинки, фото й банери: декодування у фоні, кеш мініатюр
     int m_currentCustomerId;
 
     QPropertyAnimation *m_sidebarAnimation = nullptr;
@@ -143,16 +170,49 @@ private:
     QMap<QPushButton*, QString> m_buttonOriginalText;
 
     QCompleter *m_searchCompleter = nullptr;
-    QStandardItemModel *m_searchSuggestionModel = nullptr;
+    SearchSuggestionListModel *m_searchSuggestionModel = nullptr;
     SearchSuggestionDelegate *m_searchDelegate = nullptr;
+    std::shared_ptr<SuggestionIndex> m_suggestionIndex;   // Автодоповнення без БД; null, доки не завантажено
+    QTimer *m_suggestionRefreshTimer = nullptr;
+    bool m_suggestionIndexLoading = false;
+    int m_suggestionRequestId = 0;   // Покоління введеного тексту: відповідь БД для старішого відкидається
+    QTimer *m_suggestionDebounceTimer = nullptr;          // Запит до БД - лише після паузи у введенні
+    QString m_pendingSuggestionText;
+    std::shared_ptr<QueryCancelToken> m_suggestionCancelToken;   // Запит до БД, що виконується
+
+    CatalogGridModel *m_booksModel = nullptr;      // Сторінка "Книги" (ui->booksGridView)
+    CatalogGridModel *m_authorsModel = nullptr;    // Сторінка "Автори" (ui->authorsGridView)
+    CatalogCardDelegate *m_catalogCardDelegate = nullptr;
+
+    static constexpr int FilterApplyIntervalMs = 750;           // Фільтри через БД
+    static constexpr int FilterApplyIntervalInMemoryMs = 50;    // Фільтри над знімком BookFilterManager
+
+    // Сторінка "Книги" довантажується сторінками keyset під час прокрутки
+    int m_booksPageSize = 60;            // Кратне типовим 3-6 колонкам: витіснення сторінки не перемішує ряди
+    int m_booksMaxResidentRows = 600;    // Понад це найдальші від видимої області сторінки витісняються
+    QStringList m_booksPageTokens;       // Токен запиту кожної вже відомої сторінки (сторінка 0 - порожній)
+    QList<int> m_booksResidentPageSizes; // Рядків у моделі від кожної завантаженої сторінки, по порядку
+    int m_booksFirstResidentPage = 0;
+    int m_booksRequestId = 0;            // Покоління фільтрів: відповідь для старіших відкидається
+    bool m_booksPageLoading = false;
+    BookFilterManager *m_bookFilterManager = nullptr;   // Фільтри панелі без БД, щойно знімок каталогу готовий
+    BookFilterManager::Result m_booksFilterResult;       // Поточні фільтри над знімком; недійсний - сторінки з БД
+
+    QString m_searchQuery;           // Запит, показаний на сторінці результатів
+    int m_searchOffset = 0;
+    int m_searchPageSize = 20;
+    int m_searchRequestId = 0;       // Лічильник пошукових запитів (відкидаємо застарілі відповіді)
 
     QMap<int, CartItem> m_cartItems;
     QMap<int, QLabel*> m_cartSubtotalLabels;
 
     int m_currentBookDetailsId = -1;
+    int m_pendingBookDetailsId = -1; // Книга, деталі якої зараз завантажуються асинхронно
+    int m_ordersRequestId = 0;       // Лічильник запитів замовлень (відкидаємо застарілі відповіді)
     int m_currentAuthorDetailsId = -1;
 
     QTimer *m_bannerTimer = nullptr;
+    QTimer *m_bannerResizeTimer = nullptr;   // Масштабування банерів під час зміни розміру вікна
     QStringList m_bannerImagePaths;
     int m_currentBannerIndex = 0;
     QList<QRadioButton*> m_bannerIndicators;
@@ -168,6 +228,8 @@ private:
     QLabel *m_minPriceValueLabel = nullptr;
     QLabel *m_maxPriceValueLabel = nullptr;
     QCheckBox *m_inStockFilterCheckBox = nullptr;
+    QString m_inStockFilterText;     // Текст прапорця без кількості книг
+    int m_facetRequestId = 0;        // Відповідь фасетів для старіших фільтрів відкидається
 
     QTimer *m_filterApplyTimer = nullptr;
 
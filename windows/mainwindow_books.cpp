@@ -14,6 +14,7 @@
 #include "starratingwidget.h"
 #include <QLineEdit>
 #include <QScrollArea> // Додано для доступу до QScrollArea
+#include <QStatusBar>
 
 QWidget* MainWindow::createBookCardWidget(const BookDisplayInfo &bookInfo)
 {
@@ -33,18 +34,16 @@ QWidget* MainWindow::createBookCardWidget(const BookDisplayInfo &bookInfo)
     coverLabel->setAlignment(Qt::AlignCenter);
     coverLabel->setMinimumHeight(150);
     coverLabel->setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Expanding);
-    QPixmap coverPixmap;
-    if (!bookInfo.coverImagePath.isEmpty()) {
-        coverPixmap.load(bookInfo.coverImagePath);
-    }
-
-    if (coverPixmap.isNull()) {
-        coverLabel->setText(tr("Немає\nобкладинки"));
-        coverLabel->setStyleSheet("QLabel { background-color: #e0e0e0; color: #555; border-radius: 4px; }");
-    } else {
-        coverLabel->setPixmap(coverPixmap.scaled(180, 240, Qt::KeepAspectRatio, Qt::SmoothTransformation));
-        coverLabel->setStyleSheet("");
-    }
+    // Сірий placeholder, доки ImageService декодує обкладинку
+    coverLabel->setStyleSheet("QLabel { background-color: #e0e0e0; color: #555; border-radius: 4px; }");
+    loadLabelImage(coverLabel, bookInfo.coverImagePath, {QSize(180, 240)}, [this, coverLabel](const QPixmap &coverPixmap) {
+        if (coverPixmap.isNull()) {
+            coverLabel->setText(tr("Немає\nобкладинки"));
+        } else {
+            coverLabel->setPixmap(coverPixmap);
+            coverLabel->setStyleSheet("");
+        }
+    });
     cardLayout->addWidget(coverLabel);
 
     QLabel *titleLabel = new QLabel(bookInfo.title);
@@ -208,18 +207,27 @@ void MainWindow::showBookDetails(int bookId)
          return;
     }
 
-    BookDetailsInfo bookDetails = m_dbManager->getBookDetails(bookId);
+    // Деталі завантажуються на робочому потоці, GUI не блокується
+    m_pendingBookDetailsId = bookId;
+    ui->statusBar->showMessage(tr("Завантаження інформації про книгу..."));
 
-    if (!bookDetails.found) {
-        QMessageBox::warning(this, tr("Помилка"), tr("Не вдалося знайти інформацію для книги з ID %1.").arg(bookId));
-        return;
-    }
+    m_dbManager->getBookDetailsAsync(bookId).then(this, [this, bookId](const BookDetailsInfo &bookDetails) {
+        if (m_pendingBookDetailsId != bookId) {
+            return; // Користувач уже відкрив іншу книгу
+        }
+        m_pendingBookDetailsId = -1;
+        ui->statusBar->clearMessage();
 
-    populateBookDetailsPage(bookDetails);
+        if (!bookDetails.found) {
+            QMessageBox::warning(this, tr("Помилка"), tr("Не вдалося знайти інформацію для книги з ID %1.").arg(bookId));
+            return;
+        }
 
-    m_currentBookDetailsId = bookId;
+        m_currentBookDetailsId = bookId;
+        populateBookDetailsPage(bookDetails);
 
-    ui->contentStackedWidget->setCurrentWidget(ui->bookDetailsPage);
+        ui->contentStackedWidget->setCurrentWidget(ui->bookDetailsPage);
+    });
 }
 
 void MainWindow::populateBookDetailsPage(const BookDetailsInfo &details)
@@ -238,14 +246,17 @@ void MainWindow::populateBookDetailsPage(const BookDetailsInfo &details)
         return;
     }
 
-    QPixmap coverPixmap(details.coverImagePath);
-    if (coverPixmap.isNull() || details.coverImagePath.isEmpty()) {
-        ui->bookDetailCoverLabel->setText(tr("Немає\nобкладинки"));
-        ui->bookDetailCoverLabel->setStyleSheet("QLabel { background-color: #e0e0e0; color: #555; border: 1px solid #ccc; border-radius: 4px; }");
-    } else {
-        ui->bookDetailCoverLabel->setPixmap(coverPixmap.scaled(ui->bookDetailCoverLabel->size(), Qt::KeepAspectRatio, Qt::SmoothTransformation));
-        ui->bookDetailCoverLabel->setStyleSheet("QLabel { background-color: transparent; border: 1px solid #ccc; border-radius: 4px; }");
-    }
+    QLabel *coverLabel = ui->bookDetailCoverLabel;
+    coverLabel->clear();
+    coverLabel->setStyleSheet("QLabel { background-color: #e0e0e0; color: #555; border: 1px solid #ccc; border-radius: 4px; }");
+    loadLabelImage(coverLabel, details.coverImagePath, {coverLabel->size()}, [this, coverLabel](const QPixmap &coverPixmap) {
+        if (coverPixmap.isNull()) {
+            coverLabel->setText(tr("Немає\nобкладинки"));
+        } else {
+            coverLabel->setPixmap(coverPixmap);
+            coverLabel->setStyleSheet("QLabel { background-color: transparent; border: 1px solid #ccc; border-radius: 4px; }");
+        }
+    });
 
     ui->bookDetailTitleLabel->setText(details.title.isEmpty() ? tr("(Без назви)") : details.title);
     ui->bookDetailAuthorLabel->setText(details.authors.isEmpty() ? tr("(Автор невідомий)") : details.authors);
@@ -324,18 +335,25 @@ void MainWindow::populateBookDetailsPage(const BookDetailsInfo &details)
 
     if (ui->similarBooksWidget && ui->similarBooksLayout) {
         if (!details.genre.isEmpty() && m_dbManager) {
-            QList<BookDisplayInfo> similarBooks = m_dbManager->getSimilarBooks(details.bookId, details.genre, 5);
-
-            if (!similarBooks.isEmpty()) {
-                clearLayout(ui->similarBooksLayout);
-                displayBooksInHorizontalLayout(similarBooks, ui->similarBooksLayout);
-                ui->similarBooksWidget->setVisible(true);
-                qInfo() << "Displayed" << similarBooks.count() << "similar books.";
-            } else {
+            // Схожі книги довантажуються після показу основної інформації
+            clearLayout(ui->similarBooksLayout);
+            ui->similarBooksWidget->setVisible(false);
+            const int bookId = details.bookId;
+            const QString genre = details.genre;
+            m_dbManager->getSimilarBooksAsync(bookId, genre, 5).then(this, [this, bookId, genre](const QList<BookDisplayInfo> &similarBooks) {
+                if (m_currentBookDetailsId != bookId) {
+                    return; // Сторінка вже показує іншу книгу
+                }
                 clearLayout(ui->similarBooksLayout);
-                ui->similarBooksWidget->setVisible(false);
-                qInfo() << "No similar books found for genre:" << details.genre;
-            }
+                if (!similarBooks.isEmpty()) {
+                    displayBooksInHorizontalLayout(similarBooks, ui->similarBooksLayout);
+                    ui->similarBooksWidget->setVisible(true);
+                    qInfo() << "Displayed" << similarBooks.count() << "similar books.";
+                } else {
+                    ui->similarBooksWidget->setVisible(false);
+                    qInfo() << "No similar books found for genre:" << genre;
+                }
+            });
         } else {
             clearLayout(ui->similarBooksLayout);
             ui->similarBooksWidget->setVisible(false);
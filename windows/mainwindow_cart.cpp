@@ -51,18 +51,18 @@ QWidget* MainWindow::createCartItemWidget(const CartItem &item, int bookId)
     QLabel *coverLabel = new QLabel();
     coverLabel->setObjectName("cartItemCoverLabel");
     coverLabel->setAlignment(Qt::AlignCenter);
-    QPixmap coverPixmap(item.book.coverImagePath);
-    if (coverPixmap.isNull() || item.book.coverImagePath.isEmpty()) {
-        coverLabel->setText(tr("Фото"));
-    } else {
-        QSize labelSize = coverLabel->minimumSize();
-        if (!labelSize.isValid() || labelSize.width() <= 0 || labelSize.height() <= 0) {
-             labelSize = QSize(60, 85);
-             qWarning() << "Cart item cover label size not set, using default:" << labelSize;
-        }
-        coverLabel->setPixmap(coverPixmap.scaled(labelSize, Qt::KeepAspectRatio, Qt::SmoothTransformation));
-        coverLabel->setText("");
+    QSize labelSize = coverLabel->minimumSize();
+    if (!labelSize.isValid() || labelSize.width() <= 0 || labelSize.height() <= 0) {
+         labelSize = QSize(60, 85);
     }
+    loadLabelImage(coverLabel, item.book.coverImagePath, {labelSize}, [this, coverLabel](const QPixmap &coverPixmap) {
+        if (coverPixmap.isNull()) {
+            coverLabel->setText(tr("Фото"));
+        } else {
+            coverLabel->setPixmap(coverPixmap);
+            coverLabel->setText("");
+        }
+    });
     mainLayout->addWidget(coverLabel);
 
     QVBoxLayout *infoLayout = new QVBoxLayout();
@@ -149,14 +149,9 @@ void MainWindow::on_addToCartButtonClicked(int bookId)
     }
 
     bool dbSuccess = m_dbManager->addOrUpdateCartItem(m_currentCustomerId, bookId, targetQuantity);
-    
-    // Завжди отримуємо свіжу інформацію про книгу після спроби оновлення БД
-    BookDisplayInfo freshBookInfo = m_dbManager->getBookDisplayInfoById(bookId);
-    if (!freshBookInfo.found && dbSuccess) { // Якщо книга зникла після успішного додавання (дуже малоймовірно)
-        qWarning() << "Book ID" << bookId << "was added to cart but now cannot be found.";
-        // Можливо, варто відкотити операцію або видалити з корзини
-    }
 
+    // Додавання в корзину не змінює залишок, тож повторно читати книгу не потрібно
+    const BookDisplayInfo &freshBookInfo = currentBookInfo;
 
     if (dbSuccess) {
         if (isNewItemInCart) {
@@ -248,10 +243,13 @@ void MainWindow::populateCartPage()
 
     ui->cartTotalsWidget->setVisible(true);
 
+    // Актуальні залишки для всіх позицій одним запитом
+    const QMap<int, BookDisplayInfo> freshBooks = m_dbManager->getBookDisplayInfoByIds(m_cartItems.keys());
+
     for (auto it = m_cartItems.constBegin(); it != m_cartItems.constEnd(); ++it) {
         // Перед створенням віджету, переконуємось, що stockQuantity актуальний
         // Це важливо, якщо populateCartPage викликається після невдалої спроби оновлення
-        BookDisplayInfo freshBookInfo = m_dbManager->getBookDisplayInfoById(it.key());
+        BookDisplayInfo freshBookInfo = freshBooks.value(it.key());
         if (freshBookInfo.found) {
             m_cartItems[it.key()].book.stockQuantity = freshBookInfo.stockQuantity;
             // Якщо кількість в корзині перевищує новий залишок, коригуємо її
@@ -511,8 +509,9 @@ void MainWindow::on_placeOrderButton_clicked()
     // Перевірка актуальності залишків перед оформленням
     bool allItemsAvailable = true;
     QString unavailableItemsMessage = tr("Деякі товари у вашому кошику більше не доступні в замовленій кількості або відсутні на складі:\n");
+    const QMap<int, BookDisplayInfo> freshBooks = m_dbManager->getBookDisplayInfoByIds(m_cartItems.keys());
     for (auto it = m_cartItems.begin(); it != m_cartItems.end(); ++it) {
-        BookDisplayInfo freshInfo = m_dbManager->getBookDisplayInfoById(it.key());
+        BookDisplayInfo freshInfo = freshBooks.value(it.key());
         if (!freshInfo.found || freshInfo.stockQuantity < it.value().quantity) {
             allItemsAvailable = false;
             unavailableItemsMessage += tr("\n- %1 (замовлено: %2, доступно: %3)")
@@ -604,6 +603,9 @@ void MainWindow::finalizeOrder(const QString &shippingAddress, const QString &pa
 
          m_cartItems.clear();
          updateCartIcon();
+         if (m_bookFilterManager) {
+             m_bookFilterManager->reload(); // Залишки змінилися - фільтр "В наявності" має це бачити
+         }
          // populateCartPage(); // Корзина порожня, populateCartPage відобразить це
          on_navOrdersButton_clicked(); // Переходимо на сторінку замовлень
          ui->contentStackedWidget->setCurrentWidget(ui->ordersPage); // Явно переключаємо сторінку
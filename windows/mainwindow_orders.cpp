@@ -172,10 +172,20 @@ void MainWindow::loadAndDisplayOrders()
         return;
     }
 
-    // Отримуємо всі замовлення
-    QList<OrderDisplayInfo> allOrders = m_dbManager->getCustomerOrdersForDisplay(m_currentCustomerId);
-    qInfo() << "Завантажено" << allOrders.size() << "замовлень.";
+    // Замовлення завантажуються на робочому потоці; поки що показуємо статус завантаження
+    const int requestId = ++m_ordersRequestId;
+    ui->statusBar->showMessage(tr("Завантаження замовлень..."));
+    m_dbManager->getCustomerOrdersForDisplayAsync(m_currentCustomerId).then(this, [this, requestId](const QList<OrderDisplayInfo> &allOrders) {
+        if (requestId != m_ordersRequestId) {
+            return; // Є новіший запит
+        }
+        qInfo() << "Завантажено" << allOrders.size() << "замовлень.";
+        onOrdersLoaded(allOrders);
+    });
+}
 
+void MainWindow::onOrdersLoaded(const QList<OrderDisplayInfo> &allOrders)
+{
     // // Отримуємо вибраний статус та дату для фільтрації - ВІДЖЕТИ ВИДАЛЕНО З UI
     // QString statusFilter = ui->orderStatusComboBox->currentText();
     // QDate dateFilter = ui->orderDateEdit->date(); // Отримуємо дату з QDateEdit
@@ -224,9 +234,7 @@ void MainWindow::loadAndDisplayOrders()
 
     displayOrders(filteredOrders); // Відображаємо замовлення (наразі всі)
 
-    if (m_dbManager->lastError().isValid()) {
-         ui->statusBar->showMessage(tr("Помилка при завантаженні замовлень: %1").arg(m_dbManager->lastError().text()), 5000);
-    } else if (!filteredOrders.isEmpty()) { // Використовуємо відфільтрований список
+    if (!filteredOrders.isEmpty()) { // Використовуємо відфільтрований список
          ui->statusBar->showMessage(tr("Замовлення успішно завантажено."), 3000);
     } else {
          // Якщо помилки не було, але замовлень 0 (після фільтрації), показуємо відповідне повідомлення
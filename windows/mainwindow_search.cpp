@@ -2,12 +2,31 @@
 #include "./ui_mainwindow.h"
 #include <QLineEdit>
 #include <QCompleter>
-#include <QStandardItemModel> // Змінено з QStringListModel
-#include <QStandardItem>      // Додано для створення елементів моделі
 #include <QDebug>
 #include <QListView>          // Додано для доступу до popup view
 #include "searchsuggestiondelegate.h" // Додано включення делегата
 #include <QMessageBox>        // Додано для QMessageBox
+#include <QFrame>
+#include <QLabel>
+#include <QHBoxLayout>
+#include <QVBoxLayout>
+#include <QPushButton>
+#include <QScrollBar>
+#include <QPixmap>
+#include <QElapsedTimer>
+#include <QThreadPool>
+
+namespace {
+// ts_headline не екранує текст: екрануємо все, потім замінюємо позначки збігів U+0001/U+0002
+// (SearchBooks) на <b>...</b>. Теги, набрані в самій назві чи описі, лишаються текстом.
+QString headlineToHtml(const QString &headline)
+{
+    QString html = headline.toHtmlEscaped();
+    html.replace(QChar(0x01), QLatin1String("<b>"));
+    html.replace(QChar(0x02), QLatin1String("</b>"));
+    return html;
+}
+}
 
 // Налаштування автодоповнення для глобального пошуку
 void MainWindow::setupSearchCompleter()
@@ -17,17 +36,20 @@ void MainWindow::setupSearchCompleter()
         return;
     }
 
-    // Використовуємо QStandardItemModel замість QStringListModel
-    m_searchSuggestionModel = new QStandardItemModel(this);
+    // Модель застосовує нові пропозиції різницею, а не clear() + appendRow
+    m_searchSuggestionModel = new SearchSuggestionListModel(this);
     m_searchCompleter = new QCompleter(m_searchSuggestionModel, this);
 
     m_searchCompleter->setCaseSensitivity(Qt::CaseInsensitive);
-    m_searchCompleter->setCompletionMode(QCompleter::PopupCompletion);
+    // Модель уже відфільтрована базою; без Unfiltered комплітер сховав би нечіткі кандидати,
+    // які не починаються з введеного тексту
+    m_searchCompleter->setCompletionMode(QCompleter::UnfilteredPopupCompletion);
     // Важливо: FilterMode більше не потрібен, оскільки ми самі фільтруємо в updateSearchSuggestions
     // m_searchCompleter->setFilterMode(Qt::MatchStartsWith); // Видалено або закоментовано
 
     // Створюємо та встановлюємо наш кастомний делегат
     m_searchDelegate = new SearchSuggestionDelegate(this);
+    m_searchDelegate->setImageService(m_imageService);
     if (m_searchCompleter->popup()) {
         m_searchCompleter->popup()->setItemDelegate(m_searchDelegate);
         // Налаштування вигляду popup (опціонально)
@@ -64,9 +86,69 @@ void MainWindow::setupSearchCompleter()
             this, &MainWindow::onSearchSuggestionActivated);
 
 
+    // Запит до БД іде лише після паузи у введенні; кожне натискання скидає таймер
+    m_suggestionDebounceTimer = new QTimer(this);
+    m_suggestionDebounceTimer->setSingleShot(true);
+    m_suggestionDebounceTimer->setInterval(200);
+    connect(m_suggestionDebounceTimer, &QTimer::timeout, this, &MainWindow::requestDatabaseSuggestions);
+
+    // Індекс пропозицій у пам'яті: завантажується один раз, далі дозавантажуються нові книги й автори
+    m_suggestionRefreshTimer = new QTimer(this);
+    m_suggestionRefreshTimer->setInterval(60 * 1000);
+    connect(m_suggestionRefreshTimer, &QTimer::timeout, this, &MainWindow::refreshSuggestionIndex);
+    loadSuggestionIndex();
+
     qInfo() << "Search completer setup complete for globalSearchLineEdit.";
 }
 
+// Повне завантаження SuggestionIndex: запит і побудова на робочому потоці, заміна - в GUI-потоці
+void MainWindow::loadSuggestionIndex()
+{
+    if (!m_dbManager || m_suggestionIndexLoading) {
+        return;
+    }
+    m_suggestionIndexLoading = true;
+    DatabaseManager *dbManager = m_dbManager;
+    m_dbManager->runAsync([dbManager]() {
+        QElapsedTimer timer;
+        timer.start();
+        auto index = std::make_shared<SuggestionIndex>();
+        index->build(dbManager->getSuggestionSource());
+        qInfo() << "SuggestionIndex:" << index->itemCount() << "елементів," << index->keyCount() << "ключів,"
+                << index->memoryUsage() / 1024 << "КіБ, побудовано за" << timer.elapsed() << "мс";
+        return index;
+    }).then(this, [this](std::shared_ptr<SuggestionIndex> index) {
+        m_suggestionIndexLoading = false;
+        if (index->itemCount() == 0) {
+            return; // Немає з'єднання чи даних - лишаємося на запитах до БД, спробуємо при оновленні
+        }
+        m_suggestionIndex = std::move(index);
+        m_suggestionRefreshTimer->start();
+    });
+}
+
+// Дозавантаження книг і авторів, доданих після побудови індексу. Перейменування та видалення
+// підхоплює повне перезавантаження (коли додаток до індексу розрісся або при наступному запуску).
+void MainWindow::refreshSuggestionIndex()
+{
+    if (!m_suggestionIndex) {
+        loadSuggestionIndex();
+        return;
+    }
+    if (m_suggestionIndex->needsCompaction()) {
+        loadSuggestionIndex();
+        return;
+    }
+    const std::shared_ptr<SuggestionIndex> index = m_suggestionIndex;
+    m_dbManager->getSuggestionSourceAsync(index->maxId(SearchSuggestionInfo::Book), index->maxId(SearchSuggestionInfo::Author))
+        .then(this, [index](const QList<SuggestionSourceItem> &items) {
+            if (!items.isEmpty()) {
+                index->upsert(items);
+                qInfo() << "SuggestionIndex: дозавантажено" << items.size() << "елементів";
+            }
+        });
+}
+
 // Слот для оновлення пропозицій пошуку при зміні тексту
 void MainWindow::updateSearchSuggestions(const QString &text)
 {
@@ -75,6 +157,10 @@ void MainWindow::updateSearchSuggestions(const QString &text)
         return; // Немає менеджера БД або моделі
     }
 
+    // Нове покоління: усе, що ще чекає чи виконується для попереднього тексту, вже не потрібне
+    ++m_suggestionRequestId;
+    cancelDatabaseSuggestions();
+
     // Отримуємо пропозиції, якщо текст НЕ порожній (шукаємо з першої літери)
     if (text.isEmpty()) {
         m_searchSuggestionModel->clear(); // Очищаємо модель, якщо текст порожній
@@ -82,32 +168,54 @@ void MainWindow::updateSearchSuggestions(const QString &text)
         return;
     }
 
-    // Отримуємо розширені пропозиції
-    QList<SearchSuggestionInfo> suggestions = m_dbManager->getSearchSuggestions(text);
-
-    // Очищаємо модель перед заповненням новими даними
-    m_searchSuggestionModel->clear();
+    // Спершу індекс у пам'яті (мікросекунди, без мережі). До БД - лише асинхронно після паузи
+    // у введенні: поки індекс не завантажено або коли префікс нічого не дав (нечіткі кандидати pg_trgm).
+    if (m_suggestionIndex) {
+        const QList<SearchSuggestionInfo> suggestions = m_suggestionIndex->lookup(text, 10);
+        if (!suggestions.isEmpty() || text.trimmed().size() < 3) {
+            showSearchSuggestions(text, suggestions);
+            return;
+        }
+    }
+    m_pendingSuggestionText = text;
+    m_suggestionDebounceTimer->start();
+}
 
-    // Заповнюємо модель даними
-    for (const SearchSuggestionInfo &suggestion : suggestions) {
-        QStandardItem *item = new QStandardItem();
-        item->setData(suggestion.displayText, SearchSuggestionRoles::DisplayTextRole); // Основний текст
-        item->setData(QVariant::fromValue(suggestion.type), SearchSuggestionRoles::TypeRole); // Тип (enum)
-        item->setData(suggestion.id, SearchSuggestionRoles::IdRole); // ID
-        item->setData(suggestion.imagePath, SearchSuggestionRoles::ImagePathRole); // Шлях до зображення
-        item->setData(suggestion.price, SearchSuggestionRoles::PriceRole); // Додаємо ціну
+// Запит пропозицій до БД для тексту, на якому зупинилося введення
+void MainWindow::requestDatabaseSuggestions()
+{
+    const int generation = m_suggestionRequestId;
+    const QString text = m_pendingSuggestionText;
+    auto cancelToken = std::make_shared<QueryCancelToken>();
+    m_suggestionCancelToken = cancelToken;
 
-        // Додаємо ToolTip для додаткової інформації (опціонально)
-        item->setToolTip(QString("Тип: %1\nID: %2%3")
-                         .arg(suggestion.type == SearchSuggestionInfo::Book ? tr("Книга") : tr("Автор"))
-                         .arg(suggestion.id)
-                         // Додаємо ціну до ToolTip, якщо це книга
-                         .arg(suggestion.type == SearchSuggestionInfo::Book ? QString("\nЦіна: %1 грн").arg(suggestion.price, 0, 'f', 2) : QString())
-                         );
-        // Видалено дубльовані рядки .arg(...)
+    m_dbManager->getSearchSuggestionsAsync(text, 10, cancelToken)
+        .then(this, [this, generation, text, cancelToken](const QList<SearchSuggestionInfo> &suggestions) {
+            if (m_suggestionCancelToken == cancelToken) {
+                m_suggestionCancelToken.reset();
+            }
+            if (generation != m_suggestionRequestId || cancelToken->isCancelled()) {
+                return; // Користувач уже ввів інший текст
+            }
+            showSearchSuggestions(text, suggestions);
+        });
+}
 
-        m_searchSuggestionModel->appendRow(item);
+// Зупиняє відкладений запит і скасовує на сервері той, що виконується
+void MainWindow::cancelDatabaseSuggestions()
+{
+    m_suggestionDebounceTimer->stop();
+    if (!m_suggestionCancelToken) {
+        return;
     }
+    // PQcancel відкриває окреме з'єднання з сервером - не в потоці GUI
+    std::shared_ptr<QueryCancelToken> cancelToken = std::move(m_suggestionCancelToken);
+    QThreadPool::globalInstance()->start([cancelToken]() { cancelToken->cancel(); });
+}
+
+void MainWindow::showSearchSuggestions(const QString &text, const QList<SearchSuggestionInfo> &suggestions)
+{
+    m_searchSuggestionModel->setSuggestions(suggestions);
 
     // Показуємо або ховаємо popup залежно від наявності пропозицій
     if (m_searchSuggestionModel->rowCount() > 0) {
@@ -149,3 +257,142 @@ void MainWindow::onSearchSuggestionActivated(const QModelIndex &index)
     // Опціонально: очистити поле пошуку після вибору
     // ui->globalSearchLineEdit->clear();
 }
+
+
+// Сторінка результатів повнотекстового пошуку (Enter у globalSearchLineEdit)
+void MainWindow::setupSearchResultsPage()
+{
+    connect(ui->globalSearchLineEdit, &QLineEdit::returnPressed, this, &MainWindow::onGlobalSearchSubmitted);
+    connect(ui->searchPrevPageButton, &QPushButton::clicked, this, [this]() {
+        runBookSearch(m_searchQuery, qMax(0, m_searchOffset - m_searchPageSize));
+    });
+    connect(ui->searchNextPageButton, &QPushButton::clicked, this, [this]() {
+        runBookSearch(m_searchQuery, m_searchOffset + m_searchPageSize);
+    });
+    ui->searchResultsTitleLabel->setTextFormat(Qt::PlainText);
+    ui->searchPrevPageButton->setEnabled(false);
+    ui->searchNextPageButton->setEnabled(false);
+}
+
+void MainWindow::onGlobalSearchSubmitted()
+{
+    const QString text = ui->globalSearchLineEdit->text().trimmed();
+    if (text.isEmpty()) {
+        return;
+    }
+    if (m_searchCompleter && m_searchCompleter->popup()) {
+        m_searchCompleter->popup()->hide();
+    }
+    runBookSearch(text, 0);
+}
+
+void MainWindow::runBookSearch(const QString &queryText, int offset)
+{
+    if (!m_dbManager || queryText.isEmpty()) {
+        return;
+    }
+
+    // Пошук виконується на робочому потоці; відповідь на застарілий запит відкидається
+    const int requestId = ++m_searchRequestId;
+    ui->statusBar->showMessage(tr("Пошук \"%1\"...").arg(queryText));
+    m_dbManager->searchBooksAsync(queryText, m_searchPageSize, offset).then(this, [this, requestId, queryText](const BookSearchPage &page) {
+        if (requestId != m_searchRequestId) {
+            return; // Є новіший запит
+        }
+        ui->statusBar->clearMessage();
+        m_searchQuery = queryText;
+        m_searchOffset = page.offset;
+        displaySearchResults(page);
+        ui->contentStackedWidget->setCurrentWidget(ui->searchResultsPage);
+    });
+}
+
+void MainWindow::displaySearchResults(const BookSearchPage &page)
+{
+    clearLayout(ui->searchResultsContainerLayout);
+
+    ui->searchResultsTitleLabel->setText(tr("Результати пошуку \"%1\": %2").arg(m_searchQuery).arg(page.totalCount));
+
+    if (page.results.isEmpty()) {
+        QLabel *emptyLabel = new QLabel(tr("Нічого не знайдено. Спробуйте інші слова або приберіть частину запиту."));
+        emptyLabel->setAlignment(Qt::AlignCenter);
+        emptyLabel->setWordWrap(true);
+        emptyLabel->setStyleSheet("QLabel { color: #6c757d; font-size: 11pt; padding: 20px; }");
+        ui->searchResultsContainerLayout->addWidget(emptyLabel);
+    } else {
+        for (const BookSearchResult &result : page.results) {
+            ui->searchResultsContainerLayout->addWidget(createSearchResultWidget(result));
+        }
+    }
+    ui->searchResultsContainerLayout->addStretch(1);
+
+    const int shownTo = page.offset + page.results.size();
+    ui->searchPageLabel->setText(page.results.isEmpty()
+                                     ? QString()
+                                     : tr("%1–%2 з %3").arg(page.offset + 1).arg(shownTo).arg(page.totalCount));
+    ui->searchPrevPageButton->setEnabled(page.offset > 0);
+    ui->searchNextPageButton->setEnabled(shownTo < page.totalCount);
+    ui->searchResultsScrollArea->verticalScrollBar()->setValue(0);
+}
+
+QWidget* MainWindow::createSearchResultWidget(const BookSearchResult &result)
+{
+    const BookDisplayInfo &bookInfo = result.book;
+
+    QFrame *resultFrame = new QFrame();
+    resultFrame->setFrameShape(QFrame::StyledPanel);
+    resultFrame->setStyleSheet("QFrame { background-color: white; border-radius: 8px; }");
+
+    QHBoxLayout *frameLayout = new QHBoxLayout(resultFrame);
+    frameLayout->setSpacing(12);
+    frameLayout->setContentsMargins(10, 10, 10, 10);
+
+    QLabel *coverLabel = new QLabel();
+    coverLabel->setFixedSize(70, 100);
+    coverLabel->setAlignment(Qt::AlignCenter);
+    coverLabel->setStyleSheet("QLabel { background-color: #e0e0e0; color: #555; border-radius: 4px; font-size: 8pt; }");
+    loadLabelImage(coverLabel, bookInfo.coverImagePath, {coverLabel->size()}, [this, coverLabel](const QPixmap &coverPixmap) {
+        if (coverPixmap.isNull()) {
+            coverLabel->setText(tr("Немає\nобкладинки"));
+        } else {
+            coverLabel->setPixmap(coverPixmap);
+            coverLabel->setStyleSheet("");
+        }
+    });
+    frameLayout->addWidget(coverLabel, 0, Qt::AlignTop);
+
+    QVBoxLayout *textLayout = new QVBoxLayout();
+    textLayout->setSpacing(4);
+
+    QLabel *titleLabel = new QLabel(headlineToHtml(result.titleHeadline.isEmpty() ? bookInfo.title : result.titleHeadline));
+    titleLabel->setTextFormat(Qt::RichText);
+    titleLabel->setWordWrap(true);
+    titleLabel->setStyleSheet("QLabel { font-size: 12pt; }");
+    textLayout->addWidget(titleLabel);
+
+    QLabel *authorLabel = new QLabel(bookInfo.authors.isEmpty() ? tr("Невідомий автор") : bookInfo.authors);
+    authorLabel->setTextFormat(Qt::PlainText);
+    authorLabel->setWordWrap(true);
+    authorLabel->setStyleSheet("QLabel { color: #555; font-size: 9pt; }");
+    textLayout->addWidget(authorLabel);
+
+    if (!result.snippet.trimmed().isEmpty()) {
+        QLabel *snippetLabel = new QLabel(headlineToHtml(result.snippet));
+        snippetLabel->setTextFormat(Qt::RichText);
+        snippetLabel->setWordWrap(true);
+        snippetLabel->setStyleSheet("QLabel { color: #343a40; font-size: 9pt; }");
+        textLayout->addWidget(snippetLabel);
+    }
+
+    QLabel *priceLabel = new QLabel(QString::number(bookInfo.price, 'f', 2) + tr(" грн"));
+    priceLabel->setStyleSheet("QLabel { font-weight: bold; color: #007bff; font-size: 10pt; }");
+    textLayout->addWidget(priceLabel);
+    textLayout->addStretch(1);
+    frameLayout->addLayout(textLayout, 1);
+
+    // Клік по картці відкриває деталі книги (MainWindow::eventFilter)
+    resultFrame->setProperty("bookId", bookInfo.bookId);
+    resultFrame->installEventFilter(this);
+    resultFrame->setCursor(Qt::PointingHandCursor);
+    return resultFrame;
+}
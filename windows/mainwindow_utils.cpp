@@ -8,6 +8,23 @@
 #include <QDebug>
 #include <QLabel> // Для QLabel у setupBannerImage
 
+// Зображення для label через ImageService: одразу, якщо мініатюра вже в кеші, інакше після
+// декодування у фоні (до того label показує placeholder, заданий викликом). onReady отримує
+// null pixmap, якщо файлу немає. Запізнілу відповідь для label, що вже показує інше зображення
+// (сторінки деталей перевикористовуються), відкидаємо.
+void MainWindow::loadLabelImage(QLabel *label, const QString &path, const ThumbnailSpec &spec,
+                                const std::function<void(const QPixmap &)> &onReady)
+{
+    const QString imageKey = QString("%1|%2x%3").arg(path).arg(spec.size.width()).arg(spec.size.height());
+    label->setProperty("imageKey", imageKey);
+    m_imageService->requestThumbnail(label, path, spec, [label, imageKey, onReady](const QPixmap &pixmap) {
+        if (label->property("imageKey").toString() != imageKey) {
+            return;
+        }
+        onReady(pixmap);
+    });
+}
+
 // Метод для очищення Layout
 void MainWindow::clearLayout(QLayout* layout) {
     if (!layout) return;